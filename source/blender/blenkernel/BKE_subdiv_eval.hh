@@ -8,11 +8,14 @@
 
 #pragma once
 
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_sys_types.h"
 
 struct Mesh;
 struct OpenSubdiv_EvaluatorCache;
 struct OpenSubdiv_EvaluatorSettings;
+struct OpenSubdiv_PatchCoord;
 
 namespace blender::bke::subdiv {
 
@@ -91,4 +94,21 @@ void eval_displacement(Subdiv *subdiv,
 /* Evaluate point on a limit surface with displacement applied to it. */
 void eval_final_point(Subdiv *subdiv, int ptex_face_index, float u, float v, float r_P[3]);
 
+/* Batched queries.
+ *
+ * These evaluate many coordinates with a single evaluator call, which avoids the per-point
+ * overhead of the single point queries above. The result matches calling the single point
+ * queries for every coordinate. */
+
+/* Evaluate points at a limit surface. */
+void eval_limit_points(Subdiv *subdiv,
+                       Span<OpenSubdiv_PatchCoord> patch_coords,
+                       MutableSpan<float3> r_P);
+
+/* Evaluate points and normals at a limit surface. */
+void eval_limit_points_and_normals(Subdiv *subdiv,
+                                   Span<OpenSubdiv_PatchCoord> patch_coords,
+                                   MutableSpan<float3> r_P,
+                                   MutableSpan<float3> r_N);
+
 }  // namespace blender::bke::subdiv
@@ -55,6 +55,8 @@ static void cache_file_init_data(ID *id)
   BLI_assert(MEMCMP_STRUCT_AFTER_IS_ZERO(cache_file, id));
 
   cache_file->scale = 1.0f;
+  cache_file->sample_cache_size = 0;
+  cache_file->prefetch_frames = 4;
   cache_file->velocity_unit = CACHEFILE_VELOCITY_UNIT_SECOND;
   STRNCPY(cache_file->velocity_name, ".velocities");
 }
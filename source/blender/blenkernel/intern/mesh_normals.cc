@@ -23,6 +23,7 @@
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_memarena.h"
+#include "BLI_sort.hh"
 #include "BLI_span.hh"
 #include "BLI_task.hh"
 #include "BLI_utildefines.h"
@@ -155,6 +156,30 @@ void normals_calc_faces(const Span<float3> positions,
   });
 }
 
+static float3 vert_normal_calc(const Span<float3> positions,
+                               const OffsetIndices<int> faces,
+                               const Span<int> corner_verts,
+                               const Span<int> vert_faces,
+                               const Span<float3> face_normals,
+                               const int vert)
+{
+  if (vert_faces.is_empty()) {
+    return math::normalize(positions[vert]);
+  }
+
+  float3 vert_normal(0);
+  for (const int face : vert_faces) {
+    const int2 adjacent_verts = face_find_adjacent_verts(faces[face], corner_verts, vert);
+    const float3 dir_prev = math::normalize(positions[adjacent_verts[0]] - positions[vert]);
+    const float3 dir_next = math::normalize(positions[adjacent_verts[1]] - positions[vert]);
+    const float factor = math::safe_acos_approx(math::dot(dir_prev, dir_next));
+
+    vert_normal += face_normals[face] * factor;
+  }
+
+  return math::normalize(vert_normal);
+}
+
 void normals_calc_verts(const Span<float3> vert_positions,
                         const OffsetIndices<int> faces,
                         const Span<int> corner_verts,
@@ -162,26 +187,10 @@ void normals_calc_verts(const Span<float3> vert_positions,
                         const Span<float3> face_normals,
                         MutableSpan<float3> vert_normals)
 {
-  const Span<float3> positions = vert_positions;
-  threading::parallel_for(positions.index_range(), 1024, [&](const IndexRange range) {
+  threading::parallel_for(vert_positions.index_range(), 1024, [&](const IndexRange range) {
     for (const int vert : range) {
-      const Span<int> vert_faces = vert_to_face_map[vert];
-      if (vert_faces.is_empty()) {
-        vert_normals[vert] = math::normalize(positions[vert]);
-        continue;
-      }
-
-      float3 vert_normal(0);
-      for (const int face : vert_faces) {
-        const int2 adjacent_verts = face_find_adjacent_verts(faces[face], corner_verts, vert);
-        const float3 dir_prev = math::normalize(positions[adjacent_verts[0]] - positions[vert]);
-        const float3 dir_next = math::normalize(positions[adjacent_verts[1]] - positions[vert]);
-        const float factor = math::safe_acos_approx(math::dot(dir_prev, dir_next));
-
-        vert_normal += face_normals[face] * factor;
-      }
-
-      vert_normals[vert] = math::normalize(vert_normal);
+      vert_normals[vert] = vert_normal_calc(
+          vert_positions, faces, corner_verts, vert_to_face_map[vert], face_normals, vert);
     }
   });
 }
@@ -310,6 +319,106 @@ blender::Span<blender::float3> Mesh::corner_normals() const
   return this->runtime->corner_normals_cache.data();
 }
 
+/**
+ * Gather the sorted and deduplicated indices of all elements referenced by the groups of the
+ * given indices.
+ */
+static blender::IndexMask gather_group_indices(const blender::GroupedSpan<int> groups,
+                                               const blender::IndexMask &indices,
+                                               blender::IndexMaskMemory &memory)
+{
+  using namespace blender;
+  Vector<int> result;
+  indices.foreach_index([&](const int i) { result.extend(groups[i]); });
+  parallel_sort(result.begin(), result.end());
+  result.resize(std::unique(result.begin(), result.end()) - result.begin());
+  return IndexMask::from_indices(result.as_span(), memory);
+}
+
+void Mesh::tag_positions_changed_partial(const blender::IndexMask &changed_verts)
+{
+  using namespace blender;
+  using namespace blender::bke;
+  if (changed_verts.is_empty()) {
+    return;
+  }
+  MeshRuntime &runtime = *this->runtime;
+  /* Partial updates have more overhead per element than recalculating everything, so only use
+   * them when a small part of the mesh was moved. Normals that aren't cached anyway are just
+   * tagged dirty and calculated lazily as usual. */
+  if (changed_verts.size() > this->verts_num / 8 || !runtime.face_normals_cache.is_cached()) {
+    this->tag_positions_changed();
+    return;
+  }
+
+  const Span<float3> positions = this->vert_positions();
+  const OffsetIndices faces = this->faces();
+  const Span<int> corner_verts = this->corner_verts();
+  const GroupedSpan<int> vert_to_face_map = this->vert_to_face_map();
+
+  /* Moving a vertex changes the normals of the faces using it. Those in turn change the normals
+   * of all of their vertices, not only the moved ones. */
+  IndexMaskMemory memory;
+  const IndexMask affected_faces = gather_group_indices(vert_to_face_map, changed_verts, memory);
+  const IndexMask affected_verts = IndexMask::from_union(
+      changed_verts,
+      gather_group_indices(GroupedSpan<int>(faces, corner_verts), affected_faces, memory),
+      memory);
+
+  runtime.face_normals_cache.update([&](Vector<float3> &r_data) {
+    affected_faces.foreach_index(GrainSize(1024), [&](const int face) {
+      r_data[face] = mesh::normal_calc_ngon(positions, corner_verts.slice(faces[face]));
+    });
+  });
+  const Span<float3> face_normals = runtime.face_normals_cache.data();
+
+  if (runtime.vert_normals_cache.is_cached()) {
+    runtime.vert_normals_cache.update([&](Vector<float3> &r_data) {
+      affected_verts.foreach_index(GrainSize(1024), [&](const int vert) {
+        r_data[vert] = mesh::vert_normal_calc(
+            positions, faces, corner_verts, vert_to_face_map[vert], face_normals, vert);
+      });
+    });
+  }
+  else {
+    runtime.vert_normals_cache.tag_dirty();
+  }
+
+  if (runtime.corner_normals_cache.is_cached()) {
+    switch (this->normals_domain()) {
+      case MeshNormalDomain::Point: {
+        const Span<float3> vert_normals = this->vert_normals();
+        const GroupedSpan<int> vert_to_corner_map = this->vert_to_corner_map();
+        runtime.corner_normals_cache.update([&](Vector<float3> &r_data) {
+          affected_verts.foreach_index(GrainSize(1024), [&](const int vert) {
+            r_data.as_mutable_span().fill_indices(vert_to_corner_map[vert], vert_normals[vert]);
+          });
+        });
+        break;
+      }
+      case MeshNormalDomain::Face: {
+        runtime.corner_normals_cache.update([&](Vector<float3> &r_data) {
+          affected_faces.foreach_index(GrainSize(1024), [&](const int face) {
+            r_data.as_mutable_span().slice(faces[face]).fill(face_normals[face]);
+          });
+        });
+        break;
+      }
+      case MeshNormalDomain::Corner: {
+        /* Corner normals depend on the smooth fans around each vertex, which are only built for
+         * the whole mesh currently. */
+        runtime.corner_normals_cache.tag_dirty();
+        break;
+      }
+    }
+  }
+  else {
+    runtime.corner_normals_cache.tag_dirty();
+  }
+
+  this->tag_positions_changed_no_normals();
+}
+
 void BKE_lnor_spacearr_init(MLoopNorSpaceArray *lnors_spacearr,
                             const int numLoops,
                             const char data_type)
@@ -0,0 +1,121 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
+
+namespace blender::bke::tests {
+
+class MeshNormalsTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/* A grid of quads with uneven heights, so that all normals differ. */
+static Mesh *create_grid_mesh(const int size)
+{
+  const int faces_num = (size - 1) * (size - 1);
+  Mesh *mesh = BKE_mesh_new_nomain(size * size, 0, faces_num, faces_num * 4);
+
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      positions[y * size + x] = float3(x, y, float((x * 7 + y * 3) % 5) * 0.25f);
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(size - 1)) {
+    for (const int x : IndexRange(size - 1)) {
+      const int face = y * (size - 1) + x;
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = y * size + x;
+      corner_verts[face * 4 + 1] = y * size + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * size + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * size + x;
+    }
+  }
+  face_offsets.last() = faces_num * 4;
+
+  mesh_calc_edges(*mesh, false, false);
+  return mesh;
+}
+
+/* Move a few vertices, update the cached normals partially and compare them with the normals
+ * calculated from scratch. */
+static void test_partial_update(Mesh *mesh)
+{
+  /* Calculate all normals, so that they are cached before the change. */
+  mesh->face_normals();
+  mesh->vert_normals();
+  mesh->corner_normals();
+
+  const Array<int> moved_verts = {0, 21, 22, 150, 399};
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int vert : moved_verts) {
+    positions[vert] += float3(0.1f, -0.3f, 0.7f);
+  }
+  IndexMaskMemory memory;
+  mesh->tag_positions_changed_partial(IndexMask::from_indices(moved_verts.as_span(), memory));
+
+  /* The partial update keeps the caches valid instead of tagging them dirty. */
+  EXPECT_TRUE(mesh->runtime->face_normals_cache.is_cached());
+  EXPECT_TRUE(mesh->runtime->vert_normals_cache.is_cached());
+  EXPECT_TRUE(mesh->runtime->corner_normals_cache.is_cached());
+
+  const Array<float3> face_normals(mesh->face_normals());
+  const Array<float3> vert_normals(mesh->vert_normals());
+  const Array<float3> corner_normals(mesh->corner_normals());
+
+  mesh->tag_positions_changed();
+  const Span<float3> expected_face_normals = mesh->face_normals();
+  const Span<float3> expected_vert_normals = mesh->vert_normals();
+  const Span<float3> expected_corner_normals = mesh->corner_normals();
+
+  for (const int i : face_normals.index_range()) {
+    EXPECT_V3_NEAR(face_normals[i], expected_face_normals[i], 1e-6f);
+  }
+  for (const int i : vert_normals.index_range()) {
+    EXPECT_V3_NEAR(vert_normals[i], expected_vert_normals[i], 1e-6f);
+  }
+  for (const int i : corner_normals.index_range()) {
+    EXPECT_V3_NEAR(corner_normals[i], expected_corner_normals[i], 1e-6f);
+  }
+}
+
+TEST_F(MeshNormalsTest, partial_update_point_domain)
+{
+  Mesh *mesh = create_grid_mesh(20);
+  EXPECT_EQ(mesh->normals_domain(), MeshNormalDomain::Point);
+  test_partial_update(mesh);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, partial_update_face_domain)
+{
+  Mesh *mesh = create_grid_mesh(20);
+  MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  SpanAttributeWriter<bool> sharp_faces = attributes.lookup_or_add_for_write_span<bool>(
+      "sharp_face", AttrDomain::Face);
+  sharp_faces.span.fill(true);
+  sharp_faces.finish();
+  EXPECT_EQ(mesh->normals_domain(), MeshNormalDomain::Face);
+  test_partial_update(mesh);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
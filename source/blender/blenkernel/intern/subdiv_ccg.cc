@@ -25,6 +25,7 @@
 #include "BKE_subdiv.hh"
 #include "BKE_subdiv_eval.hh"
 
+#include "opensubdiv_capi_type.hh"
 #include "opensubdiv_topology_refiner_capi.hh"
 
 using blender::Array;
@@ -263,6 +264,92 @@ static void subdiv_ccg_eval_special_grid(Subdiv &subdiv,
   }
 }
 
+/* Number of grid elements which are evaluated with a single call to the batched evaluator.
+ * Large enough to amortize the evaluator overhead, small enough to keep temporary buffers in
+ * cache. */
+static constexpr int64_t EVAL_BATCH_ELEMENTS_NUM = 4096;
+
+/* Append patch coordinates of all grid elements of the given face, in the same order as the
+ * elements are stored in the grids. */
+static void subdiv_ccg_face_patch_coords_append(const SubdivCCG &subdiv_ccg,
+                                                const Span<int> face_ptex_offset,
+                                                const int face_index,
+                                                Vector<OpenSubdiv_PatchCoord> &r_patch_coords)
+{
+  const int grid_size = subdiv_ccg.grid_size;
+  const float grid_size_1_inv = 1.0f / (grid_size - 1);
+  const IndexRange face = subdiv_ccg.faces[face_index];
+  const bool is_regular = face.size() == 4;
+  for (int corner = 0; corner < face.size(); corner++) {
+    const int ptex_face_index = face_ptex_offset[face_index] + (is_regular ? 0 : corner);
+    for (int y = 0; y < grid_size; y++) {
+      for (int x = 0; x < grid_size; x++) {
+        OpenSubdiv_PatchCoord coord;
+        coord.ptex_face = ptex_face_index;
+        if (is_regular) {
+          rotate_grid_to_quad(
+              corner, x * grid_size_1_inv, y * grid_size_1_inv, &coord.u, &coord.v);
+        }
+        else {
+          coord.u = 1.0f - (y * grid_size_1_inv);
+          coord.v = 1.0f - (x * grid_size_1_inv);
+        }
+        r_patch_coords.append(coord);
+      }
+    }
+  }
+}
+
+/* Evaluate limit surface of all grids of the given consecutive faces with batched evaluator
+ * calls. Grids of consecutive faces are stored consecutively, so the evaluated elements can be
+ * written out linearly. */
+static void subdiv_ccg_eval_grids_batched(Subdiv &subdiv,
+                                          SubdivCCG &subdiv_ccg,
+                                          const Span<int> face_ptex_offset,
+                                          SubdivCCGMaskEvaluator *mask_evaluator,
+                                          const IndexRange face_range)
+{
+  const int64_t grid_area = int64_t(subdiv_ccg.grid_size) * subdiv_ccg.grid_size;
+  const int64_t element_size = subdiv_ccg.grid_element_size;
+
+  Vector<OpenSubdiv_PatchCoord> patch_coords;
+  Vector<float3> positions;
+  Vector<float3> normals;
+
+  int64_t face_index = face_range.first();
+  while (face_index <= face_range.last()) {
+    /* Gather faces until the batch is full. */
+    const int first_grid_index = subdiv_ccg.faces[face_index].start();
+    patch_coords.clear();
+    while (face_index <= face_range.last() && patch_coords.size() < EVAL_BATCH_ELEMENTS_NUM) {
+      subdiv_ccg_face_patch_coords_append(subdiv_ccg, face_ptex_offset, face_index, patch_coords);
+      face_index++;
+    }
+
+    const int64_t batch_size = patch_coords.size();
+    positions.reinitialize(batch_size);
+    if (subdiv_ccg.has_normal) {
+      normals.reinitialize(batch_size);
+      eval_limit_points_and_normals(&subdiv, patch_coords, positions, normals);
+    }
+    else {
+      eval_limit_points(&subdiv, patch_coords, positions);
+    }
+
+    uchar *elements = &subdiv_ccg.grids_storage[first_grid_index * grid_area * element_size];
+    for (const int64_t i : patch_coords.index_range()) {
+      uchar *element = &elements[i * element_size];
+      copy_v3_v3((float *)element, positions[i]);
+      if (subdiv_ccg.has_normal) {
+        copy_v3_v3((float *)(element + subdiv_ccg.normal_offset), normals[i]);
+      }
+      const OpenSubdiv_PatchCoord &coord = patch_coords[i];
+      subdiv_ccg_eval_grid_element_mask(
+          subdiv_ccg, mask_evaluator, coord.ptex_face, coord.u, coord.v, element);
+    }
+  }
+}
+
 static bool subdiv_ccg_evaluate_grids(SubdivCCG &subdiv_ccg,
                                       Subdiv &subdiv,
                                       SubdivCCGMaskEvaluator *mask_evaluator)
@@ -271,6 +358,17 @@ static bool subdiv_ccg_evaluate_grids(SubdivCCG &subdiv_ccg,
   const OpenSubdiv_TopologyRefiner *topology_refiner = subdiv.topology_refiner;
   const int num_faces = topology_refiner->getNumFaces();
   const Span<int> face_ptex_offset(face_ptex_offset_get(&subdiv), subdiv_ccg.faces.size());
+  if (subdiv.displacement_evaluator == nullptr) {
+    /* Without displacement every element only needs limit surface evaluation, which can be done
+     * for many grids at once. Choose the grain size based on the amount of elements per face, so
+     * that high levels still give enough tasks for all threads. */
+    const int64_t grid_area = int64_t(subdiv_ccg.grid_size) * subdiv_ccg.grid_size;
+    const int64_t grain_size = std::max<int64_t>(1, EVAL_BATCH_ELEMENTS_NUM / (grid_area * 4));
+    threading::parallel_for(IndexRange(num_faces), grain_size, [&](const IndexRange range) {
+      subdiv_ccg_eval_grids_batched(subdiv, subdiv_ccg, face_ptex_offset, mask_evaluator, range);
+    });
+    return true;
+  }
   threading::parallel_for(IndexRange(num_faces), 1024, [&](const IndexRange range) {
     for (const int face_index : range) {
       if (subdiv_ccg.faces[face_index].size() == 4) {
@@ -285,9 +383,7 @@ static bool subdiv_ccg_evaluate_grids(SubdivCCG &subdiv_ccg,
   });
   /* If displacement is used, need to calculate normals after all final
    * coordinates are known. */
-  if (subdiv.displacement_evaluator != nullptr) {
-    BKE_subdiv_ccg_recalc_normals(subdiv_ccg);
-  }
+  BKE_subdiv_ccg_recalc_normals(subdiv_ccg);
   return true;
 }
 
@@ -312,86 +408,117 @@ static CCGElem *subdiv_ccg_coord_to_elem(const CCGKey &key,
   return CCG_grid_elem(&key, subdiv_ccg.grids[coord.grid_index], coord.x, coord.y);
 }
 
-/* Returns storage where boundary elements are to be stored. */
-static SubdivCCGCoord *subdiv_ccg_adjacent_edge_add_face(SubdivCCG &subdiv_ccg,
-                                                         SubdivCCGAdjacentEdge &adjacent_edge)
-{
-  const int grid_size = subdiv_ccg.grid_size * 2;
-  const int adjacent_face_index = adjacent_edge.num_adjacent_faces;
-  ++adjacent_edge.num_adjacent_faces;
-  /* Allocate memory for the boundary elements. */
-  adjacent_edge.boundary_coords = static_cast<SubdivCCGCoord **>(
-      MEM_reallocN(adjacent_edge.boundary_coords,
-                   adjacent_edge.num_adjacent_faces * sizeof(*adjacent_edge.boundary_coords)));
-  adjacent_edge.boundary_coords[adjacent_face_index] = static_cast<SubdivCCGCoord *>(
-      MEM_malloc_arrayN(grid_size * 2, sizeof(SubdivCCGCoord), "ccg adjacent boundary"));
-  return adjacent_edge.boundary_coords[adjacent_face_index];
-}
+/* Topology of the coarse faces gathered per grid, so that the adjacency can be filled in in
+ * parallel without querying the topology refiner from multiple threads. */
+struct GridNeighborhoodTopology {
+  /* Coarse vertex at the corner of the face the grid belongs to. */
+  Array<int> vert;
+  /* Coarse edge going from the grid's corner to the next corner of the face. */
+  Array<int> edge;
+  /* True when the coarse edge goes in the opposite direction of the face corners. */
+  Array<bool> edge_flipped;
+  /* Position of the grid's face in the list of faces adjacent to the edge and the vertex. */
+  Array<int> edge_slot;
+  Array<int> vert_slot;
+};
 
-static void subdiv_ccg_init_faces_edge_neighborhood(SubdivCCG &subdiv_ccg)
+static GridNeighborhoodTopology subdiv_ccg_gather_neighborhood_topology(SubdivCCG &subdiv_ccg)
 {
   Subdiv *subdiv = subdiv_ccg.subdiv;
   const OffsetIndices<int> faces = subdiv_ccg.faces;
   OpenSubdiv_TopologyRefiner *topology_refiner = subdiv->topology_refiner;
-  const int num_edges = topology_refiner->getNumEdges();
-  const int grid_size = subdiv_ccg.grid_size;
-  if (num_edges == 0) {
-    /* Early output, nothing to do in this case. */
-    return;
-  }
-  subdiv_ccg_allocate_adjacent_edges(subdiv_ccg, num_edges);
+  const int num_grids = subdiv_ccg.grids.size();
+
+  GridNeighborhoodTopology topology;
+  topology.vert.reinitialize(num_grids);
+  topology.edge.reinitialize(num_grids);
+  topology.edge_flipped.reinitialize(num_grids);
+  topology.edge_slot.reinitialize(num_grids);
+  topology.vert_slot.reinitialize(num_grids);
 
-  Vector<int, 64> face_vertices;
-  Vector<int, 64> face_edges;
-  /* Store adjacency for all faces. */
   for (const int face_index : faces.index_range()) {
     const IndexRange face = faces[face_index];
-    const int num_face_grids = face.size();
-    face_vertices.reinitialize(num_face_grids);
-    topology_refiner->getFaceVertices(face_index, face_vertices.data());
     /* Note that order of edges is same as order of MLoops, which also
      * means it's the same as order of grids. */
-    face_edges.reinitialize(num_face_grids);
-    topology_refiner->getFaceEdges(face_index, face_edges.data());
-    /* Store grids adjacency for this edge. */
-    for (int corner = 0; corner < num_face_grids; corner++) {
-      const int vertex_index = face_vertices[corner];
-      const int edge_index = face_edges[corner];
+    topology_refiner->getFaceVertices(face_index, &topology.vert[face.start()]);
+    topology_refiner->getFaceEdges(face_index, &topology.edge[face.start()]);
+    for (const int grid_index : face) {
       int edge_vertices[2];
-      topology_refiner->getEdgeVertices(edge_index, edge_vertices);
-      const bool is_edge_flipped = (edge_vertices[0] != vertex_index);
-      /* Grid which is adjacent to the current corner. */
-      const int current_grid_index = face.start() + corner;
-      /* Grid which is adjacent to the next corner. */
-      const int next_grid_index = face.start() + (corner + 1) % num_face_grids;
-      /* Add new face to the adjacent edge. */
-      SubdivCCGAdjacentEdge &adjacent_edge = subdiv_ccg.adjacent_edges[edge_index];
-      SubdivCCGCoord *boundary_coords = subdiv_ccg_adjacent_edge_add_face(subdiv_ccg,
-                                                                          adjacent_edge);
-      /* Fill CCG elements along the edge. */
-      int boundary_element_index = 0;
-      if (is_edge_flipped) {
-        for (int i = 0; i < grid_size; i++) {
-          boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
-              next_grid_index, grid_size - i - 1, grid_size - 1);
-        }
-        for (int i = 0; i < grid_size; i++) {
-          boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
-              current_grid_index, grid_size - 1, i);
+      topology_refiner->getEdgeVertices(topology.edge[grid_index], edge_vertices);
+      topology.edge_flipped[grid_index] = edge_vertices[0] != topology.vert[grid_index];
+    }
+  }
+
+  /* Assign slots in the order of faces, so that the adjacency (and the order in which values are
+   * averaged) does not depend on threading. */
+  for (const int grid_index : IndexRange(num_grids)) {
+    topology.edge_slot[grid_index] =
+        subdiv_ccg.adjacent_edges[topology.edge[grid_index]].num_adjacent_faces++;
+    topology.vert_slot[grid_index] =
+        subdiv_ccg.adjacent_verts[topology.vert[grid_index]].num_adjacent_faces++;
+  }
+  return topology;
+}
+
+static void subdiv_ccg_init_faces_edge_neighborhood(SubdivCCG &subdiv_ccg,
+                                                    const GridNeighborhoodTopology &topology)
+{
+  using namespace blender;
+  const OffsetIndices<int> faces = subdiv_ccg.faces;
+  const int grid_size = subdiv_ccg.grid_size;
+
+  threading::parallel_for(
+      subdiv_ccg.adjacent_edges.index_range(), 4096, [&](const IndexRange range) {
+        for (const int edge_index : range) {
+          SubdivCCGAdjacentEdge &adjacent_edge = subdiv_ccg.adjacent_edges[edge_index];
+          if (adjacent_edge.num_adjacent_faces == 0) {
+            continue;
+          }
+          adjacent_edge.boundary_coords = static_cast<SubdivCCGCoord **>(
+              MEM_calloc_arrayN(adjacent_edge.num_adjacent_faces,
+                                sizeof(*adjacent_edge.boundary_coords),
+                                "ccg adjacent boundaries"));
         }
-      }
-      else {
-        for (int i = 0; i < grid_size; i++) {
-          boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
-              current_grid_index, grid_size - 1, grid_size - i - 1);
+      });
+
+  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+    for (const int face_index : range) {
+      const IndexRange face = faces[face_index];
+      for (const int corner : IndexRange(face.size())) {
+        /* Grid which is adjacent to the current corner. */
+        const int current_grid_index = face.start() + corner;
+        /* Grid which is adjacent to the next corner. */
+        const int next_grid_index = face.start() + (corner + 1) % face.size();
+        SubdivCCGAdjacentEdge &adjacent_edge =
+            subdiv_ccg.adjacent_edges[topology.edge[current_grid_index]];
+        SubdivCCGCoord *boundary_coords = static_cast<SubdivCCGCoord *>(
+            MEM_malloc_arrayN(grid_size * 2, sizeof(SubdivCCGCoord), "ccg adjacent boundary"));
+        adjacent_edge.boundary_coords[topology.edge_slot[current_grid_index]] = boundary_coords;
+        /* Fill CCG elements along the edge. */
+        int boundary_element_index = 0;
+        if (topology.edge_flipped[current_grid_index]) {
+          for (int i = 0; i < grid_size; i++) {
+            boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
+                next_grid_index, grid_size - i - 1, grid_size - 1);
+          }
+          for (int i = 0; i < grid_size; i++) {
+            boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
+                current_grid_index, grid_size - 1, i);
+          }
         }
-        for (int i = 0; i < grid_size; i++) {
-          boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
-              next_grid_index, i, grid_size - 1);
+        else {
+          for (int i = 0; i < grid_size; i++) {
+            boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
+                current_grid_index, grid_size - 1, grid_size - i - 1);
+          }
+          for (int i = 0; i < grid_size; i++) {
+            boundary_coords[boundary_element_index++] = subdiv_ccg_coord(
+                next_grid_index, i, grid_size - 1);
+          }
         }
       }
     }
-  }
+  });
 }
 
 static void subdiv_ccg_allocate_adjacent_vertices(SubdivCCG &subdiv_ccg, const int num_vertices)
@@ -400,55 +527,50 @@ static void subdiv_ccg_allocate_adjacent_vertices(SubdivCCG &subdiv_ccg, const i
                                                              SubdivCCGAdjacentVertex{});
 }
 
-/* Returns storage where corner elements are to be stored. This is a pointer
- * to the actual storage. */
-static SubdivCCGCoord *subdiv_ccg_adjacent_vertex_add_face(
-    SubdivCCGAdjacentVertex &adjacent_vertex)
-{
-  const int adjacent_face_index = adjacent_vertex.num_adjacent_faces;
-  ++adjacent_vertex.num_adjacent_faces;
-  /* Allocate memory for the boundary elements. */
-  adjacent_vertex.corner_coords = static_cast<SubdivCCGCoord *>(
-      MEM_reallocN(adjacent_vertex.corner_coords,
-                   adjacent_vertex.num_adjacent_faces * sizeof(*adjacent_vertex.corner_coords)));
-  return &adjacent_vertex.corner_coords[adjacent_face_index];
-}
-
-static void subdiv_ccg_init_faces_vertex_neighborhood(SubdivCCG &subdiv_ccg)
+static void subdiv_ccg_init_faces_vertex_neighborhood(SubdivCCG &subdiv_ccg,
+                                                      const GridNeighborhoodTopology &topology)
 {
-  Subdiv *subdiv = subdiv_ccg.subdiv;
-  const OffsetIndices<int> faces = subdiv_ccg.faces;
-  OpenSubdiv_TopologyRefiner *topology_refiner = subdiv->topology_refiner;
-  const int num_vertices = topology_refiner->getNumVertices();
+  using namespace blender;
   const int grid_size = subdiv_ccg.grid_size;
-  if (num_vertices == 0) {
-    /* Early output, nothing to do in this case. */
-    return;
-  }
-  subdiv_ccg_allocate_adjacent_vertices(subdiv_ccg, num_vertices);
-  Vector<int, 64> face_vertices;
-  /* Store adjacency for all faces. */
-  for (const int face_index : faces.index_range()) {
-    const IndexRange face = faces[face_index];
-    const int num_face_grids = face.size();
-    face_vertices.reinitialize(num_face_grids);
-    topology_refiner->getFaceVertices(face_index, face_vertices.data());
-    for (int corner = 0; corner < num_face_grids; corner++) {
-      const int vertex_index = face_vertices[corner];
-      /* Grid which is adjacent to the current corner. */
-      const int grid_index = face.start() + corner;
-      /* Add new face to the adjacent edge. */
-      SubdivCCGAdjacentVertex &adjacent_vertex = subdiv_ccg.adjacent_verts[vertex_index];
-      SubdivCCGCoord *corner_coord = subdiv_ccg_adjacent_vertex_add_face(adjacent_vertex);
-      *corner_coord = subdiv_ccg_coord(grid_index, grid_size - 1, grid_size - 1);
+
+  threading::parallel_for(
+      subdiv_ccg.adjacent_verts.index_range(), 4096, [&](const IndexRange range) {
+        for (const int vert_index : range) {
+          SubdivCCGAdjacentVertex &adjacent_vertex = subdiv_ccg.adjacent_verts[vert_index];
+          if (adjacent_vertex.num_adjacent_faces == 0) {
+            continue;
+          }
+          adjacent_vertex.corner_coords = static_cast<SubdivCCGCoord *>(
+              MEM_malloc_arrayN(adjacent_vertex.num_adjacent_faces,
+                                sizeof(*adjacent_vertex.corner_coords),
+                                "ccg adjacent corners"));
+        }
+      });
+
+  threading::parallel_for(subdiv_ccg.grids.index_range(), 4096, [&](const IndexRange range) {
+    for (const int grid_index : range) {
+      SubdivCCGAdjacentVertex &adjacent_vertex =
+          subdiv_ccg.adjacent_verts[topology.vert[grid_index]];
+      adjacent_vertex.corner_coords[topology.vert_slot[grid_index]] = subdiv_ccg_coord(
+          grid_index, grid_size - 1, grid_size - 1);
     }
-  }
+  });
 }
 
 static void subdiv_ccg_init_faces_neighborhood(SubdivCCG &subdiv_ccg)
 {
-  subdiv_ccg_init_faces_edge_neighborhood(subdiv_ccg);
-  subdiv_ccg_init_faces_vertex_neighborhood(subdiv_ccg);
+  const OpenSubdiv_TopologyRefiner *topology_refiner = subdiv_ccg.subdiv->topology_refiner;
+  subdiv_ccg_allocate_adjacent_edges(subdiv_ccg, topology_refiner->getNumEdges());
+  subdiv_ccg_allocate_adjacent_vertices(subdiv_ccg, topology_refiner->getNumVertices());
+  if (subdiv_ccg.grids.is_empty()) {
+    /* Early output, nothing to do in this case. */
+    return;
+  }
+  /* Count adjacent faces first, so that all the adjacency storage can be allocated up-front and
+   * filled in parallel. */
+  const GridNeighborhoodTopology topology = subdiv_ccg_gather_neighborhood_topology(subdiv_ccg);
+  subdiv_ccg_init_faces_edge_neighborhood(subdiv_ccg, topology);
+  subdiv_ccg_init_faces_vertex_neighborhood(subdiv_ccg, topology);
 }
 
 #endif
@@ -918,17 +1040,9 @@ static void subdiv_ccg_average_corners(SubdivCCG &subdiv_ccg,
 
 void BKE_subdiv_ccg_average_grids(SubdivCCG &subdiv_ccg)
 {
-#ifdef WITH_OPENSUBDIV
-  using namespace blender;
-  const CCGKey key = BKE_subdiv_ccg_key_top_level(subdiv_ccg);
   /* Average inner boundaries of grids (within one face), across faces
-   * from different face-corners. */
+   * from different face-corners, then boundaries and corners between faces. */
   BKE_subdiv_ccg_average_stitch_faces(subdiv_ccg, subdiv_ccg.faces.index_range());
-  subdiv_ccg_average_boundaries(subdiv_ccg, key, subdiv_ccg.adjacent_edges.index_range());
-  subdiv_ccg_average_corners(subdiv_ccg, key, subdiv_ccg.adjacent_verts.index_range());
-#else
-  UNUSED_VARS(subdiv_ccg);
-#endif
 }
 
 #ifdef WITH_OPENSUBDIV
@@ -988,10 +1102,14 @@ void BKE_subdiv_ccg_average_stitch_faces(SubdivCCG &subdiv_ccg, const IndexMask
   face_mask.foreach_index(GrainSize(512), [&](const int face_index) {
     subdiv_ccg_average_inner_face_grids(subdiv_ccg, key, subdiv_ccg.faces[face_index]);
   });
-  /* TODO(sergey): Only average elements which are adjacent to modified
-   * faces. */
-  subdiv_ccg_average_boundaries(subdiv_ccg, key, subdiv_ccg.adjacent_edges.index_range());
-  subdiv_ccg_average_corners(subdiv_ccg, key, subdiv_ccg.adjacent_verts.index_range());
+  if (face_mask.size() == subdiv_ccg.faces.size()) {
+    subdiv_ccg_average_boundaries(subdiv_ccg, key, subdiv_ccg.adjacent_edges.index_range());
+    subdiv_ccg_average_corners(subdiv_ccg, key, subdiv_ccg.adjacent_verts.index_range());
+  }
+  else {
+    /* Only average elements which are adjacent to modified faces. */
+    subdiv_ccg_average_faces_boundaries_and_corners(subdiv_ccg, key, face_mask);
+  }
 #else
   UNUSED_VARS(subdiv_ccg, face_mask);
 #endif
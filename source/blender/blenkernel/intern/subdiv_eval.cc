@@ -8,7 +8,9 @@
 
 #include "BKE_subdiv_eval.hh"
 
+#include "BLI_array.hh"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
@@ -18,6 +20,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.hh"
 #include "opensubdiv_evaluator_capi.hh"
 #include "opensubdiv_topology_refiner_capi.hh"
 
@@ -379,4 +382,53 @@ void eval_final_point(
   }
 }
 
+/* --------------------------------------------------------------------
+ * Batched queries.
+ */
+
+void eval_limit_points(Subdiv *subdiv,
+                       const Span<OpenSubdiv_PatchCoord> patch_coords,
+                       MutableSpan<float3> r_P)
+{
+  BLI_assert(patch_coords.size() == r_P.size());
+  if (patch_coords.is_empty()) {
+    return;
+  }
+  subdiv->evaluator->evaluatePatchesLimit(subdiv->evaluator,
+                                          patch_coords.data(),
+                                          patch_coords.size(),
+                                          reinterpret_cast<float *>(r_P.data()),
+                                          nullptr,
+                                          nullptr);
+}
+
+void eval_limit_points_and_normals(Subdiv *subdiv,
+                                   const Span<OpenSubdiv_PatchCoord> patch_coords,
+                                   MutableSpan<float3> r_P,
+                                   MutableSpan<float3> r_N)
+{
+  BLI_assert(patch_coords.size() == r_P.size());
+  BLI_assert(patch_coords.size() == r_N.size());
+  if (patch_coords.is_empty()) {
+    return;
+  }
+  Array<float3> dPdu(patch_coords.size());
+  Array<float3> dPdv(patch_coords.size());
+  subdiv->evaluator->evaluatePatchesLimit(subdiv->evaluator,
+                                          patch_coords.data(),
+                                          patch_coords.size(),
+                                          reinterpret_cast<float *>(r_P.data()),
+                                          reinterpret_cast<float *>(dPdu.data()),
+                                          reinterpret_cast<float *>(dPdv.data()));
+  for (const int i : patch_coords.index_range()) {
+    /* Same fallback for degenerate derivatives as in #eval_limit_point_and_derivatives. */
+    if (math::is_zero(dPdu[i]) || math::is_zero(dPdv[i]) || dPdu[i] == dPdv[i]) {
+      const OpenSubdiv_PatchCoord &coord = patch_coords[i];
+      eval_limit_point_and_derivatives(
+          subdiv, coord.ptex_face, coord.u, coord.v, r_P[i], dPdu[i], dPdv[i]);
+    }
+    r_N[i] = math::normalize(math::cross(dPdu[i], dPdv[i]));
+  }
+}
+
 }  // namespace blender::bke::subdiv
@@ -16,6 +16,7 @@
 
 #include "DNA_anim_types.h"
 #include "DNA_brush_types.h"
+#include "DNA_cachefile_types.h"
 #include "DNA_camera_types.h"
 #include "DNA_curve_types.h"
 #include "DNA_defaults.h"
@@ -3625,6 +3626,14 @@ void blo_do_versions_400(FileData *fd, Library * /*lib*/, Main *bmain)
     }
   }
 
+  if (!MAIN_VERSION_FILE_ATLEAST(bmain, 402, 40)) {
+    const CacheFile *default_cache_file = DNA_struct_default_get(CacheFile);
+    LISTBASE_FOREACH (CacheFile *, cache_file, &bmain->cachefiles) {
+      cache_file->sample_cache_size = default_cache_file->sample_cache_size;
+      cache_file->prefetch_frames = default_cache_file->prefetch_frames;
+    }
+  }
+
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a MAIN_VERSION_FILE_ATLEAST check.
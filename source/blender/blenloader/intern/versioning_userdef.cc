@@ -954,6 +954,11 @@ void blo_do_versions_userdef(UserDef *userdef)
     BKE_preferences_extension_repo_add_default_user(userdef);
   }
 
+  if (!USER_VERSION_ATLEAST(402, 41)) {
+    /* Was padding before, which is zero, while at least one frame is prefetched. */
+    userdef->sequencer_prefetch_frames = 1;
+  }
+
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a USER_VERSION_ATLEAST check.
@@ -193,12 +193,15 @@ static Vector<MeshToBMeshLayerInfo> mesh_to_bm_copy_info_calc(const CustomData &
   return infos;
 }
 
-static void mesh_attributes_copy_to_bmesh_block(CustomData &data,
-                                                const Span<MeshToBMeshLayerInfo> copy_info,
+/**
+ * Copy the mesh attribute values to an element's block, which must already be allocated with
+ * #CustomData_bmesh_alloc_block. Separating the two makes it possible to copy in parallel, since
+ * allocating from the memory pool isn't thread-safe.
+ */
+static void mesh_attributes_copy_to_bmesh_block(const Span<MeshToBMeshLayerInfo> copy_info,
                                                 const int mesh_index,
                                                 BMHeader &header)
 {
-  CustomData_bmesh_alloc_block(&data, &header.data);
   for (const MeshToBMeshLayerInfo &info : copy_info) {
     if (info.mesh_data) {
       CustomData_data_copy_value(info.type,
@@ -428,6 +431,10 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
   const VArraySpan sharp_edges = *attributes.lookup<bool>("sharp_edge", AttrDomain::Edge);
   const VArraySpan uv_seams = *attributes.lookup<bool>(".uv_seam", AttrDomain::Edge);
 
+  /* Elements and their custom data blocks are allocated from memory pools, which has to be done
+   * on a single thread. Copying the attribute values and computing normals afterwards is done in
+   * parallel, using the element tables. */
+
   const Span<float3> positions = mesh->vert_positions();
   Array<BMVert *> vtable(mesh->verts_num);
   for (const int i : positions.index_range()) {
@@ -442,28 +449,34 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
       BM_vert_select_set(bm, v, true);
     }
 
-    if (!vert_normals.is_empty()) {
-      copy_v3_v3(v->no, vert_normals[i]);
-    }
+    CustomData_bmesh_alloc_block(&bm->vdata, &v->head.data);
+  }
+  if (is_new) {
+    bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
+  }
+  threading::parallel_for(vtable.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMVert *v = vtable[i];
+      if (!vert_normals.is_empty()) {
+        copy_v3_v3(v->no, vert_normals[i]);
+      }
 
-    mesh_attributes_copy_to_bmesh_block(bm->vdata, vert_info, i, v->head);
+      mesh_attributes_copy_to_bmesh_block(vert_info, i, v->head);
 
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
+      /* Set shape key original index. */
+      if (cd_shape_keyindex_offset != -1) {
+        BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
+      }
 
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
+      /* Set shape-key data. */
+      if (tot_shape_keys) {
+        float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
+        for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
+          copy_v3_v3(*co_dst, shape_key_table[j][i]);
+        }
       }
     }
-  }
-  if (is_new) {
-    bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
-  }
+  });
 
   const Span<blender::int2> edges = mesh->edges();
   Array<BMEdge *> etable(mesh->edges_num);
@@ -486,31 +499,30 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
       BM_elem_flag_enable(e, BM_ELEM_SMOOTH);
     }
 
-    mesh_attributes_copy_to_bmesh_block(bm->edata, edge_info, i, e->head);
+    CustomData_bmesh_alloc_block(&bm->edata, &e->head.data);
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
   }
+  threading::parallel_for(etable.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      mesh_attributes_copy_to_bmesh_block(edge_info, i, etable[i]->head);
+    }
+  });
 
   const blender::OffsetIndices faces = mesh->faces();
   const Span<int> corner_verts = mesh->corner_verts();
   const Span<int> corner_edges = mesh->corner_edges();
 
-  /* Only needed for selection. */
-
-  Array<BMFace *> ftable;
-  if (mesh->mselect && mesh->totselect != 0) {
-    ftable.reinitialize(mesh->faces_num);
-  }
+  /* Faces that couldn't be created are null. */
+  Array<BMFace *> ftable(mesh->faces_num);
 
   int totloops = 0;
   for (const int i : faces.index_range()) {
     const IndexRange face = faces[i];
     BMFace *f = bm_face_create_from_mpoly(
         *bm, corner_verts.slice(face), corner_edges.slice(face), vtable, etable);
-    if (!ftable.is_empty()) {
-      ftable[i] = f;
-    }
+    ftable[i] = f;
 
     if (UNLIKELY(f == nullptr)) {
       printf(
@@ -541,26 +553,41 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
       bm->act_face = f;
     }
 
-    int j = face.start();
     BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
     BMLoop *l_iter = l_first;
     do {
-      /* Don't use 'j' since we may have skipped some faces, hence some loops. */
+      /* Don't use the corner index since we may have skipped some faces, hence some loops. */
       BM_elem_index_set(l_iter, totloops++); /* set_ok */
 
-      mesh_attributes_copy_to_bmesh_block(bm->ldata, loop_info, j, l_iter->head);
-      j++;
+      CustomData_bmesh_alloc_block(&bm->ldata, &l_iter->head.data);
     } while ((l_iter = l_iter->next) != l_first);
 
-    mesh_attributes_copy_to_bmesh_block(bm->pdata, poly_info, i, f->head);
-
-    if (params->calc_face_normal) {
-      BM_face_normal_update(f);
-    }
+    CustomData_bmesh_alloc_block(&bm->pdata, &f->head.data);
   }
   if (is_new) {
     bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
   }
+  threading::parallel_for(ftable.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMFace *f = ftable[i];
+      if (f == nullptr) {
+        continue;
+      }
+      int j = faces[i].start();
+      BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
+      BMLoop *l_iter = l_first;
+      do {
+        mesh_attributes_copy_to_bmesh_block(loop_info, j, l_iter->head);
+        j++;
+      } while ((l_iter = l_iter->next) != l_first);
+
+      mesh_attributes_copy_to_bmesh_block(poly_info, i, f->head);
+
+      if (params->calc_face_normal) {
+        BM_face_normal_update(f);
+      }
+    }
+  });
 
   /* -------------------------------------------------------------------- */
   /* MSelect clears the array elements (to avoid adding multiple times).
@@ -1251,6 +1278,72 @@ static void bmesh_block_copy_to_mesh_attributes(const Span<BMeshToMeshLayerInfo>
   }
 }
 
+/**
+ * Share the mesh layers from before the conversion instead of copying the BMesh data when the
+ * BMesh values are unchanged, which is the case for all attributes that weren't edited. Besides
+ * avoiding the copy, this keeps the memory shared with undo steps and other users of the data.
+ * The BMesh layers are tagged to not be copied, their indices are added to \a r_bm_layers_reused.
+ */
+template<typename T>
+static void bm_to_mesh_share_unchanged_layers(CustomData &bm_data,
+                                              const Span<const T *> bm_elems,
+                                              const CustomData &old_mesh_data,
+                                              const int old_elems_num,
+                                              CustomData &mesh_data,
+                                              Vector<int> &r_bm_layers_reused)
+{
+  if (bm_elems.is_empty() || bm_elems.size() != old_elems_num) {
+    return;
+  }
+  for (CustomDataLayer &mesh_layer : MutableSpan(mesh_data.layers, mesh_data.totlayer)) {
+    const eCustomDataType type = eCustomDataType(mesh_layer.type);
+    if (!(CD_TYPE_AS_MASK(type) & CD_MASK_PROP_ALL) || mesh_layer.sharing_info == nullptr) {
+      continue;
+    }
+    const int old_layer_index = CustomData_get_named_layer_index(
+        &old_mesh_data, type, mesh_layer.name);
+    const int bm_layer_index = CustomData_get_named_layer_index(&bm_data, type, mesh_layer.name);
+    if (old_layer_index == -1 || bm_layer_index == -1) {
+      continue;
+    }
+    const CustomDataLayer &old_layer = old_mesh_data.layers[old_layer_index];
+    CustomDataLayer &bm_layer = bm_data.layers[bm_layer_index];
+    if (old_layer.sharing_info == nullptr || bm_layer.flag & CD_FLAG_NOCOPY) {
+      continue;
+    }
+
+    const int bm_offset = bm_layer.offset;
+    const size_t elem_size = CustomData_get_elem_size(&mesh_layer);
+    std::atomic<bool> changed = false;
+    threading::parallel_for(bm_elems.index_range(), 4096, [&](const IndexRange range) {
+      if (changed.load(std::memory_order_relaxed)) {
+        return;
+      }
+      for (const int i : range) {
+        if (memcmp(POINTER_OFFSET(bm_elems[i]->head.data, bm_offset),
+                   POINTER_OFFSET(old_layer.data, elem_size * i),
+                   elem_size) != 0)
+        {
+          changed.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    });
+    if (changed) {
+      continue;
+    }
+
+    /* The layer was just allocated by #CustomData_copy_layout, so this frees it. */
+    mesh_layer.sharing_info->remove_user_and_delete_if_last();
+    mesh_layer.data = old_layer.data;
+    mesh_layer.sharing_info = old_layer.sharing_info;
+    mesh_layer.sharing_info->add_user();
+
+    bm_layer.flag |= CD_FLAG_NOCOPY;
+    r_bm_layers_reused.append(bm_layer_index);
+  }
+}
+
 static void bm_to_mesh_verts(const BMesh &bm,
                              const Span<const BMVert *> bm_verts,
                              Mesh &mesh,
@@ -1412,6 +1505,19 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
 {
   using namespace blender;
   const int old_verts_num = mesh->verts_num;
+  const int old_edges_num = mesh->edges_num;
+  const int old_faces_num = mesh->faces_num;
+  const int old_corners_num = mesh->corners_num;
+
+  /* Keep references to the existing attributes, to share the ones that weren't changed. */
+  CustomData old_vert_data;
+  CustomData old_edge_data;
+  CustomData old_face_data;
+  CustomData old_corner_data;
+  CustomData_copy(&mesh->vert_data, &old_vert_data, CD_MASK_PROP_ALL, old_verts_num);
+  CustomData_copy(&mesh->edge_data, &old_edge_data, CD_MASK_PROP_ALL, old_edges_num);
+  CustomData_copy(&mesh->face_data, &old_face_data, CD_MASK_PROP_ALL, old_faces_num);
+  CustomData_copy(&mesh->corner_data, &old_corner_data, CD_MASK_PROP_ALL, old_corners_num);
 
   BKE_mesh_clear_geometry(mesh);
 
@@ -1478,6 +1584,49 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
         &bm->pdata, &mesh->face_data, mask.pmask, CD_CONSTRUCT, mesh->faces_num);
   }
 
+  Vector<int> vert_layers_reused;
+  Vector<int> edge_layers_reused;
+  Vector<int> face_layers_reused;
+  Vector<int> loop_layers_reused;
+  threading::parallel_invoke(
+      (mesh->faces_num + mesh->edges_num) > 1024,
+      [&]() {
+        bm_to_mesh_share_unchanged_layers(bm->vdata,
+                                          vert_table.as_span(),
+                                          old_vert_data,
+                                          old_verts_num,
+                                          mesh->vert_data,
+                                          vert_layers_reused);
+        CustomData_free(&old_vert_data, old_verts_num);
+      },
+      [&]() {
+        bm_to_mesh_share_unchanged_layers(bm->edata,
+                                          edge_table.as_span(),
+                                          old_edge_data,
+                                          old_edges_num,
+                                          mesh->edge_data,
+                                          edge_layers_reused);
+        CustomData_free(&old_edge_data, old_edges_num);
+      },
+      [&]() {
+        bm_to_mesh_share_unchanged_layers(bm->pdata,
+                                          face_table.as_span(),
+                                          old_face_data,
+                                          old_faces_num,
+                                          mesh->face_data,
+                                          face_layers_reused);
+        CustomData_free(&old_face_data, old_faces_num);
+      },
+      [&]() {
+        bm_to_mesh_share_unchanged_layers(bm->ldata,
+                                          loop_table.as_span(),
+                                          old_corner_data,
+                                          old_corners_num,
+                                          mesh->corner_data,
+                                          loop_layers_reused);
+        CustomData_free(&old_corner_data, old_corners_num);
+      });
+
   /* Add optional mesh attributes before parallel iteration. */
   assert_bmesh_has_no_mesh_only_attributes(*bm);
   bke::MutableAttributeAccessor attrs = mesh->attributes_for_write();
@@ -1610,6 +1759,19 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
         }
       });
 
+  for (const int i : vert_layers_reused) {
+    bm->vdata.layers[i].flag &= ~CD_FLAG_NOCOPY;
+  }
+  for (const int i : edge_layers_reused) {
+    bm->edata.layers[i].flag &= ~CD_FLAG_NOCOPY;
+  }
+  for (const int i : face_layers_reused) {
+    bm->pdata.layers[i].flag &= ~CD_FLAG_NOCOPY;
+  }
+  for (const int i : loop_layers_reused) {
+    bm->ldata.layers[i].flag &= ~CD_FLAG_NOCOPY;
+  }
+
   select_vert.finish();
   hide_vert.finish();
   select_edge.finish();
@@ -6989,6 +6989,19 @@ void uiTemplateCacheFileTimeSettings(uiLayout *layout, PointerRNA *fileptr)
   row = uiLayoutRow(layout, false);
   uiItemR(row, fileptr, "frame_offset", UI_ITEM_NONE, nullptr, ICON_NONE);
   uiLayoutSetActive(row, !RNA_boolean_get(fileptr, "is_sequence"));
+
+  /* The sample cache is only used when streaming Alembic data during playback. */
+  const CacheFile *cache_file = static_cast<const CacheFile *>(fileptr->data);
+  const bool is_alembic = BLI_path_extension_check_glob(cache_file->filepath, "*abc");
+  const bool use_sample_cache = RNA_int_get(fileptr, "sample_cache_size") > 0;
+
+  row = uiLayoutRow(layout, false);
+  uiLayoutSetActive(row, is_alembic);
+  uiItemR(row, fileptr, "sample_cache_size", UI_ITEM_NONE, nullptr, ICON_NONE);
+
+  sub = uiLayoutRow(layout, false);
+  uiLayoutSetActive(sub, is_alembic && use_sample_cache);
+  uiItemR(sub, fileptr, "prefetch_frames", UI_ITEM_NONE, nullptr, ICON_NONE);
 }
 
 static void cache_file_layer_item(uiList * /*ui_list*/,
@@ -220,7 +220,8 @@ static bool wm_obj_export_check(bContext *C, wmOperator *op)
   bool changed = false;
   RNA_string_get(op->ptr, "filepath", filepath);
 
-  if (!BLI_path_extension_check(filepath, ".obj")) {
+  /* Compressed files are written when the extension is `.obj.gz` or `.obj.zst`. */
+  if (!BLI_path_extension_check_n(filepath, ".obj", ".obj.gz", ".obj.zst", nullptr)) {
     BLI_path_extension_ensure(filepath, FILE_MAX, ".obj");
     RNA_string_set(op->ptr, "filepath", filepath);
     changed = true;
@@ -393,8 +394,9 @@ void WM_OT_obj_export(wmOperatorType *ot)
   RNA_def_boolean(
       ot->srna, "smooth_group_bitflags", false, "Generate Bitflags for Smooth Groups", "");
 
-  /* Only show `.obj` or `.mtl` files by default. */
-  prop = RNA_def_string(ot->srna, "filter_glob", "*.obj;*.mtl", 0, "Extension Filter", "");
+  /* Only show `.obj` or `.mtl` files by default, including compressed `.obj` files. */
+  prop = RNA_def_string(
+      ot->srna, "filter_glob", "*.obj;*.obj.gz;*.obj.zst;*.mtl", 0, "Extension Filter", "");
   RNA_def_property_flag(prop, PROP_HIDDEN);
 
   prop = RNA_def_string(ot->srna, "collection", nullptr, MAX_IDPROP_NAME, "Collection", nullptr);
@@ -548,8 +550,9 @@ void WM_OT_obj_import(wmOperatorType *ot)
                  "Path Separator",
                  "Character used to separate objects name into hierarchical structure");
 
-  /* Only show `.obj` or `.mtl` files by default. */
-  prop = RNA_def_string(ot->srna, "filter_glob", "*.obj;*.mtl", 0, "Extension Filter", "");
+  /* Only show `.obj` or `.mtl` files by default, including compressed `.obj` files. */
+  prop = RNA_def_string(
+      ot->srna, "filter_glob", "*.obj;*.obj.gz;*.obj.zst;*.mtl", 0, "Extension Filter", "");
   RNA_def_property_flag(prop, PROP_HIDDEN);
 }
 
@@ -146,7 +146,8 @@ static bool wm_ply_export_check(bContext * /*C*/, wmOperator *op)
   bool changed = false;
   RNA_string_get(op->ptr, "filepath", filepath);
 
-  if (!BLI_path_extension_check(filepath, ".ply")) {
+  /* Compressed files are written when the extension is `.ply.gz` or `.ply.zst`. */
+  if (!BLI_path_extension_check_n(filepath, ".ply", ".ply.gz", ".ply.zst", nullptr)) {
     BLI_path_extension_ensure(filepath, FILE_MAX, ".ply");
     RNA_string_set(op->ptr, "filepath", filepath);
     changed = true;
@@ -240,8 +241,9 @@ void WM_OT_ply_export(wmOperatorType *ot)
                   "ASCII Format",
                   "Export file in ASCII format, export as binary otherwise");
 
-  /* Only show `.ply` files by default. */
-  prop = RNA_def_string(ot->srna, "filter_glob", "*.ply", 0, "Extension Filter", "");
+  /* Only show `.ply` files by default, including compressed files. */
+  prop = RNA_def_string(
+      ot->srna, "filter_glob", "*.ply;*.ply.gz;*.ply.zst", 0, "Extension Filter", "");
   RNA_def_property_flag(prop, PROP_HIDDEN);
 }
 
@@ -346,8 +348,9 @@ void WM_OT_ply_import(wmOperatorType *ot)
   RNA_def_boolean(
       ot->srna, "import_attributes", true, "Vertex Attributes", "Import custom vertex attributes");
 
-  /* Only show `.ply` files by default. */
-  prop = RNA_def_string(ot->srna, "filter_glob", "*.ply", 0, "Extension Filter", "");
+  /* Only show `.ply` files by default, including compressed files. */
+  prop = RNA_def_string(
+      ot->srna, "filter_glob", "*.ply;*.ply.gz;*.ply.zst", 0, "Extension Filter", "");
   RNA_def_property_flag(prop, PROP_HIDDEN);
 }
 
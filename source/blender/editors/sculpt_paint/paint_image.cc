@@ -154,7 +154,7 @@ void imapaint_image_update(
   }
 
   if (ibuf->mipmap[0]) {
-    ibuf->userflags |= IB_MIPMAP_INVALID;
+    IMB_mipmap_invalidate_region(ibuf, &imapaintpartial.dirty_region);
   }
 
   IMB_partial_display_buffer_update_delayed(ibuf,
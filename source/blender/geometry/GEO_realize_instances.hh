@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <optional>
+
+#include "BLI_function_ref.hh"
+#include "BLI_set.hh"
+
 #include "BKE_geometry_set.hh"
 
 namespace blender::geometry {
@@ -26,6 +31,14 @@ struct RealizeInstancesOptions {
   bool realize_instance_attributes = true;
 
   bke::AnonymousAttributePropagationInfo propagation_info;
+
+  /**
+   * When set, only generic attributes with these names are propagated to the result. Built-in
+   * attributes of the result (like positions) are always created. This avoids copying data that
+   * is not used afterwards, e.g. by an exporter that only writes some attributes. Anonymous
+   * attributes are still controlled by #propagation_info.
+   */
+  std::optional<Set<std::string>> attribute_names;
 };
 
 /**
@@ -69,4 +82,19 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
                                    const RealizeInstancesOptions &options,
                                    const VariedDepthOptions &varied_depth_option);
 
+/**
+ * Like #realize_instances, but instead of joining everything into a single geometry, instances are
+ * realized in chunks which are passed to \a fn one after another. Each chunk contains roughly at
+ * most \a max_chunk_points points (vertices for meshes), unless a single instance is larger than
+ * that. The realized data therefore never has to be in memory all at once, which is useful when
+ * it is only consumed by something like an exporter or a render engine.
+ *
+ * Every chunk contains a single realized component type. Instances that are kept, volumes and
+ * edit data are passed with the first chunk.
+ */
+void realize_instances_chunked(bke::GeometrySet geometry_set,
+                               const RealizeInstancesOptions &options,
+                               int64_t max_chunk_points,
+                               FunctionRef<void(bke::GeometrySet chunk)> fn);
+
 }  // namespace blender::geometry
@@ -827,6 +827,7 @@ static void gather_attributes_for_propagation(
     const VArray<int> &instance_depth,
     const IndexMask selection,
     const bke::AnonymousAttributePropagationInfo &propagation_info,
+    const std::optional<Set<std::string>> &attribute_names,
     Map<AttributeIDRef, AttributeKind> &r_attributes)
 {
   /* Only needed right now to check if an attribute is built-in on this component type.
@@ -857,6 +858,13 @@ static void gather_attributes_for_propagation(
                           !propagation_info.propagate(attribute_id.anonymous_id())) {
                         return;
                       }
+                      if (attribute_names && !attribute_id.is_anonymous() &&
+                          !attribute_names->contains(attribute_id.name()) &&
+                          !dummy_component->attributes()->is_builtin(attribute_id))
+                      {
+                        /* The caller is not interested in this attribute. */
+                        return;
+                      }
 
                       AttrDomain domain = meta_data.domain;
                       if (dst_component_type != bke::GeometryComponent::Type::Instance &&
@@ -900,6 +908,7 @@ static OrderedAttributes gather_generic_instance_attributes_to_propagate(
                                     varied_depth_option.depths,
                                     varied_depth_option.selection,
                                     options.propagation_info,
+                                    options.attribute_names,
                                     attributes_to_propagate);
   attributes_to_propagate.pop_try("id");
   OrderedAttributes ordered_attributes;
@@ -1029,6 +1038,7 @@ static OrderedAttributes gather_generic_pointcloud_attributes_to_propagate(
                                     varied_depth_option.depths,
                                     varied_depth_option.selection,
                                     options.propagation_info,
+                                    options.attribute_names,
                                     attributes_to_propagate);
 
   attributes_to_propagate.remove("position");
@@ -1238,6 +1248,7 @@ static OrderedAttributes gather_generic_mesh_attributes_to_propagate(
                                     varied_depth_option.depths,
                                     varied_depth_option.selection,
                                     options.propagation_info,
+                                    options.attribute_names,
                                     attributes_to_propagate);
   attributes_to_propagate.remove("position");
   attributes_to_propagate.remove(".edge_verts");
@@ -1608,6 +1619,7 @@ static OrderedAttributes gather_generic_curve_attributes_to_propagate(
                                     varied_depth_option.depths,
                                     varied_depth_option.selection,
                                     options.propagation_info,
+                                    options.attribute_names,
                                     attributes_to_propagate);
   attributes_to_propagate.remove("position");
   attributes_to_propagate.remove("radius");
@@ -1966,35 +1978,25 @@ static void propagate_instances_to_keep(
   new_instances_components.replace(new_instances.release(), bke::GeometryOwnershipType::Owned);
 }
 
-bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
-                                   const RealizeInstancesOptions &options)
+static VariedDepthOptions all_instances_depth_options(const Instances &instances)
 {
-  if (!geometry_set.has_instances()) {
-    return geometry_set;
-  }
-
   VariedDepthOptions all_instances;
   all_instances.depths = VArray<int>::ForSingle(VariedDepthOptions::MAX_DEPTH,
-                                                geometry_set.get_instances()->instances_num());
-  all_instances.selection = IndexMask(geometry_set.get_instances()->instances_num());
-  return realize_instances(geometry_set, options, all_instances);
+                                                instances.instances_num());
+  all_instances.selection = IndexMask(instances.instances_num());
+  return all_instances;
 }
 
-bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
-                                   const RealizeInstancesOptions &options,
-                                   const VariedDepthOptions &varied_depth_option)
+/**
+ * Preprocess each unique geometry that is instanced and gather the tasks to realize the instances
+ * (the first two steps of #realize_instances). The gathered tasks reference the preprocessed
+ * data, so they are only valid within \a fn.
+ */
+static void gather_realize_tasks(bke::GeometrySet &geometry_set,
+                                 const RealizeInstancesOptions &options,
+                                 const VariedDepthOptions &varied_depth_option,
+                                 const FunctionRef<void(GatherTasksInfo &gather_info)> fn)
 {
-  /* The algorithm works in three steps:
-   * 1. Preprocess each unique geometry that is instanced (e.g. each `Mesh`).
-   * 2. Gather "tasks" that need to be executed to realize the instances. Each task corresponds to
-   *    instances of the previously preprocessed geometry.
-   * 3. Execute all tasks in parallel.
-   */
-
-  if (!geometry_set.has_instances()) {
-    return geometry_set;
-  }
-
   bke::GeometrySet not_to_realize_set;
   propagate_instances_to_keep(
       geometry_set, varied_depth_option.selection, not_to_realize_set, options.propagation_info);
@@ -2036,45 +2038,222 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
   gather_realize_tasks_recursive(
       gather_info, 0, VariedDepthOptions::MAX_DEPTH, geometry_set, transform, attribute_fallbacks);
 
-  bke::GeometrySet new_geometry_set;
+  fn(gather_info);
+}
+
+/** Add the data which is not realized by any task to the result. */
+static void add_unrealized_data(GatherTasksInfo &gather_info, bke::GeometrySet &r_geometry_set)
+{
   execute_instances_tasks(gather_info.instances.instances_components_to_merge,
                           gather_info.instances.instances_components_transforms,
-                          all_instance_attributes,
+                          gather_info.instances_attriubutes,
                           gather_info.instances.attribute_fallback,
-                          new_geometry_set);
-
-  const int64_t total_points_num = get_final_points_num(gather_info.r_tasks);
-  /* This doesn't have to be exact at all, it's just a rough estimate ot make decisions about
-   * multi-threading (overhead). */
-  const int64_t approximate_used_bytes_num = total_points_num * 32;
-  threading::memory_bandwidth_bound_task(approximate_used_bytes_num, [&]() {
-    execute_realize_pointcloud_tasks(options,
-                                     all_pointclouds_info,
-                                     gather_info.r_tasks.pointcloud_tasks,
-                                     all_pointclouds_info.attributes,
-                                     new_geometry_set);
-    execute_realize_mesh_tasks(options,
-                               all_meshes_info,
-                               gather_info.r_tasks.mesh_tasks,
-                               all_meshes_info.attributes,
-                               all_meshes_info.materials,
-                               new_geometry_set);
-    execute_realize_curve_tasks(options,
-                                all_curves_info,
-                                gather_info.r_tasks.curve_tasks,
-                                all_curves_info.attributes,
-                                new_geometry_set);
-  });
+                          r_geometry_set);
   if (gather_info.r_tasks.first_volume) {
-    new_geometry_set.add(*gather_info.r_tasks.first_volume);
+    r_geometry_set.add(*gather_info.r_tasks.first_volume);
   }
   if (gather_info.r_tasks.first_edit_data) {
-    new_geometry_set.add(*gather_info.r_tasks.first_edit_data);
+    r_geometry_set.add(*gather_info.r_tasks.first_edit_data);
+  }
+}
+
+bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
+                                   const RealizeInstancesOptions &options)
+{
+  if (!geometry_set.has_instances()) {
+    return geometry_set;
+  }
+
+  return realize_instances(
+      geometry_set, options, all_instances_depth_options(*geometry_set.get_instances()));
+}
+
+bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
+                                   const RealizeInstancesOptions &options,
+                                   const VariedDepthOptions &varied_depth_option)
+{
+  /* The algorithm works in three steps:
+   * 1. Preprocess each unique geometry that is instanced (e.g. each `Mesh`).
+   * 2. Gather "tasks" that need to be executed to realize the instances. Each task corresponds to
+   *    instances of the previously preprocessed geometry.
+   * 3. Execute all tasks in parallel.
+   */
+
+  if (!geometry_set.has_instances()) {
+    return geometry_set;
   }
 
+  bke::GeometrySet new_geometry_set;
+  gather_realize_tasks(
+      geometry_set, options, varied_depth_option, [&](GatherTasksInfo &gather_info) {
+        const GatherTasks &tasks = gather_info.r_tasks;
+        const int64_t total_points_num = get_final_points_num(tasks);
+        /* This doesn't have to be exact at all, it's just a rough estimate ot make decisions
+         * about multi-threading (overhead). */
+        const int64_t approximate_used_bytes_num = total_points_num * 32;
+        threading::memory_bandwidth_bound_task(approximate_used_bytes_num, [&]() {
+          execute_realize_pointcloud_tasks(options,
+                                           gather_info.pointclouds,
+                                           tasks.pointcloud_tasks,
+                                           gather_info.pointclouds.attributes,
+                                           new_geometry_set);
+          execute_realize_mesh_tasks(options,
+                                     gather_info.meshes,
+                                     tasks.mesh_tasks,
+                                     gather_info.meshes.attributes,
+                                     gather_info.meshes.materials,
+                                     new_geometry_set);
+          execute_realize_curve_tasks(options,
+                                      gather_info.curves,
+                                      tasks.curve_tasks,
+                                      gather_info.curves.attributes,
+                                      new_geometry_set);
+        });
+        add_unrealized_data(gather_info, new_geometry_set);
+      });
+
   return new_geometry_set;
 }
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Chunked Realize Instances
+ * \{ */
+
+static int64_t task_points_num(const RealizePointCloudTask &task)
+{
+  return task.pointcloud_info->pointcloud->totpoint;
+}
+
+static int64_t task_points_num(const RealizeMeshTask &task)
+{
+  return task.mesh_info->mesh->verts_num;
+}
+
+static int64_t task_points_num(const RealizeCurveTask &task)
+{
+  return task.curve_info->curves->geometry.point_num;
+}
+
+/** Make the task write to a result that starts at the output of the \a first task. */
+static void rebase_task(RealizePointCloudTask &task, const RealizePointCloudTask &first)
+{
+  task.start_index -= first.start_index;
+}
+
+static void rebase_task(RealizeMeshTask &task, const RealizeMeshTask &first)
+{
+  task.start_indices.vertex -= first.start_indices.vertex;
+  task.start_indices.edge -= first.start_indices.edge;
+  task.start_indices.face -= first.start_indices.face;
+  task.start_indices.loop -= first.start_indices.loop;
+}
+
+static void rebase_task(RealizeCurveTask &task, const RealizeCurveTask &first)
+{
+  task.start_indices.point -= first.start_indices.point;
+  task.start_indices.curve -= first.start_indices.curve;
+}
+
+/**
+ * Split the tasks into consecutive chunks of at most \a max_points_num points, unless a single
+ * task is larger than that. The tasks are rebased in place, so the start indices of the tasks
+ * passed to \a fn are relative to the start of the chunk.
+ */
+template<typename Task>
+static void foreach_task_chunk(const MutableSpan<Task> tasks,
+                               const int64_t max_points_num,
+                               const FunctionRef<void(Span<Task> chunk_tasks)> fn)
+{
+  int64_t chunk_start = 0;
+  int64_t chunk_points_num = 0;
+  auto flush = [&](const int64_t chunk_end) {
+    if (chunk_end == chunk_start) {
+      return;
+    }
+    const MutableSpan<Task> chunk_tasks = tasks.slice(chunk_start, chunk_end - chunk_start);
+    /* Iterate backwards so that the first task is only rebased after all others. */
+    for (int64_t i = chunk_tasks.size() - 1; i >= 0; i--) {
+      rebase_task(chunk_tasks[i], chunk_tasks.first());
+    }
+    threading::memory_bandwidth_bound_task(chunk_points_num * 32,
+                                           [&]() { fn(chunk_tasks.as_span()); });
+    chunk_start = chunk_end;
+    chunk_points_num = 0;
+  };
+  for (const int64_t i : tasks.index_range()) {
+    const int64_t points_num = task_points_num(tasks[i]);
+    if (chunk_points_num + points_num > max_points_num) {
+      flush(i);
+    }
+    chunk_points_num += points_num;
+  }
+  flush(tasks.size());
+}
+
+void realize_instances_chunked(bke::GeometrySet geometry_set,
+                               const RealizeInstancesOptions &options,
+                               const int64_t max_chunk_points,
+                               const FunctionRef<void(bke::GeometrySet chunk)> fn)
+{
+  if (!geometry_set.has_instances()) {
+    fn(std::move(geometry_set));
+    return;
+  }
+
+  const VariedDepthOptions all_instances = all_instances_depth_options(
+      *geometry_set.get_instances());
+  gather_realize_tasks(geometry_set, options, all_instances, [&](GatherTasksInfo &gather_info) {
+    GatherTasks &tasks = gather_info.r_tasks;
+
+    /* Passed along with the first chunk. */
+    std::optional<bke::GeometrySet> unrealized_data = bke::GeometrySet();
+    add_unrealized_data(gather_info, *unrealized_data);
+    auto new_chunk = [&]() {
+      bke::GeometrySet chunk = unrealized_data.value_or(bke::GeometrySet());
+      unrealized_data.reset();
+      return chunk;
+    };
+
+    foreach_task_chunk<RealizePointCloudTask>(
+        tasks.pointcloud_tasks, max_chunk_points, [&](const Span<RealizePointCloudTask> chunk) {
+          bke::GeometrySet chunk_geometry = new_chunk();
+          execute_realize_pointcloud_tasks(options,
+                                           gather_info.pointclouds,
+                                           chunk,
+                                           gather_info.pointclouds.attributes,
+                                           chunk_geometry);
+          fn(std::move(chunk_geometry));
+        });
+    foreach_task_chunk<RealizeMeshTask>(
+        tasks.mesh_tasks, max_chunk_points, [&](const Span<RealizeMeshTask> chunk) {
+          bke::GeometrySet chunk_geometry = new_chunk();
+          execute_realize_mesh_tasks(options,
+                                     gather_info.meshes,
+                                     chunk,
+                                     gather_info.meshes.attributes,
+                                     gather_info.meshes.materials,
+                                     chunk_geometry);
+          fn(std::move(chunk_geometry));
+        });
+    foreach_task_chunk<RealizeCurveTask>(
+        tasks.curve_tasks, max_chunk_points, [&](const Span<RealizeCurveTask> chunk) {
+          bke::GeometrySet chunk_geometry = new_chunk();
+          execute_realize_curve_tasks(options,
+                                      gather_info.curves,
+                                      chunk,
+                                      gather_info.curves.attributes,
+                                      chunk_geometry);
+          fn(std::move(chunk_geometry));
+        });
+
+    if (unrealized_data && !unrealized_data->is_empty()) {
+      fn(std::move(*unrealized_data));
+    }
+  });
+}
+
+/** \} */
+
 }  // namespace blender::geometry
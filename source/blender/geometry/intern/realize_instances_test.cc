@@ -0,0 +1,103 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_math_matrix.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_instances.hh"
+#include "BKE_mesh.hh"
+
+#include "GEO_mesh_primitive_cuboid.hh"
+#include "GEO_realize_instances.hh"
+
+namespace blender::geometry::tests {
+
+class RealizeInstancesTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/* A row of cubes with 8 vertices each, which have a "weight" attribute. */
+static bke::GeometrySet create_cube_instances(const int instances_num)
+{
+  Mesh *mesh = create_cuboid_mesh(float3(1.0f), 2, 2, 2);
+  bke::SpanAttributeWriter<float> weight =
+      mesh->attributes_for_write().lookup_or_add_for_write_only_span<float>(
+          "weight", bke::AttrDomain::Point);
+  weight.span.fill(1.0f);
+  weight.finish();
+
+  bke::Instances *instances = new bke::Instances();
+  const int handle = instances->add_reference(bke::GeometrySet::from_mesh(mesh));
+  for (const int i : IndexRange(instances_num)) {
+    instances->add_instance(handle, math::from_location<float4x4>(float3(i * 2.0f, 0.0f, 0.0f)));
+  }
+  return bke::GeometrySet::from_instances(instances);
+}
+
+TEST_F(RealizeInstancesTest, chunks_match_realize_instances)
+{
+  const bke::GeometrySet geometry = create_cube_instances(10);
+  const RealizeInstancesOptions options;
+  const bke::GeometrySet realized = realize_instances(geometry, options);
+  const Mesh &realized_mesh = *realized.get_mesh();
+
+  Vector<float3> chunk_positions;
+  int chunks_num = 0;
+  int faces_num = 0;
+  realize_instances_chunked(geometry, options, 20, [&](const bke::GeometrySet chunk) {
+    const Mesh *mesh = chunk.get_mesh();
+    ASSERT_NE(mesh, nullptr);
+    EXPECT_FALSE(chunk.has_instances());
+    EXPECT_LE(mesh->verts_num, 20);
+    chunk_positions.extend(mesh->vert_positions());
+    faces_num += mesh->faces_num;
+    chunks_num++;
+  });
+
+  EXPECT_EQ(chunks_num, 5);
+  EXPECT_EQ(faces_num, realized_mesh.faces_num);
+  const Span<float3> realized_positions = realized_mesh.vert_positions();
+  ASSERT_EQ(realized_positions.size(), chunk_positions.size());
+  EXPECT_EQ_ARRAY(realized_positions.data(), chunk_positions.data(), chunk_positions.size());
+}
+
+TEST_F(RealizeInstancesTest, chunk_larger_than_limit)
+{
+  const bke::GeometrySet geometry = create_cube_instances(3);
+  int chunks_num = 0;
+  realize_instances_chunked(geometry, {}, 4, [&](const bke::GeometrySet chunk) {
+    /* A single instance is never split. */
+    EXPECT_EQ(chunk.get_mesh()->verts_num, 8);
+    chunks_num++;
+  });
+  EXPECT_EQ(chunks_num, 3);
+}
+
+TEST_F(RealizeInstancesTest, attribute_names)
+{
+  const bke::GeometrySet geometry = create_cube_instances(2);
+
+  RealizeInstancesOptions options;
+  options.attribute_names.emplace();
+  realize_instances_chunked(geometry, options, 1000, [&](const bke::GeometrySet chunk) {
+    const bke::AttributeAccessor attributes = chunk.get_mesh()->attributes();
+    EXPECT_TRUE(attributes.contains("position"));
+    EXPECT_FALSE(attributes.contains("weight"));
+  });
+
+  options.attribute_names->add("weight");
+  realize_instances_chunked(geometry, options, 1000, [&](const bke::GeometrySet chunk) {
+    EXPECT_TRUE(chunk.get_mesh()->attributes().contains("weight"));
+  });
+}
+
+}  // namespace blender::geometry::tests
@@ -362,6 +362,11 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
  */
 ImBuf *IMB_anim_previewframe(ImBufAnim *anim);
 
+/**
+ * Memory used by decoded movie frames that are kept for playback, of all movies together.
+ */
+size_t IMB_anim_decoded_frames_memory_in_use();
+
 void IMB_free_anim(ImBufAnim *anim);
 
 #define FILTER_MASK_NULL 0
@@ -384,8 +389,15 @@ void IMB_filter_extend(ImBuf *ibuf, char *mask, int filter);
 void IMB_makemipmap(ImBuf *ibuf, int use_filter);
 /**
  * Thread-safe version, only recreates existing maps.
+ * When only #IB_MIPMAP_INVALID_REGION is set, only the part of the maps depending on the invalid
+ * region is recreated.
  */
 void IMB_remakemipmap(ImBuf *ibuf, int use_filter);
+/**
+ * Mark pixels of \a ibuf as changed, so the next #IMB_remakemipmap only updates the part of the
+ * maps depending on them. The region is added to any previously invalidated region.
+ */
+void IMB_mipmap_invalidate_region(ImBuf *ibuf, const rcti *region);
 ImBuf *IMB_getmipmap(ImBuf *ibuf, int level);
 
 void IMB_filtery(ImBuf *ibuf);
@@ -404,6 +416,36 @@ bool IMB_scalefastImBuf(ImBuf *ibuf, unsigned int newx, unsigned int newy);
 
 void IMB_scaleImBuf_threaded(ImBuf *ibuf, unsigned int newx, unsigned int newy);
 
+enum eIMBScaleFilter {
+  /** Average of the covered source pixels, same as nearest when scaling up. */
+  IMB_SCALE_FILTER_BOX,
+  /** Mitchell-Netravali cubic, sharper than box with little ringing. */
+  IMB_SCALE_FILTER_MITCHELL,
+  /** Three lobe Lanczos, the sharpest but may give some ringing near edges. */
+  IMB_SCALE_FILTER_LANCZOS,
+};
+
+/**
+ * Scale the byte and float buffers of \a ibuf with a separable filter, first horizontally and
+ * then vertically. When scaling down the filter is widened to cover all source pixels.
+ *
+ * Return true if \a ibuf is modified.
+ */
+bool IMB_scale_filtered(ImBuf *ibuf,
+                        unsigned int newx,
+                        unsigned int newy,
+                        eIMBScaleFilter filter,
+                        bool threaded = true);
+
+/**
+ * Same as #IMB_scale_filtered, but leaves \a ibuf unchanged and returns a new scaled image.
+ */
+ImBuf *IMB_scale_filtered_into_new(const ImBuf *ibuf,
+                                   unsigned int newx,
+                                   unsigned int newy,
+                                   eIMBScaleFilter filter,
+                                   bool threaded = true);
+
 bool IMB_saveiff(ImBuf *ibuf, const char *filepath, int flags);
 
 bool IMB_ispic(const char *filepath);
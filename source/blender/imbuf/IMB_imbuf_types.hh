@@ -231,6 +231,8 @@ struct ImBuf {
   /** MipMap levels, a series of halved images */
   ImBuf *mipmap[IMB_MIPMAP_LEVELS];
   int miptot, miplevel;
+  /** Changed pixels, when only part of the mipmaps is invalid, see #IB_MIPMAP_INVALID_REGION. */
+  rcti mipmap_invalid_rect;
 
   /* externally used data */
   /** reference index for ImBuf lists */
@@ -289,6 +291,8 @@ enum {
   IB_DISPLAY_BUFFER_INVALID = (1 << 4),
   /** image buffer is persistent in the memory and should never be removed from the cache */
   IB_PERSISTENT = (1 << 5),
+  /** only the #ImBuf::mipmap_invalid_rect region of the image mipmaps is invalid */
+  IB_MIPMAP_INVALID_REGION = (1 << 6),
 };
 
 /** \} */
@@ -74,6 +74,11 @@ float *IMB_exr_channel_rect(void *handle,
                             const char *passname,
                             const char *view);
 
+/**
+ * Read the pixels of all channels that have a buffer, assigned with #IMB_exr_set_channel or
+ * allocated when the channels were parsed. Parts of multi-part files without any such channel are
+ * skipped, so only the passes that are needed have to be decompressed.
+ */
 void IMB_exr_read_channels(void *handle);
 void IMB_exr_write_channels(void *handle);
 /**
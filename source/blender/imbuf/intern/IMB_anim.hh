@@ -19,6 +19,7 @@ struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
+struct ImBufAnimDecodeAhead;
 #endif
 
 struct IDProperty;
@@ -59,6 +60,9 @@ struct ImBufAnim {
   AVPacket *cur_packet;
 
   bool seek_before_decode;
+
+  /** Frames decoded ahead during sequential playback, see #ImBufAnimDecodeAhead. */
+  ImBufAnimDecodeAhead *decode_ahead;
 #endif
 
   char index_dir[768];
@@ -12,6 +12,7 @@
 #include "BLI_sys_types.h"
 
 struct ImBuf;
+struct rcti;
 
 void IMB_premultiply_rect(uint8_t *rect, char planes, int w, int h);
 void IMB_premultiply_rect_float(float *rect_float, int channels, int w, int h);
@@ -23,3 +24,8 @@ void IMB_unpremultiply_rect_float(float *rect_float, int channels, int w, int h)
  * Result in ibuf2, scaling should be done correctly.
  */
 void imb_onehalf_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1);
+
+/**
+ * Same as #imb_onehalf_no_alloc, but only writes the pixels of \a ibuf2 inside \a region.
+ */
+void imb_onehalf_region_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1, const rcti *region);
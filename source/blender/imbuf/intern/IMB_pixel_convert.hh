@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup imbuf
+ * \brief Conversion of contiguous RGBA pixels, implemented in `divers.cc`.
+ *
+ * These match the per-pixel functions from `BLI_math_color.h`, but use SIMD instructions when
+ * available. They are used for the byte/float conversions done on every displayed image.
+ */
+
+#pragma once
+
+#include "BLI_sys_types.h"
+
+/** Same as #rgba_uchar_to_float for every pixel. */
+void imb_pixels_rgba_byte_to_float(float *to, const uchar *from, int64_t pixels_num);
+
+/**
+ * Same as #rgba_float_to_uchar for every pixel, with `predivide` the pixels are converted to
+ * straight alpha first, like #premul_to_straight_v4_v4.
+ */
+void imb_pixels_rgba_float_to_byte(uchar *to,
+                                   const float *from,
+                                   int64_t pixels_num,
+                                   bool predivide);
+
+/**
+ * Same as #imb_pixels_rgba_float_to_byte, adding dither noise to the color channels.
+ * The noise of a pixel depends on its normalized image coordinates, `s` is the coordinate of the
+ * first pixel and increases by `s_step` per pixel.
+ */
+void imb_pixels_rgba_float_to_byte_dither(uchar *to,
+                                          const float *from,
+                                          int64_t pixels_num,
+                                          bool predivide,
+                                          float dither,
+                                          float s,
+                                          float s_step,
+                                          float t);
+
+/** Same as #straight_to_premul_v4 for every pixel. */
+void imb_pixels_rgba_premultiply(float *pixels, int64_t pixels_num);
+
+/**
+ * Same as #premul_to_straight_v4_v4 for every pixel, `to` and `from` may be the same buffer.
+ */
+void imb_pixels_rgba_unpremultiply(float *to, const float *from, int64_t pixels_num);
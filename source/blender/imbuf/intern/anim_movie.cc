@@ -22,9 +22,11 @@
 #include "BLI_string.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "DNA_scene_types.h"
 
+#include "MEM_CacheLimiterC-Api.h"
 #include "MEM_guardedalloc.h"
 
 #include "IMB_imbuf.hh"
@@ -38,6 +40,11 @@
 #include "IMB_metadata.hh"
 
 #ifdef WITH_FFMPEG
+#  include <atomic>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+
 #  include "BKE_writeffmpeg.hh"
 
 extern "C" {
@@ -53,7 +60,68 @@ extern "C" {
 #endif /* WITH_FFMPEG */
 
 #ifdef WITH_FFMPEG
+/** Number of frames decoded ahead of the requested frame during sequential playback. */
+#  define FFMPEG_DECODE_AHEAD_FRAMES 8
+/** Maximum number of decoded frames that are kept for each movie. */
+#  define FFMPEG_DECODED_FRAMES_MAX 12
+/**
+ * Part of the cache memory limit that decoded frames of all movies may use together. The rest is
+ * left for the caches of the final images, which count decoded frames as used memory too.
+ */
+#  define FFMPEG_DECODED_FRAMES_MEMORY_FRACTION 4
+
+/**
+ * Decoding a frame can take longer than a frame's duration for high resolution footage, and
+ * seeking in long GOP footage has to decode all frames from the previous key frame. When frames
+ * are requested in sequence, a background thread decodes the following frames ahead of time.
+ * Decoded frames are kept in a small cache, so requests for them don't have to wait for the
+ * decoder, and stepping back to recent frames doesn't need a seek.
+ *
+ * Frames are kept as references to the decoded #AVFrame, conversion to RGB happens when a frame
+ * is requested, as it can use all threads.
+ *
+ * `decode_mutex` guards the decoder state of #ImBufAnim, `mutex` guards the members of this
+ * struct. When both are locked, `decode_mutex` is locked first.
+ */
+struct ImBufAnimDecodeAhead {
+  struct Frame {
+    int position;
+    IMB_Timecode_Type tc;
+    AVFrame *frame;
+    int64_t last_use;
+    /** Size of the frame's buffers, counted in #ffmpeg_decoded_frames_memory. */
+    size_t size;
+  };
+
+  std::mutex decode_mutex;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::thread thread;
+  bool stop = false;
+
+  blender::Vector<Frame> frames;
+  int64_t use_counter = 0;
+
+  /** Last requested frame and time-code. */
+  int position = -1;
+  IMB_Timecode_Type tc = IMB_TC_NONE;
+  /** Last frame that should be decoded ahead, -1 when no frames are decoded ahead. */
+  int decode_end = -1;
+  /** Copy of `ImBufAnim.cur_position`, so it can be read without locking the decoder. */
+  int decoder_position = -1;
+  /**
+   * Duration for `duration_tc`. Getting the duration may open the time-code index, which the
+   * decoder uses too, so it is only done once with `decode_mutex` locked.
+   */
+  int duration = -1;
+  IMB_Timecode_Type duration_tc = IMB_TC_NONE;
+};
+
+/** Memory used by the decoded frames of all movies. */
+static std::atomic<size_t> ffmpeg_decoded_frames_memory = 0;
+
 static void free_anim_ffmpeg(ImBufAnim *anim);
+static void ffmpeg_decode_ahead_stop(ImBufAnim *anim);
 #endif
 
 void IMB_free_anim(ImBufAnim *anim)
@@ -87,6 +155,11 @@ void IMB_close_anim_proxies(ImBufAnim *anim)
     return;
   }
 
+#ifdef WITH_FFMPEG
+  /* The decode-ahead thread uses the time-code indices, and cached frames may not match the
+   * rebuilt indices. */
+  ffmpeg_decode_ahead_stop(anim);
+#endif
   IMB_free_indices(anim);
 }
 
@@ -457,6 +530,8 @@ static int startffmpeg(ImBufAnim *anim)
     fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
   }
 
+  anim->decode_ahead = MEM_new<ImBufAnimDecodeAhead>(__func__);
+
   return 0;
 }
 
@@ -544,10 +619,10 @@ static void ffmpeg_postprocess(ImBufAnim *anim, AVFrame *input, ImBuf *ibuf)
 
   if (anim->ib_flags & IB_animdeinterlace) {
     if (av_image_deinterlace(anim->pFrameDeinterlaced,
-                             anim->pFrame,
-                             anim->pCodecCtx->pix_fmt,
-                             anim->pCodecCtx->width,
-                             anim->pCodecCtx->height) < 0)
+                             input,
+                             AVPixelFormat(input->format),
+                             input->width,
+                             input->height) < 0)
     {
       filter_y = true;
     }
@@ -1081,12 +1156,16 @@ static bool ffmpeg_must_seek(ImBufAnim *anim, int position)
   return must_seek;
 }
 
-static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+/**
+ * Decode the frame at `position`, seeking when it does not follow the last decoded frame.
+ * The decoder has to be locked by the caller.
+ *
+ * \return A new reference to the decoded frame, or nullptr when no frame could be decoded.
+ */
+static AVFrame *ffmpeg_decode_frame_at_position(ImBufAnim *anim,
+                                                int position,
+                                                IMB_Timecode_Type tc)
 {
-  if (anim == nullptr) {
-    return nullptr;
-  }
-
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: seek_pos=%d\n", position);
 
   ImBufAnimIndex *tc_index = IMB_anim_open_index(anim, tc);
@@ -1111,9 +1190,286 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
 
   ffmpeg_decode_video_frame_scan(anim, pts_to_search);
 
+  AVFrame *final_frame = ffmpeg_frame_by_pts_get(anim, pts_to_search);
+  if (final_frame == nullptr) {
+    /* No valid frame was decoded for requested PTS, fall back on most recent decoded frame, even
+     * if it is incorrect. */
+    final_frame = ffmpeg_double_buffer_frame_fallback_get(anim);
+  }
+
+  anim->cur_position = position;
+
+  return final_frame ? av_frame_clone(final_frame) : nullptr;
+}
+
+/* Return a new reference to a cached frame, nullptr if it's not cached. */
+static AVFrame *ffmpeg_decoded_frame_lookup(ImBufAnimDecodeAhead &decode_ahead,
+                                            int position,
+                                            IMB_Timecode_Type tc)
+{
+  for (ImBufAnimDecodeAhead::Frame &cached : decode_ahead.frames) {
+    if (cached.position == position && cached.tc == tc) {
+      cached.last_use = decode_ahead.use_counter++;
+      return av_frame_clone(cached.frame);
+    }
+  }
+  return nullptr;
+}
+
+static size_t ffmpeg_frame_size_in_memory(const AVFrame *frame)
+{
+  size_t size = 0;
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++) {
+    if (frame->buf[i]) {
+      size += frame->buf[i]->size;
+    }
+  }
+  for (int i = 0; i < frame->nb_extended_buf; i++) {
+    size += frame->extended_buf[i]->size;
+  }
+  return size;
+}
+
+static void ffmpeg_decoded_frame_remove(ImBufAnimDecodeAhead &decode_ahead, const int64_t index)
+{
+  ffmpeg_decoded_frames_memory -= decode_ahead.frames[index].size;
+  av_frame_free(&decode_ahead.frames[index].frame);
+  decode_ahead.frames.remove_and_reorder(index);
+}
+
+/**
+ * Remove the least recently used frame, frames that were decoded ahead and not requested yet are
+ * only removed when there is no other frame, and not at all when \a keep_ahead is set.
+ * \return False when no frame could be removed.
+ */
+static bool ffmpeg_decoded_frame_remove_lru(ImBufAnimDecodeAhead &decode_ahead,
+                                            const bool keep_ahead)
+{
+  int64_t remove_index = -1;
+  bool remove_is_ahead = true;
+  for (const int64_t i : decode_ahead.frames.index_range()) {
+    const ImBufAnimDecodeAhead::Frame &cached = decode_ahead.frames[i];
+    const bool is_ahead = cached.tc == decode_ahead.tc &&
+                          cached.position > decode_ahead.position &&
+                          cached.position <= decode_ahead.decode_end;
+    if (is_ahead && keep_ahead) {
+      continue;
+    }
+    if (remove_index == -1 || (remove_is_ahead && !is_ahead) ||
+        (remove_is_ahead == is_ahead &&
+         cached.last_use < decode_ahead.frames[remove_index].last_use))
+    {
+      remove_index = i;
+      remove_is_ahead = is_ahead;
+    }
+  }
+  if (remove_index == -1) {
+    return false;
+  }
+  ffmpeg_decoded_frame_remove(decode_ahead, remove_index);
+  return true;
+}
+
+/**
+ * Keep a reference to the frame, removing other frames to stay within the frame count and the
+ * memory budget. Frames that are decoded ahead don't replace other frames decoded ahead.
+ * \return False when the frame could not be added.
+ */
+static bool ffmpeg_decoded_frame_add(ImBufAnimDecodeAhead &decode_ahead,
+                                     int position,
+                                     IMB_Timecode_Type tc,
+                                     const AVFrame *frame,
+                                     const bool is_decoded_ahead)
+{
+  for (const ImBufAnimDecodeAhead::Frame &cached : decode_ahead.frames) {
+    if (cached.position == position && cached.tc == tc) {
+      return true;
+    }
+  }
+
+  const size_t size = ffmpeg_frame_size_in_memory(frame);
+  /* A maximum of zero means the cache memory is not limited. */
+  const size_t memory_limit = MEM_CacheLimiter_get_maximum() /
+                              FFMPEG_DECODED_FRAMES_MEMORY_FRACTION;
+  while (decode_ahead.frames.size() >= FFMPEG_DECODED_FRAMES_MAX ||
+         (memory_limit != 0 && ffmpeg_decoded_frames_memory + size > memory_limit))
+  {
+    if (!ffmpeg_decoded_frame_remove_lru(decode_ahead, is_decoded_ahead)) {
+      return false;
+    }
+  }
+
+  decode_ahead.frames.append(
+      {position, tc, av_frame_clone(frame), decode_ahead.use_counter++, size});
+  ffmpeg_decoded_frames_memory += size;
+  return true;
+}
+
+/* Next frame to decode ahead, -1 when no frame should be decoded. */
+static int ffmpeg_decode_ahead_next_position(const ImBufAnimDecodeAhead &decode_ahead)
+{
+  /* Continue after the last requested frame, the decoder may be behind when the requested frames
+   * were found in the cache. */
+  const int position = std::max(decode_ahead.decoder_position, decode_ahead.position) + 1;
+  return (position <= decode_ahead.decode_end) ? position : -1;
+}
+
+static void ffmpeg_decode_ahead_thread(ImBufAnim *anim)
+{
+  ImBufAnimDecodeAhead &decode_ahead = *anim->decode_ahead;
+
+  while (true) {
+    {
+      std::unique_lock lock(decode_ahead.mutex);
+      decode_ahead.cond.wait(lock, [&]() {
+        return decode_ahead.stop || ffmpeg_decode_ahead_next_position(decode_ahead) != -1;
+      });
+      if (decode_ahead.stop) {
+        break;
+      }
+    }
+
+    std::lock_guard decode_lock(decode_ahead.decode_mutex);
+    int position;
+    IMB_Timecode_Type tc;
+    {
+      /* Requests may have changed while waiting for the decoder. */
+      std::lock_guard lock(decode_ahead.mutex);
+      position = ffmpeg_decode_ahead_next_position(decode_ahead);
+      tc = decode_ahead.tc;
+      if (decode_ahead.stop || position == -1) {
+        continue;
+      }
+    }
+
+    AVFrame *frame = ffmpeg_decode_frame_at_position(anim, position, tc);
+
+    std::lock_guard lock(decode_ahead.mutex);
+    decode_ahead.decoder_position = position;
+    if (frame == nullptr) {
+      /* Don't retry frames that can't be decoded. */
+      decode_ahead.decode_end = position;
+      continue;
+    }
+    if (!ffmpeg_decoded_frame_add(decode_ahead, position, tc, frame, true)) {
+      /* The memory budget is used up by frames that are still ahead of the playhead. */
+      decode_ahead.decode_end = position - 1;
+    }
+    av_frame_free(&frame);
+  }
+}
+
+/**
+ * Remember the requested frame, and start decoding the following frames in the background when
+ * frames are requested in sequence.
+ */
+static void ffmpeg_decode_ahead_request(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+{
+  ImBufAnimDecodeAhead &decode_ahead = *anim->decode_ahead;
+
+  int duration;
+  {
+    std::lock_guard lock(decode_ahead.mutex);
+    duration = (decode_ahead.duration_tc == tc) ? decode_ahead.duration : -1;
+  }
+  if (duration == -1) {
+    std::lock_guard decode_lock(decode_ahead.decode_mutex);
+    duration = IMB_anim_get_duration(anim, tc);
+    std::lock_guard lock(decode_ahead.mutex);
+    decode_ahead.duration = duration;
+    decode_ahead.duration_tc = tc;
+  }
+
+  std::lock_guard lock(decode_ahead.mutex);
+  const bool is_sequential = decode_ahead.position >= 0 &&
+                             position == decode_ahead.position + 1 && tc == decode_ahead.tc;
+  decode_ahead.position = position;
+  decode_ahead.tc = tc;
+
+  if (!is_sequential) {
+    decode_ahead.decode_end = -1;
+    return;
+  }
+
+  decode_ahead.decode_end = std::min(position + FFMPEG_DECODE_AHEAD_FRAMES, duration - 1);
+  if (!decode_ahead.thread.joinable()) {
+    decode_ahead.thread = std::thread(ffmpeg_decode_ahead_thread, anim);
+  }
+  decode_ahead.cond.notify_one();
+}
+
+/* Stop decoding ahead and free the cached frames. */
+static void ffmpeg_decode_ahead_stop(ImBufAnim *anim)
+{
+  if (anim->decode_ahead == nullptr) {
+    return;
+  }
+  ImBufAnimDecodeAhead &decode_ahead = *anim->decode_ahead;
+
+  if (decode_ahead.thread.joinable()) {
+    {
+      std::lock_guard lock(decode_ahead.mutex);
+      decode_ahead.stop = true;
+    }
+    decode_ahead.cond.notify_one();
+    decode_ahead.thread.join();
+  }
+
+  while (!decode_ahead.frames.is_empty()) {
+    ffmpeg_decoded_frame_remove(decode_ahead, decode_ahead.frames.size() - 1);
+  }
+  decode_ahead.stop = false;
+  decode_ahead.position = -1;
+  decode_ahead.decode_end = -1;
+  decode_ahead.duration = -1;
+}
+
+static AVFrame *ffmpeg_fetch_frame(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+{
+  ImBufAnimDecodeAhead &decode_ahead = *anim->decode_ahead;
+  ffmpeg_decode_ahead_request(anim, position, tc);
+
+  {
+    std::lock_guard lock(decode_ahead.mutex);
+    if (AVFrame *frame = ffmpeg_decoded_frame_lookup(decode_ahead, position, tc)) {
+      return frame;
+    }
+  }
+
+  std::lock_guard decode_lock(decode_ahead.decode_mutex);
+  {
+    /* The frame may have been decoded ahead while waiting for the decoder. */
+    std::lock_guard lock(decode_ahead.mutex);
+    if (AVFrame *frame = ffmpeg_decoded_frame_lookup(decode_ahead, position, tc)) {
+      return frame;
+    }
+  }
+
+  AVFrame *frame = ffmpeg_decode_frame_at_position(anim, position, tc);
+
+  std::lock_guard lock(decode_ahead.mutex);
+  decode_ahead.decoder_position = position;
+  if (frame != nullptr) {
+    ffmpeg_decoded_frame_add(decode_ahead, position, tc, frame, false);
+  }
+  /* Continue decoding ahead from the new decoder position. */
+  decode_ahead.cond.notify_one();
+  return frame;
+}
+
+static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+{
+  if (anim == nullptr) {
+    return nullptr;
+  }
+
+  AVFrame *final_frame = ffmpeg_fetch_frame(anim, position, tc);
+
   /* Update resolution as it can change per-frame with WebM. See #100741 & #100081. */
-  anim->x = anim->pCodecCtx->width;
-  anim->y = anim->pCodecCtx->height;
+  if (final_frame != nullptr) {
+    anim->x = final_frame->width;
+    anim->y = final_frame->height;
+  }
 
   /* Certain versions of FFmpeg have a bug in libswscale which ends up in crash
    * when destination buffer is not properly aligned. For example, this happens
@@ -1150,21 +1506,13 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
 
   cur_frame_final->byte_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
 
-  AVFrame *final_frame = ffmpeg_frame_by_pts_get(anim, pts_to_search);
-  if (final_frame == nullptr) {
-    /* No valid frame was decoded for requested PTS, fall back on most recent decoded frame, even
-     * if it is incorrect. */
-    final_frame = ffmpeg_double_buffer_frame_fallback_get(anim);
-  }
-
-  /* Even with the fallback from above it is possible that the current decode frame is nullptr. In
-   * this case skip post-processing and return current image buffer. */
+  /* Even with the fallback when decoding it is possible that the current decode frame is nullptr.
+   * In this case skip post-processing and return current image buffer. */
   if (final_frame != nullptr) {
     ffmpeg_postprocess(anim, final_frame, cur_frame_final);
+    av_frame_free(&final_frame);
   }
 
-  anim->cur_position = position;
-
   return cur_frame_final;
 }
 
@@ -1174,6 +1522,11 @@ static void free_anim_ffmpeg(ImBufAnim *anim)
     return;
   }
 
+  /* Stop decoding ahead before freeing the decoder. */
+  ffmpeg_decode_ahead_stop(anim);
+  MEM_delete(anim->decode_ahead);
+  anim->decode_ahead = nullptr;
+
   if (anim->pCodecCtx) {
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -1289,14 +1642,11 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
 #ifdef WITH_FFMPEG
   if (anim->state == ImBufAnim::State::Valid) {
     ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
-    }
   }
 #endif
 
   if (ibuf) {
-    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, anim->cur_position + 1);
+    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, position + 1);
   }
   return ibuf;
 }
@@ -1359,6 +1709,15 @@ bool IMB_anim_get_fps(const ImBufAnim *anim,
   return false;
 }
 
+size_t IMB_anim_decoded_frames_memory_in_use()
+{
+#ifdef WITH_FFMPEG
+  return ffmpeg_decoded_frames_memory;
+#else
+  return 0;
+#endif
+}
+
 int IMB_anim_get_image_width(ImBufAnim *anim)
 {
   return anim->x;
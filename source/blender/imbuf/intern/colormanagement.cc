@@ -25,6 +25,7 @@
 #include "IMB_imbuf_types.hh"
 #include "IMB_metadata.hh"
 #include "IMB_moviecache.hh"
+#include "IMB_pixel_convert.hh"
 
 #include "MEM_guardedalloc.h"
 
@@ -1601,18 +1602,16 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
     size_t i;
 
     /* first convert byte buffer to float, keep in image space */
-    for (i = 0, fp = linear_buffer, cp = byte_buffer; i != i_last;
-         i++, fp += channels, cp += channels)
-    {
-      if (channels == 3) {
+    if (channels == 4) {
+      imb_pixels_rgba_byte_to_float(linear_buffer, byte_buffer, i_last);
+    }
+    else if (channels == 3) {
+      for (i = 0, fp = linear_buffer, cp = byte_buffer; i != i_last; i++, fp += 3, cp += 3) {
         rgb_uchar_to_float(fp, cp);
       }
-      else if (channels == 4) {
-        rgba_uchar_to_float(fp, cp);
-      }
-      else {
-        BLI_assert_msg(0, "Buffers of 3 or 4 channels are only supported here");
-      }
+    }
+    else {
+      BLI_assert_msg(0, "Buffers of 3 or 4 channels are only supported here");
     }
 
     if (!is_data && !is_data_display) {
@@ -1732,13 +1731,7 @@ static void *do_display_buffer_apply_thread(void *handle_v)
       memcpy(display_buffer, linear_buffer, size_t(width) * height * channels * sizeof(float));
 
       if (is_straight_alpha && channels == 4) {
-        const size_t i_last = size_t(width) * height;
-        size_t i;
-        float *fp;
-
-        for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
-          straight_to_premul_v4(fp);
-        }
+        imb_pixels_rgba_premultiply(display_buffer, size_t(width) * height);
       }
     }
 
@@ -2329,20 +2322,22 @@ static void imbuf_byte_to_float_cb(void *__restrict userdata,
   const uchar *in = data->in_buffer + in_offset * 4;
   float *out = data->out_buffer + out_offset * 4;
 
-  /* Convert to scene linear, to sRGB and premultiply. */
-  for (int x = 0; x < data->width; x++, in += 4, out += 4) {
-    float pixel[4];
-    rgba_uchar_to_float(pixel, in);
-    if (data->processor) {
-      OCIO_cpuProcessorApplyRGB(data->processor, pixel);
-    }
-    else {
-      srgb_to_linearrgb_v3_v3(pixel, pixel);
-    }
-    if (data->use_premultiply) {
-      mul_v3_fl(pixel, pixel[3]);
+  /* Convert to scene linear, to sRGB and premultiply. The whole row is converted at once, so the
+   * processor can use its vectorized code path. */
+  imb_pixels_rgba_byte_to_float(out, in, data->width);
+  if (data->processor) {
+    OCIO_PackedImageDesc *img = OCIO_createOCIO_PackedImageDesc(
+        out, data->width, 1, 4, sizeof(float), 4 * sizeof(float), 4 * sizeof(float) * data->width);
+    OCIO_cpuProcessorApply(data->processor, img);
+    OCIO_PackedImageDescRelease(img);
+  }
+  else {
+    for (int x = 0; x < data->width; x++) {
+      srgb_to_linearrgb_v3_v3(out + x * 4, out + x * 4);
     }
-    copy_v4_v4(out, pixel);
+  }
+  if (data->use_premultiply) {
+    imb_pixels_rgba_premultiply(out, data->width);
   }
 }
 
@@ -2389,9 +2384,7 @@ void IMB_colormanagement_imbuf_to_float_texture(float *out_buffer,
       else if (in_channels == 4) {
         /* Copy or convert RGBA. */
         if (use_unpremultiply) {
-          for (int x = 0; x < width; x++, in += 4, out += 4) {
-            premul_to_straight_v4_v4(out, in);
-          }
+          imb_pixels_rgba_unpremultiply(out, in, width);
         }
         else {
           memcpy(out, in, sizeof(float[4]) * width);
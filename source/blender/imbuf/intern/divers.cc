@@ -7,11 +7,13 @@
  */
 
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_utildefines.h"
 
 #include "IMB_filter.hh"
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
+#include "IMB_pixel_convert.hh"
 #include "imbuf.hh"
 
 #include "IMB_colormanagement.hh"
@@ -44,6 +46,198 @@ static void clear_dither_context(DitherContext *di)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Pixel Row Conversion
+ *
+ * The SIMD code paths convert one RGBA pixel per vector, and give the same results as the
+ * scalar functions from `BLI_math_color.h`.
+ * \{ */
+
+#if BLI_HAVE_SSE2
+
+MALWAYS_INLINE __m128 imb_blend_sse(const __m128 mask, const __m128 a, const __m128 b)
+{
+#  if BLI_HAVE_SSE4
+  return _mm_blendv_ps(b, a, mask);
+#  else
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#  endif
+}
+
+MALWAYS_INLINE __m128 imb_alpha_lane_mask_sse()
+{
+  return _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+}
+
+MALWAYS_INLINE __m128 imb_premul_to_straight_sse(const __m128 premul)
+{
+  const __m128 alpha = _mm_shuffle_ps(premul, premul, _MM_SHUFFLE(3, 3, 3, 3));
+  const __m128 straight = _mm_mul_ps(premul, _mm_div_ps(_mm_set1_ps(1.0f), alpha));
+  /* Keep the pixel unchanged when alpha is zero, and always keep alpha itself. */
+  const __m128 keep = _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), imb_alpha_lane_mask_sse());
+  return imb_blend_sse(keep, premul, straight);
+}
+
+/* Pixel values as integers in the 0..255 range, with the same rounding as
+ * #unit_float_to_uchar_clamp. NaN values become zero. */
+MALWAYS_INLINE __m128i imb_unit_float_to_int_sse(const __m128 pixel)
+{
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(pixel, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+
+MALWAYS_INLINE void imb_store_byte_pixels_sse(uchar *to,
+                                              const __m128i p0,
+                                              const __m128i p1,
+                                              const __m128i p2,
+                                              const __m128i p3)
+{
+  const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+  _mm_storeu_si128((__m128i *)to, packed);
+}
+
+MALWAYS_INLINE void imb_store_byte_pixel_sse(uchar *to, const __m128i p)
+{
+  const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p, p), _mm_packs_epi32(p, p));
+  const int value = _mm_cvtsi128_si32(packed);
+  memcpy(to, &value, sizeof(value));
+}
+
+#endif /* BLI_HAVE_SSE2 */
+
+void imb_pixels_rgba_byte_to_float(float *to, const uchar *from, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= pixels_num; i += 4, from += 16, to += 16) {
+    const __m128i bytes = _mm_loadu_si128((const __m128i *)from);
+    const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+    _mm_storeu_ps(to + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+    _mm_storeu_ps(to + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+    _mm_storeu_ps(to + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+    _mm_storeu_ps(to + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+  }
+#endif
+  for (; i < pixels_num; i++, from += 4, to += 4) {
+    rgba_uchar_to_float(to, from);
+  }
+}
+
+void imb_pixels_rgba_float_to_byte(uchar *to,
+                                   const float *from,
+                                   const int64_t pixels_num,
+                                   const bool predivide)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  if (predivide) {
+    for (; i + 4 <= pixels_num; i += 4, from += 16, to += 16) {
+      imb_store_byte_pixels_sse(
+          to,
+          imb_unit_float_to_int_sse(imb_premul_to_straight_sse(_mm_loadu_ps(from + 0))),
+          imb_unit_float_to_int_sse(imb_premul_to_straight_sse(_mm_loadu_ps(from + 4))),
+          imb_unit_float_to_int_sse(imb_premul_to_straight_sse(_mm_loadu_ps(from + 8))),
+          imb_unit_float_to_int_sse(imb_premul_to_straight_sse(_mm_loadu_ps(from + 12))));
+    }
+  }
+  else {
+    for (; i + 4 <= pixels_num; i += 4, from += 16, to += 16) {
+      imb_store_byte_pixels_sse(to,
+                                imb_unit_float_to_int_sse(_mm_loadu_ps(from + 0)),
+                                imb_unit_float_to_int_sse(_mm_loadu_ps(from + 4)),
+                                imb_unit_float_to_int_sse(_mm_loadu_ps(from + 8)),
+                                imb_unit_float_to_int_sse(_mm_loadu_ps(from + 12)));
+    }
+  }
+#endif
+  for (; i < pixels_num; i++, from += 4, to += 4) {
+    if (predivide) {
+      float straight[4];
+      premul_to_straight_v4_v4(straight, from);
+      rgba_float_to_uchar(to, straight);
+    }
+    else {
+      rgba_float_to_uchar(to, from);
+    }
+  }
+}
+
+void imb_pixels_rgba_float_to_byte_dither(uchar *to,
+                                          const float *from,
+                                          const int64_t pixels_num,
+                                          const bool predivide,
+                                          const float dither,
+                                          const float s,
+                                          const float s_step,
+                                          const float t)
+{
+#if BLI_HAVE_SSE2
+  /* The noise itself is computed per pixel, the conversion is vectorized. */
+  const __m128 color_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  for (int64_t i = 0; i < pixels_num; i++, from += 4, to += 4) {
+    __m128 pixel = _mm_loadu_ps(from);
+    if (predivide) {
+      pixel = imb_premul_to_straight_sse(pixel);
+    }
+    const float dither_value = dither_random_value(s + float(i) * s_step, t) * 0.0033f *
+                               dither;
+    pixel = _mm_add_ps(pixel, _mm_and_ps(_mm_set1_ps(dither_value), color_mask));
+    imb_store_byte_pixel_sse(to, imb_unit_float_to_int_sse(pixel));
+  }
+#else
+  for (int64_t i = 0; i < pixels_num; i++, from += 4, to += 4) {
+    float straight[4];
+    if (predivide) {
+      premul_to_straight_v4_v4(straight, from);
+    }
+    else {
+      copy_v4_v4(straight, from);
+    }
+    const float dither_value = dither_random_value(s + float(i) * s_step, t) * 0.0033f *
+                               dither;
+    to[0] = unit_float_to_uchar_clamp(dither_value + straight[0]);
+    to[1] = unit_float_to_uchar_clamp(dither_value + straight[1]);
+    to[2] = unit_float_to_uchar_clamp(dither_value + straight[2]);
+    to[3] = unit_float_to_uchar_clamp(straight[3]);
+  }
+#endif
+}
+
+void imb_pixels_rgba_premultiply(float *pixels, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 alpha_mask = imb_alpha_lane_mask_sse();
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (; i < pixels_num; i++, pixels += 4) {
+    const __m128 pixel = _mm_loadu_ps(pixels);
+    const __m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+    _mm_storeu_ps(pixels, _mm_mul_ps(pixel, imb_blend_sse(alpha_mask, one, alpha)));
+  }
+#endif
+  for (; i < pixels_num; i++, pixels += 4) {
+    straight_to_premul_v4(pixels);
+  }
+}
+
+void imb_pixels_rgba_unpremultiply(float *to, const float *from, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  for (; i < pixels_num; i++, from += 4, to += 4) {
+    _mm_storeu_ps(to, imb_premul_to_straight_sse(_mm_loadu_ps(from)));
+  }
+#endif
+  for (; i < pixels_num; i++, from += 4, to += 4) {
+    premul_to_straight_v4_v4(to, from);
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Generic Buffer Conversion
  * \{ */
@@ -164,30 +358,13 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
       uchar *to = rect_to + size_t(stride_to) * y * 4;
 
       if (profile_to == profile_from) {
-        float straight[4];
-
         /* no color space conversion */
-        if (dither && predivide) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            premul_to_straight_v4_v4(straight, from);
-            float_to_byte_dither_v4(to, straight, di, float(x) * inv_width, t);
-          }
-        }
-        else if (dither) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            float_to_byte_dither_v4(to, from, di, float(x) * inv_width, t);
-          }
-        }
-        else if (predivide) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            premul_to_straight_v4_v4(straight, from);
-            rgba_float_to_uchar(to, straight);
-          }
+        if (dither) {
+          imb_pixels_rgba_float_to_byte_dither(
+              to, from, width, predivide, di->dither, 0.0f, inv_width, t);
         }
         else {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            rgba_float_to_uchar(to, from);
-          }
+          imb_pixels_rgba_float_to_byte(to, from, width, predivide);
         }
       }
       else if (profile_to == IB_PROFILE_SRGB) {
@@ -371,9 +548,7 @@ void IMB_buffer_float_from_byte(float *rect_to,
 
     if (profile_to == profile_from) {
       /* no color space conversion */
-      for (x = 0; x < width; x++, from += 4, to += 4) {
-        rgba_uchar_to_float(to, from);
-      }
+      imb_pixels_rgba_byte_to_float(to, from, width);
     }
     else if (profile_to == IB_PROFILE_LINEAR_RGB) {
       /* convert sRGB to linear */
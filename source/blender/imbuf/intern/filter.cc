@@ -11,11 +11,14 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math_base.h"
+#include "BLI_rect.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "IMB_filter.hh"
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
+#include "IMB_pixel_convert.hh"
 
 #include "imbuf.hh"
 
@@ -101,6 +104,7 @@ void IMB_filtery(ImBuf *ibuf)
 
 static void imb_filterN(ImBuf *out, ImBuf *in)
 {
+  using namespace blender;
   BLI_assert(out->channels == in->channels);
   BLI_assert(out->x == in->x && out->y == in->y);
 
@@ -108,111 +112,115 @@ static void imb_filterN(ImBuf *out, ImBuf *in)
   const int rowlen = in->x;
 
   if (in->byte_buffer.data && out->byte_buffer.data) {
-    for (int y = 0; y < in->y; y++) {
-      /* setup rows */
-      const char *row2 = (const char *)in->byte_buffer.data + y * channels * rowlen;
-      const char *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
-      const char *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
-
-      char *cp = (char *)out->byte_buffer.data + y * channels * rowlen;
-
-      for (int x = 0; x < rowlen; x++) {
-        const char *r11, *r13, *r21, *r23, *r31, *r33;
+    threading::parallel_for(IndexRange(in->y), 64, [&](const IndexRange y_range) {
+      for (const int y : y_range) {
+        /* setup rows */
+        const char *row2 = (const char *)in->byte_buffer.data + y * channels * rowlen;
+        const char *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
+        const char *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
+
+        char *cp = (char *)out->byte_buffer.data + y * channels * rowlen;
+
+        for (int x = 0; x < rowlen; x++) {
+          const char *r11, *r13, *r21, *r23, *r31, *r33;
+
+          if (x == 0) {
+            r11 = row1;
+            r21 = row2;
+            r31 = row3;
+          }
+          else {
+            r11 = row1 - channels;
+            r21 = row2 - channels;
+            r31 = row3 - channels;
+          }
 
-        if (x == 0) {
-          r11 = row1;
-          r21 = row2;
-          r31 = row3;
-        }
-        else {
-          r11 = row1 - channels;
-          r21 = row2 - channels;
-          r31 = row3 - channels;
-        }
+          if (x == rowlen - 1) {
+            r13 = row1;
+            r23 = row2;
+            r33 = row3;
+          }
+          else {
+            r13 = row1 + channels;
+            r23 = row2 + channels;
+            r33 = row3 + channels;
+          }
 
-        if (x == rowlen - 1) {
-          r13 = row1;
-          r23 = row2;
-          r33 = row3;
-        }
-        else {
-          r13 = row1 + channels;
-          r23 = row2 + channels;
-          r33 = row3 + channels;
+          cp[0] = (r11[0] + 2 * row1[0] + r13[0] + 2 * r21[0] + 4 * row2[0] + 2 * r23[0] + r31[0] +
+                   2 * row3[0] + r33[0]) >>
+                  4;
+          cp[1] = (r11[1] + 2 * row1[1] + r13[1] + 2 * r21[1] + 4 * row2[1] + 2 * r23[1] + r31[1] +
+                   2 * row3[1] + r33[1]) >>
+                  4;
+          cp[2] = (r11[2] + 2 * row1[2] + r13[2] + 2 * r21[2] + 4 * row2[2] + 2 * r23[2] + r31[2] +
+                   2 * row3[2] + r33[2]) >>
+                  4;
+          cp[3] = (r11[3] + 2 * row1[3] + r13[3] + 2 * r21[3] + 4 * row2[3] + 2 * r23[3] + r31[3] +
+                   2 * row3[3] + r33[3]) >>
+                  4;
+          cp += channels;
+          row1 += channels;
+          row2 += channels;
+          row3 += channels;
         }
-
-        cp[0] = (r11[0] + 2 * row1[0] + r13[0] + 2 * r21[0] + 4 * row2[0] + 2 * r23[0] + r31[0] +
-                 2 * row3[0] + r33[0]) >>
-                4;
-        cp[1] = (r11[1] + 2 * row1[1] + r13[1] + 2 * r21[1] + 4 * row2[1] + 2 * r23[1] + r31[1] +
-                 2 * row3[1] + r33[1]) >>
-                4;
-        cp[2] = (r11[2] + 2 * row1[2] + r13[2] + 2 * r21[2] + 4 * row2[2] + 2 * r23[2] + r31[2] +
-                 2 * row3[2] + r33[2]) >>
-                4;
-        cp[3] = (r11[3] + 2 * row1[3] + r13[3] + 2 * r21[3] + 4 * row2[3] + 2 * r23[3] + r31[3] +
-                 2 * row3[3] + r33[3]) >>
-                4;
-        cp += channels;
-        row1 += channels;
-        row2 += channels;
-        row3 += channels;
       }
-    }
+    });
   }
 
   if (in->float_buffer.data && out->float_buffer.data) {
-    for (int y = 0; y < in->y; y++) {
-      /* setup rows */
-      const float *row2 = (const float *)in->float_buffer.data + y * channels * rowlen;
-      const float *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
-      const float *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
-
-      float *cp = (float *)out->float_buffer.data + y * channels * rowlen;
-
-      for (int x = 0; x < rowlen; x++) {
-        const float *r11, *r13, *r21, *r23, *r31, *r33;
+    threading::parallel_for(IndexRange(in->y), 64, [&](const IndexRange y_range) {
+      for (const int y : y_range) {
+        /* setup rows */
+        const float *row2 = (const float *)in->float_buffer.data + y * channels * rowlen;
+        const float *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
+        const float *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
+
+        float *cp = (float *)out->float_buffer.data + y * channels * rowlen;
+
+        for (int x = 0; x < rowlen; x++) {
+          const float *r11, *r13, *r21, *r23, *r31, *r33;
+
+          if (x == 0) {
+            r11 = row1;
+            r21 = row2;
+            r31 = row3;
+          }
+          else {
+            r11 = row1 - channels;
+            r21 = row2 - channels;
+            r31 = row3 - channels;
+          }
 
-        if (x == 0) {
-          r11 = row1;
-          r21 = row2;
-          r31 = row3;
-        }
-        else {
-          r11 = row1 - channels;
-          r21 = row2 - channels;
-          r31 = row3 - channels;
-        }
+          if (x == rowlen - 1) {
+            r13 = row1;
+            r23 = row2;
+            r33 = row3;
+          }
+          else {
+            r13 = row1 + channels;
+            r23 = row2 + channels;
+            r33 = row3 + channels;
+          }
 
-        if (x == rowlen - 1) {
-          r13 = row1;
-          r23 = row2;
-          r33 = row3;
+          cp[0] = (r11[0] + 2 * row1[0] + r13[0] + 2 * r21[0] + 4 * row2[0] + 2 * r23[0] + r31[0] +
+                   2 * row3[0] + r33[0]) *
+                  (1.0f / 16.0f);
+          cp[1] = (r11[1] + 2 * row1[1] + r13[1] + 2 * r21[1] + 4 * row2[1] + 2 * r23[1] + r31[1] +
+                   2 * row3[1] + r33[1]) *
+                  (1.0f / 16.0f);
+          cp[2] = (r11[2] + 2 * row1[2] + r13[2] + 2 * r21[2] + 4 * row2[2] + 2 * r23[2] + r31[2] +
+                   2 * row3[2] + r33[2]) *
+                  (1.0f / 16.0f);
+          cp[3] = (r11[3] + 2 * row1[3] + r13[3] + 2 * r21[3] + 4 * row2[3] + 2 * r23[3] + r31[3] +
+                   2 * row3[3] + r33[3]) *
+                  (1.0f / 16.0f);
+          cp += channels;
+          row1 += channels;
+          row2 += channels;
+          row3 += channels;
         }
-        else {
-          r13 = row1 + channels;
-          r23 = row2 + channels;
-          r33 = row3 + channels;
-        }
-
-        cp[0] = (r11[0] + 2 * row1[0] + r13[0] + 2 * r21[0] + 4 * row2[0] + 2 * r23[0] + r31[0] +
-                 2 * row3[0] + r33[0]) *
-                (1.0f / 16.0f);
-        cp[1] = (r11[1] + 2 * row1[1] + r13[1] + 2 * r21[1] + 4 * row2[1] + 2 * r23[1] + r31[1] +
-                 2 * row3[1] + r33[1]) *
-                (1.0f / 16.0f);
-        cp[2] = (r11[2] + 2 * row1[2] + r13[2] + 2 * r21[2] + 4 * row2[2] + 2 * r23[2] + r31[2] +
-                 2 * row3[2] + r33[2]) *
-                (1.0f / 16.0f);
-        cp[3] = (r11[3] + 2 * row1[3] + r13[3] + 2 * r21[3] + 4 * row2[3] + 2 * r23[3] + r31[3] +
-                 2 * row3[3] + r33[3]) *
-                (1.0f / 16.0f);
-        cp += channels;
-        row1 += channels;
-        row2 += channels;
-        row3 += channels;
       }
-    }
+    });
   }
 }
 
@@ -451,11 +459,28 @@ void IMB_filter_extend(ImBuf *ibuf, char *mask, int filter)
   }
 }
 
+void IMB_mipmap_invalidate_region(ImBuf *ibuf, const rcti *region)
+{
+  if (ibuf->userflags & IB_MIPMAP_INVALID_REGION) {
+    BLI_rcti_union(&ibuf->mipmap_invalid_rect, region);
+  }
+  else {
+    ibuf->mipmap_invalid_rect = *region;
+    ibuf->userflags |= IB_MIPMAP_INVALID_REGION;
+  }
+}
+
 void IMB_remakemipmap(ImBuf *ibuf, int use_filter)
 {
   ImBuf *hbuf = ibuf;
   int curmap = 0;
 
+  /* When only a region was changed, recreate only the pixels depending on it. The filter reads
+   * neighboring pixels, in that case the levels are always recreated entirely. */
+  const bool use_region = !use_filter && (ibuf->userflags & IB_MIPMAP_INVALID_REGION) &&
+                          !(ibuf->userflags & IB_MIPMAP_INVALID);
+  rcti region = ibuf->mipmap_invalid_rect;
+
   ibuf->miptot = 1;
 
   while (curmap < IMB_MIPMAP_LEVELS) {
@@ -468,6 +493,14 @@ void IMB_remakemipmap(ImBuf *ibuf, int use_filter)
         imb_onehalf_no_alloc(ibuf->mipmap[curmap], nbuf);
         IMB_freeImBuf(nbuf);
       }
+      else if (use_region) {
+        /* Every pixel of the next level is the average of a 2x2 block. */
+        region.xmin /= 2;
+        region.ymin /= 2;
+        region.xmax = (region.xmax + 1) / 2;
+        region.ymax = (region.ymax + 1) / 2;
+        imb_onehalf_region_no_alloc(ibuf->mipmap[curmap], hbuf, &region);
+      }
       else {
         imb_onehalf_no_alloc(ibuf->mipmap[curmap], hbuf);
       }
@@ -493,6 +526,8 @@ void IMB_makemipmap(ImBuf *ibuf, int use_filter)
   int curmap = 0;
 
   imb_freemipmapImBuf(ibuf);
+  /* All levels are created from scratch, a pending partial update no longer applies. */
+  ibuf->userflags &= ~IB_MIPMAP_INVALID_REGION;
 
   /* no mipmap for non RGBA images */
   if (ibuf->float_buffer.data && ibuf->channels < 4) {
@@ -560,19 +595,8 @@ void IMB_premultiply_rect(uint8_t *rect, char planes, int w, int h)
 
 void IMB_premultiply_rect_float(float *rect_float, int channels, int w, int h)
 {
-  float val, *cp;
-  int x, y;
-
   if (channels == 4) {
-    cp = rect_float;
-    for (y = 0; y < h; y++) {
-      for (x = 0; x < w; x++, cp += 4) {
-        val = cp[3];
-        cp[0] = cp[0] * val;
-        cp[1] = cp[1] * val;
-        cp[2] = cp[2] * val;
-      }
-    }
+    imb_pixels_rgba_premultiply(rect_float, int64_t(w) * h);
   }
 }
 
@@ -622,19 +646,8 @@ void IMB_unpremultiply_rect(uint8_t *rect, char planes, int w, int h)
 
 void IMB_unpremultiply_rect_float(float *rect_float, int channels, int w, int h)
 {
-  float val, *fp;
-  int x, y;
-
   if (channels == 4) {
-    fp = rect_float;
-    for (y = 0; y < h; y++) {
-      for (x = 0; x < w; x++, fp += 4) {
-        val = fp[3] != 0.0f ? 1.0f / fp[3] : 1.0f;
-        fp[0] = fp[0] * val;
-        fp[1] = fp[1] * val;
-        fp[2] = fp[2] * val;
-      }
-    }
+    imb_pixels_rgba_unpremultiply(rect_float, rect_float, int64_t(w) * h);
   }
 }
 
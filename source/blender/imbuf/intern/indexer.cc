@@ -19,6 +19,7 @@
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
@@ -464,6 +465,8 @@ struct proxy_output_ctx {
   IMB_Proxy_Size proxy_size;
   int orig_height;
   ImBufAnim *anim;
+  /** Decoded frame waiting to be scaled and encoded by the proxy task. */
+  AVFrame *input_frame;
 };
 
 static proxy_output_ctx *alloc_proxy_output_ffmpeg(
@@ -804,6 +807,9 @@ struct FFmpegIndexBuilderContext : public IndexBuildContext {
 
   bool build_only_on_bad_performance;
   bool building_cancelled;
+
+  /** Scales and encodes the proxies of a frame while the next frame is decoded. */
+  TaskPool *proxy_pool;
 };
 
 static IndexBuildContext *index_ffmpeg_create_context(ImBufAnim *anim,
@@ -955,6 +961,38 @@ static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, cons
   MEM_freeN(context);
 }
 
+static void index_rebuild_ffmpeg_proxy_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  proxy_output_ctx *ctx = static_cast<proxy_output_ctx *>(taskdata);
+  add_to_proxy_output_ffmpeg(ctx, ctx->input_frame);
+  av_frame_free(&ctx->input_frame);
+}
+
+/**
+ * Add the decoded frame to all proxies. Every proxy size is scaled and encoded in its own task,
+ * and the tasks keep running while the next frame is decoded.
+ */
+static void index_rebuild_ffmpeg_proxy_frame(FFmpegIndexBuilderContext *context,
+                                             AVFrame *in_frame)
+{
+  /* Frames must be encoded in order, so wait for the tasks of the previous frame. */
+  BLI_task_pool_work_and_wait(context->proxy_pool);
+
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    proxy_output_ctx *ctx = context->proxy_ctx[i];
+    if (ctx == nullptr) {
+      continue;
+    }
+    /* The decoder reuses its frame, the task gets its own reference to the frame data. */
+    ctx->input_frame = av_frame_clone(in_frame);
+    if (ctx->input_frame == nullptr) {
+      add_to_proxy_output_ffmpeg(ctx, in_frame);
+      continue;
+    }
+    BLI_task_pool_push(context->proxy_pool, index_rebuild_ffmpeg_proxy_task, ctx, false, nullptr);
+  }
+}
+
 static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *context,
                                                     AVPacket *curr_packet,
                                                     AVFrame *in_frame)
@@ -965,9 +1003,7 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
   uint64_t s_dts = context->seek_pos_dts;
   uint64_t pts = av_get_pts_from_frame(in_frame);
 
-  for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
-  }
+  index_rebuild_ffmpeg_proxy_frame(context, in_frame);
 
   if (!context->start_pts_set) {
     context->start_pts = pts;
@@ -1025,6 +1061,7 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
   context->frame_rate = av_q2d(
       av_guess_frame_rate(context->iFormatCtx, context->iStream, nullptr));
   context->pts_time_base = av_q2d(context->iStream->time_base);
+  context->proxy_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
 
   while (av_read_frame(context->iFormatCtx, next_packet) >= 0) {
     float next_progress =
@@ -1096,6 +1133,10 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
     }
   }
 
+  BLI_task_pool_work_and_wait(context->proxy_pool);
+  BLI_task_pool_free(context->proxy_pool);
+  context->proxy_pool = nullptr;
+
   av_packet_free(&next_packet);
   av_free(in_frame);
 
@@ -378,7 +378,9 @@ bool IMB_moviecache_put_if_possible(MovieCache *cache, void *userkey, ImBuf *ibu
   mem_limit = MEM_CacheLimiter_get_maximum();
 
   limitor_lock.lock();
-  mem_in_use = MEM_CacheLimiter_get_memory_in_use(limitor);
+  /* Decoded movie frames share the cache memory budget. */
+  mem_in_use = MEM_CacheLimiter_get_memory_in_use(limitor) +
+               IMB_anim_decoded_frames_memory_in_use();
 
   if (mem_in_use + elem_size <= mem_limit) {
     do_moviecache_put(cache, userkey, ibuf, false);
@@ -79,7 +79,9 @@
 #include "BLI_fileops.h"
 #include "BLI_math_color.h"
 #include "BLI_mmap.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_idprop.hh"
 #include "BKE_image.h"
@@ -1155,14 +1157,13 @@ void IMB_exr_write_channels(void *handle)
       current_rect_half = rect_half;
     }
 
+    /* Channels converted to half float, with the buffer each one is converted into. */
+    blender::Vector<std::pair<const ExrChannel *, half *>> half_channels;
+
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
       /* Writing starts from last scan-line, stride negative. */
       if (echan->use_half_float) {
-        float *rect = echan->rect;
-        half *cur = current_rect_half;
-        for (size_t i = 0; i < num_pixels; i++, cur++) {
-          *cur = float_to_half_safe(rect[i * echan->xstride]);
-        }
+        half_channels.append({echan, current_rect_half});
         half *rect_to_write = current_rect_half + (data->height - 1L) * data->width;
         frameBuffer.insert(
             echan->name,
@@ -1179,6 +1180,18 @@ void IMB_exr_write_channels(void *handle)
       }
     }
 
+    /* With many passes the conversion takes as long as the compression, which OpenEXR already
+     * spreads over its thread pool. */
+    blender::threading::parallel_for(
+        blender::IndexRange(num_pixels), 64 * 1024, [&](const blender::IndexRange range) {
+          for (const auto &[echan, rect_half] : half_channels) {
+            const float *rect = echan->rect;
+            for (const int64_t i : range) {
+              rect_half[i] = float_to_half_safe(rect[i * echan->xstride]);
+            }
+          }
+        });
+
     data->ofile->setFrameBuffer(frameBuffer);
     try {
       data->ofile->writePixels(data->height);
@@ -1278,6 +1291,7 @@ void IMB_exr_read_channels(void *handle)
 
     /* Insert all matching channel into frame-buffer. */
     FrameBuffer frameBuffer;
+    bool has_channels = false;
 
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
       if (echan->m->part_number != i) {
@@ -1309,9 +1323,16 @@ void IMB_exr_read_channels(void *handle)
 
         frameBuffer.insert(echan->m->internal_name,
                            Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+        has_channels = true;
       }
     }
 
+    /* Parts are compressed separately, so parts without any requested channel (for example other
+     * views or layers written as parts by other applications) don't have to be decompressed. */
+    if (!has_channels) {
+      continue;
+    }
+
     /* Read pixels. */
     try {
       in.setFrameBuffer(frameBuffer);
@@ -2367,6 +2388,8 @@ void imb_initopenexr()
   /* In a multithreaded program, staticInitialize() must be called once during startup, before the
    * program accesses any other functions or classes in the IlmImf library. */
   Imf::staticInitialize();
+  /* The pool compresses and decompresses chunks of scan-lines or tiles. Its size follows the
+   * `--threads` argument, which is parsed before image buffers are initialized. */
   Imf::setGlobalThreadCount(BLI_system_thread_count());
 }
 
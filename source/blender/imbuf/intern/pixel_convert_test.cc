@@ -0,0 +1,151 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_color.h"
+#include "BLI_math_vector.h"
+
+#include "IMB_pixel_convert.hh"
+
+namespace blender::imbuf::tests {
+
+/* Widths that are not a multiple of the SIMD width, so both the vector and the remainder loops
+ * are used. */
+static const int64_t test_widths[] = {1, 3, 4, 5, 7, 13, 31};
+
+/* Float pixels covering zero and one alpha, partial alpha and out of range values. */
+static Array<float> create_float_pixels(const int64_t pixels_num)
+{
+  static const float values[] = {0.0f, 1.0f, 0.5f, 0.25f, 0.999f, 1.5f, -0.25f, 0.0031f};
+  static const float alphas[] = {0.0f, 1.0f, 0.5f, 0.0f, 1.0f, 0.75f, 0.1f};
+  Array<float> pixels(pixels_num * 4);
+  for (int64_t i = 0; i < pixels_num; i++) {
+    pixels[i * 4 + 0] = values[i % 8];
+    pixels[i * 4 + 1] = values[(i + 3) % 8];
+    pixels[i * 4 + 2] = values[(i + 5) % 8];
+    pixels[i * 4 + 3] = alphas[i % 7];
+  }
+  return pixels;
+}
+
+TEST(imbuf_pixel_convert, byte_to_float)
+{
+  for (const int64_t width : test_widths) {
+    Array<uchar> from(width * 4);
+    for (int64_t i = 0; i < from.size(); i++) {
+      from[i] = uchar((i * 97) & 0xff);
+    }
+    /* Zero and full alpha on the first pixel. */
+    from[3] = 0;
+    from[width * 4 - 1] = 255;
+
+    Array<float> result(width * 4);
+    imb_pixels_rgba_byte_to_float(result.data(), from.data(), width);
+    for (int64_t i = 0; i < width; i++) {
+      float expected[4];
+      rgba_uchar_to_float(expected, &from[i * 4]);
+      for (int c = 0; c < 4; c++) {
+        EXPECT_EQ(result[i * 4 + c], expected[c]);
+      }
+    }
+  }
+}
+
+TEST(imbuf_pixel_convert, float_to_byte)
+{
+  for (const bool predivide : {false, true}) {
+    for (const int64_t width : test_widths) {
+      const Array<float> from = create_float_pixels(width);
+      Array<uchar> result(width * 4);
+      imb_pixels_rgba_float_to_byte(result.data(), from.data(), width, predivide);
+      for (int64_t i = 0; i < width; i++) {
+        float straight[4];
+        if (predivide) {
+          premul_to_straight_v4_v4(straight, &from[i * 4]);
+        }
+        else {
+          copy_v4_v4(straight, &from[i * 4]);
+        }
+        uchar expected[4];
+        rgba_float_to_uchar(expected, straight);
+        for (int c = 0; c < 4; c++) {
+          EXPECT_EQ(result[i * 4 + c], expected[c]);
+        }
+      }
+    }
+  }
+}
+
+TEST(imbuf_pixel_convert, float_to_byte_dither)
+{
+  const float dither = 2.0f;
+  const float s_step = 1.0f / 37.0f;
+  const float t = 0.3f;
+  for (const bool predivide : {false, true}) {
+    for (const int64_t width : test_widths) {
+      const Array<float> from = create_float_pixels(width);
+      Array<uchar> result(width * 4);
+      imb_pixels_rgba_float_to_byte_dither(
+          result.data(), from.data(), width, predivide, dither, 0.0f, s_step, t);
+      for (int64_t i = 0; i < width; i++) {
+        float straight[4];
+        if (predivide) {
+          premul_to_straight_v4_v4(straight, &from[i * 4]);
+        }
+        else {
+          copy_v4_v4(straight, &from[i * 4]);
+        }
+        /* Same operation order as the per-pixel dithering in `divers.cc`. */
+        const float dither_value = dither_random_value(float(i) * s_step, t) * 0.0033f * dither;
+        EXPECT_EQ(result[i * 4 + 0], unit_float_to_uchar_clamp(dither_value + straight[0]));
+        EXPECT_EQ(result[i * 4 + 1], unit_float_to_uchar_clamp(dither_value + straight[1]));
+        EXPECT_EQ(result[i * 4 + 2], unit_float_to_uchar_clamp(dither_value + straight[2]));
+        EXPECT_EQ(result[i * 4 + 3], unit_float_to_uchar_clamp(straight[3]));
+      }
+    }
+  }
+}
+
+TEST(imbuf_pixel_convert, premultiply)
+{
+  for (const int64_t width : test_widths) {
+    const Array<float> from = create_float_pixels(width);
+    Array<float> result = from;
+    imb_pixels_rgba_premultiply(result.data(), width);
+    for (int64_t i = 0; i < width; i++) {
+      float expected[4];
+      straight_to_premul_v4_v4(expected, &from[i * 4]);
+      for (int c = 0; c < 4; c++) {
+        EXPECT_EQ(result[i * 4 + c], expected[c]);
+      }
+    }
+  }
+}
+
+TEST(imbuf_pixel_convert, unpremultiply)
+{
+  for (const int64_t width : test_widths) {
+    const Array<float> from = create_float_pixels(width);
+    Array<float> result(width * 4);
+    imb_pixels_rgba_unpremultiply(result.data(), from.data(), width);
+    for (int64_t i = 0; i < width; i++) {
+      float expected[4];
+      premul_to_straight_v4_v4(expected, &from[i * 4]);
+      for (int c = 0; c < 4; c++) {
+        EXPECT_EQ(result[i * 4 + c], expected[c]);
+      }
+    }
+
+    /* Converting in place gives the same result. */
+    Array<float> in_place = from;
+    imb_pixels_rgba_unpremultiply(in_place.data(), in_place.data(), width);
+    for (int64_t i = 0; i < in_place.size(); i++) {
+      EXPECT_EQ(in_place[i], result[i]);
+    }
+  }
+}
+
+}  // namespace blender::imbuf::tests
@@ -6,8 +6,15 @@
  * \ingroup imbuf
  */
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
+#include "BLI_array.hh"
+#include "BLI_math_base.h"
+#include "BLI_rect.h"
+#include "BLI_simd.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "MEM_guardedalloc.h"
 
@@ -225,35 +232,21 @@ MINLINE void premul_ushort_to_straight_uchar(uchar *result, const ushort color[4
   }
 }
 
-void imb_onehalf_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1)
+/** Average 2x2 blocks of \a ibuf1 into the pixels of \a ibuf2 in the given columns and rows. */
+static void imb_onehalf_block(ImBuf *ibuf2,
+                              const ImBuf *ibuf1,
+                              const blender::IndexRange x_range,
+                              const blender::IndexRange y_range,
+                              const bool do_rect,
+                              const bool do_float)
 {
-  int x, y;
-  const bool do_rect = (ibuf1->byte_buffer.data != nullptr);
-  const bool do_float = (ibuf1->float_buffer.data != nullptr) &&
-                        (ibuf2->float_buffer.data != nullptr);
-
-  if (do_rect && (ibuf2->byte_buffer.data == nullptr)) {
-    imb_addrectImBuf(ibuf2);
-  }
-
-  if (ibuf1->x <= 1) {
-    imb_half_y_no_alloc(ibuf2, ibuf1);
-    return;
-  }
-  if (ibuf1->y <= 1) {
-    imb_half_x_no_alloc(ibuf2, ibuf1);
-    return;
-  }
-
-  if (do_rect) {
-    uchar *cp1, *cp2, *dest;
-
-    cp1 = ibuf1->byte_buffer.data;
-    dest = ibuf2->byte_buffer.data;
+  for (const int64_t y : y_range) {
+    if (do_rect) {
+      const uchar *cp1 = ibuf1->byte_buffer.data + (2 * y * ibuf1->x + 2 * x_range.start()) * 4;
+      const uchar *cp2 = cp1 + (ibuf1->x << 2);
+      uchar *dest = ibuf2->byte_buffer.data + (y * ibuf2->x + x_range.start()) * 4;
 
-    for (y = ibuf2->y; y > 0; y--) {
-      cp2 = cp1 + (ibuf1->x << 2);
-      for (x = ibuf2->x; x > 0; x--) {
+      for (int64_t x = x_range.size(); x > 0; x--) {
         ushort p1i[8], p2i[8], desti[4];
 
         straight_uchar_to_premul_ushort(p1i, cp1);
@@ -272,21 +265,14 @@ void imb_onehalf_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1)
         cp2 += 8;
         dest += 4;
       }
-      cp1 = cp2;
-      if (ibuf1->x & 1) {
-        cp1 += 4;
-      }
     }
-  }
 
-  if (do_float) {
-    float *p1f, *p2f, *destf;
+    if (do_float) {
+      const float *p1f = ibuf1->float_buffer.data + (2 * y * ibuf1->x + 2 * x_range.start()) * 4;
+      const float *p2f = p1f + (ibuf1->x << 2);
+      float *destf = ibuf2->float_buffer.data + (y * ibuf2->x + x_range.start()) * 4;
 
-    p1f = ibuf1->float_buffer.data;
-    destf = ibuf2->float_buffer.data;
-    for (y = ibuf2->y; y > 0; y--) {
-      p2f = p1f + (ibuf1->x << 2);
-      for (x = ibuf2->x; x > 0; x--) {
+      for (int64_t x = x_range.size(); x > 0; x--) {
         destf[0] = 0.25f * (p1f[0] + p2f[0] + p1f[4] + p2f[4]);
         destf[1] = 0.25f * (p1f[1] + p2f[1] + p1f[5] + p2f[5]);
         destf[2] = 0.25f * (p1f[2] + p2f[2] + p1f[6] + p2f[6]);
@@ -295,14 +281,52 @@ void imb_onehalf_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1)
         p2f += 8;
         destf += 4;
       }
-      p1f = p2f;
-      if (ibuf1->x & 1) {
-        p1f += 4;
-      }
     }
   }
 }
 
+void imb_onehalf_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1)
+{
+  rcti region;
+  BLI_rcti_init(&region, 0, ibuf2->x, 0, ibuf2->y);
+  imb_onehalf_region_no_alloc(ibuf2, ibuf1, &region);
+}
+
+void imb_onehalf_region_no_alloc(ImBuf *ibuf2, ImBuf *ibuf1, const rcti *region)
+{
+  using namespace blender;
+  const bool do_rect = (ibuf1->byte_buffer.data != nullptr);
+  const bool do_float = (ibuf1->float_buffer.data != nullptr) &&
+                        (ibuf2->float_buffer.data != nullptr);
+
+  if (do_rect && (ibuf2->byte_buffer.data == nullptr)) {
+    imb_addrectImBuf(ibuf2);
+  }
+
+  if (ibuf1->x <= 1) {
+    imb_half_y_no_alloc(ibuf2, ibuf1);
+    return;
+  }
+  if (ibuf1->y <= 1) {
+    imb_half_x_no_alloc(ibuf2, ibuf1);
+    return;
+  }
+
+  const int xmin = std::max(region->xmin, 0);
+  const int xmax = std::min(region->xmax, ibuf2->x);
+  const int ymin = std::max(region->ymin, 0);
+  const int ymax = std::min(region->ymax, ibuf2->y);
+  if (xmin >= xmax || ymin >= ymax) {
+    return;
+  }
+  const IndexRange x_range = IndexRange::from_begin_end(xmin, xmax);
+  const IndexRange y_range = IndexRange::from_begin_end(ymin, ymax);
+
+  threading::parallel_for(y_range, 32, [&](const IndexRange y_range_chunk) {
+    imb_onehalf_block(ibuf2, ibuf1, x_range, y_range_chunk, do_rect, do_float);
+  });
+}
+
 ImBuf *IMB_onehalf(ImBuf *ibuf1)
 {
   ImBuf *ibuf2;
@@ -1574,116 +1598,419 @@ bool IMB_scalefastImBuf(ImBuf *ibuf, uint newx, uint newy)
 
 /* ******** threaded scaling ******** */
 
-struct ScaleTreadInitData {
-  ImBuf *ibuf;
+void IMB_scaleImBuf_threaded(ImBuf *ibuf, uint newx, uint newy)
+{
+  using namespace blender;
+  using namespace blender::imbuf;
+  BLI_assert_msg(newx > 0 && newy > 0, "Images must be at least 1 on both dimensions!");
 
-  uint newx;
-  uint newy;
+  uchar *byte_buffer = nullptr;
+  float *float_buffer = nullptr;
 
-  uchar *byte_buffer;
-  float *float_buffer;
-};
+  if (ibuf->byte_buffer.data) {
+    byte_buffer = static_cast<uchar *>(
+        MEM_mallocN(4 * newx * newy * sizeof(char), "threaded scale byte buffer"));
+  }
 
-struct ScaleThreadData {
-  ImBuf *ibuf;
+  if (ibuf->float_buffer.data) {
+    float_buffer = static_cast<float *>(
+        MEM_mallocN(ibuf->channels * newx * newy * sizeof(float), "threaded scale float buffer"));
+  }
 
-  uint newx;
-  uint newy;
+  const float factor_x = float(ibuf->x) / newx;
+  const float factor_y = float(ibuf->y) / newy;
 
-  int start_line;
-  int tot_line;
+  threading::parallel_for(IndexRange(newy), 32, [&](const IndexRange y_range) {
+    for (const int y : y_range) {
+      for (int x = 0; x < newx; x++) {
+        float u = float(x) * factor_x;
+        float v = float(y) * factor_y;
+        int offset = y * newx + x;
 
-  uchar *byte_buffer;
-  float *float_buffer;
-};
+        if (byte_buffer) {
+          interpolate_bilinear_border_byte(ibuf, byte_buffer + 4 * offset, u, v);
+        }
 
-static void scale_thread_init(void *data_v, int start_line, int tot_line, void *init_data_v)
-{
-  ScaleThreadData *data = (ScaleThreadData *)data_v;
-  ScaleTreadInitData *init_data = (ScaleTreadInitData *)init_data_v;
+        if (float_buffer) {
+          float *pixel = float_buffer + ibuf->channels * offset;
+          math::interpolate_bilinear_border_fl(
+              ibuf->float_buffer.data, pixel, ibuf->x, ibuf->y, ibuf->channels, u, v);
+        }
+      }
+    }
+  });
 
-  data->ibuf = init_data->ibuf;
+  /* alter image buffer */
+  ibuf->x = newx;
+  ibuf->y = newy;
 
-  data->newx = init_data->newx;
-  data->newy = init_data->newy;
+  if (ibuf->byte_buffer.data) {
+    imb_freerectImBuf(ibuf);
+    IMB_assign_byte_buffer(ibuf, byte_buffer, IB_TAKE_OWNERSHIP);
+  }
 
-  data->start_line = start_line;
-  data->tot_line = tot_line;
+  if (ibuf->float_buffer.data) {
+    imb_freerectfloatImBuf(ibuf);
+    IMB_assign_float_buffer(ibuf, float_buffer, IB_TAKE_OWNERSHIP);
+  }
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Filtered Scaling
+ *
+ * Separable resampling: the rows are scaled horizontally into a temporary float buffer, which is
+ * then scaled vertically into the destination. The source pixels and filter weights used for
+ * every destination column and row are computed once up front, so the inner loops are only
+ * weighted sums over pixels. Byte pixels keep their 0..255 range in the temporary buffer.
+ * \{ */
 
-  data->byte_buffer = init_data->byte_buffer;
-  data->float_buffer = init_data->float_buffer;
+namespace blender::imbuf {
+
+static float scale_filter_radius(const eIMBScaleFilter filter)
+{
+  switch (filter) {
+    case IMB_SCALE_FILTER_BOX:
+      return 0.5f;
+    case IMB_SCALE_FILTER_MITCHELL:
+      return 2.0f;
+    case IMB_SCALE_FILTER_LANCZOS:
+      return 3.0f;
+  }
+  BLI_assert_unreachable();
+  return 0.5f;
 }
 
-static void *do_scale_thread(void *data_v)
+static float scale_filter_weight(const eIMBScaleFilter filter, float x)
 {
-  using namespace blender::imbuf;
-  ScaleThreadData *data = (ScaleThreadData *)data_v;
-  ImBuf *ibuf = data->ibuf;
-  int i;
-  float factor_x = float(ibuf->x) / data->newx;
-  float factor_y = float(ibuf->y) / data->newy;
-
-  for (i = 0; i < data->tot_line; i++) {
-    int y = data->start_line + i;
-    int x;
-
-    for (x = 0; x < data->newx; x++) {
-      float u = float(x) * factor_x;
-      float v = float(y) * factor_y;
-      int offset = y * data->newx + x;
-
-      if (data->byte_buffer) {
-        interpolate_bilinear_border_byte(ibuf, data->byte_buffer + 4 * offset, u, v);
+  x = std::abs(x);
+  switch (filter) {
+    case IMB_SCALE_FILTER_BOX:
+      /* Pixels exactly on the edge are shared with the neighboring destination pixel. */
+      return x < 0.5f ? 1.0f : (x == 0.5f ? 0.5f : 0.0f);
+    case IMB_SCALE_FILTER_MITCHELL: {
+      constexpr float B = 1.0f / 3.0f;
+      constexpr float C = 1.0f / 3.0f;
+      if (x < 1.0f) {
+        return ((12.0f - 9.0f * B - 6.0f * C) * x * x * x +
+                (-18.0f + 12.0f * B + 6.0f * C) * x * x + (6.0f - 2.0f * B)) /
+               6.0f;
       }
+      if (x < 2.0f) {
+        return ((-B - 6.0f * C) * x * x * x + (6.0f * B + 30.0f * C) * x * x +
+                (-12.0f * B - 48.0f * C) * x + (8.0f * B + 24.0f * C)) /
+               6.0f;
+      }
+      return 0.0f;
+    }
+    case IMB_SCALE_FILTER_LANCZOS: {
+      if (x < 1e-6f) {
+        return 1.0f;
+      }
+      if (x >= 3.0f) {
+        return 0.0f;
+      }
+      const float px = float(M_PI) * x;
+      return 3.0f * std::sin(px) * std::sin(px / 3.0f) / (px * px);
+    }
+  }
+  BLI_assert_unreachable();
+  return 0.0f;
+}
+
+/** Source pixels and their weights for every destination pixel along one axis. */
+struct ScaleFilterWeights {
+  /** Number of source pixels used for each destination pixel. */
+  int taps;
+  /** First source pixel used for each destination pixel. */
+  Array<int> first;
+  /** #taps weights for each destination pixel, normalized to a sum of one. */
+  Array<float> weights;
+};
 
-      if (data->float_buffer) {
-        float *pixel = data->float_buffer + ibuf->channels * offset;
-        blender::math::interpolate_bilinear_border_fl(
-            ibuf->float_buffer.data, pixel, ibuf->x, ibuf->y, ibuf->channels, u, v);
+static ScaleFilterWeights scale_filter_weights(const eIMBScaleFilter filter,
+                                               const int src_size,
+                                               const int dst_size)
+{
+  const float src_step = float(src_size) / float(dst_size);
+  /* Widen the filter when scaling down, so that every source pixel contributes. */
+  const float filter_scale = std::max(src_step, 1.0f);
+  const float support = scale_filter_radius(filter) * filter_scale;
+
+  ScaleFilterWeights result;
+  result.taps = std::min(int(std::ceil(support * 2.0f)) + 1, src_size);
+  result.first.reinitialize(dst_size);
+  result.weights.reinitialize(int64_t(dst_size) * result.taps);
+
+  for (const int i : IndexRange(dst_size)) {
+    /* Pixel centers are at half integer coordinates. */
+    const float center = (float(i) + 0.5f) * src_step;
+    const int first = std::clamp(int(std::floor(center - support)), 0, src_size - result.taps);
+    float *weights = &result.weights[int64_t(i) * result.taps];
+
+    float weight_sum = 0.0f;
+    for (const int tap : IndexRange(result.taps)) {
+      const float offset = (float(first + tap) + 0.5f - center) / filter_scale;
+      weights[tap] = scale_filter_weight(filter, offset);
+      weight_sum += weights[tap];
+    }
+    if (weight_sum != 0.0f) {
+      for (const int tap : IndexRange(result.taps)) {
+        weights[tap] /= weight_sum;
       }
     }
+    else {
+      /* Can only happen with degenerate sizes, fall back to the nearest pixel. */
+      weights[std::clamp(int(center) - first, 0, result.taps - 1)] = 1.0f;
+    }
+    result.first[i] = first;
   }
+  return result;
+}
 
-  return nullptr;
+#if BLI_HAVE_SSE2
+BLI_INLINE __m128 scale_load_pixel_sse(const float *pixel)
+{
+  return _mm_loadu_ps(pixel);
 }
 
-void IMB_scaleImBuf_threaded(ImBuf *ibuf, uint newx, uint newy)
+BLI_INLINE __m128 scale_load_pixel_sse(const uchar *pixel)
 {
-  BLI_assert_msg(newx > 0 && newy > 0, "Images must be at least 1 on both dimensions!");
+  const __m128i bytes = _mm_cvtsi32_si128(*reinterpret_cast<const int *>(pixel));
+  const __m128i zero = _mm_setzero_si128();
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+#endif
+
+/** Scale the rows of `src` to `weights_x.first.size()` pixels, writing float pixels to `dst`. */
+template<typename T>
+static void scale_rows_horizontal(const T *src,
+                                  const int src_width,
+                                  const int height,
+                                  const int channels,
+                                  const ScaleFilterWeights &weights_x,
+                                  float *dst,
+                                  const bool threaded)
+{
+  const int dst_width = int(weights_x.first.size());
+  const int taps = weights_x.taps;
+
+  auto scale_rows = [&](const IndexRange y_range) {
+    for (const int64_t y : y_range) {
+      const T *src_row = src + y * src_width * channels;
+      float *dst_pixel = dst + y * dst_width * channels;
+      for (const int x : IndexRange(dst_width)) {
+        const T *src_pixel = src_row + int64_t(weights_x.first[x]) * channels;
+        const float *weights = &weights_x.weights[int64_t(x) * taps];
+#if BLI_HAVE_SSE2
+        if (channels == 4) {
+          __m128 sum = _mm_setzero_ps();
+          for (const int tap : IndexRange(taps)) {
+            sum = _mm_add_ps(sum,
+                             _mm_mul_ps(_mm_set1_ps(weights[tap]),
+                                        scale_load_pixel_sse(src_pixel + tap * 4)));
+          }
+          _mm_storeu_ps(dst_pixel, sum);
+          dst_pixel += 4;
+          continue;
+        }
+#endif
+        for (const int channel : IndexRange(channels)) {
+          float sum = 0.0f;
+          for (const int tap : IndexRange(taps)) {
+            sum += weights[tap] * float(src_pixel[tap * channels + channel]);
+          }
+          *dst_pixel++ = sum;
+        }
+      }
+    }
+  };
 
-  ScaleTreadInitData init_data = {nullptr};
+  if (threaded) {
+    threading::parallel_for(IndexRange(height), 16, scale_rows);
+  }
+  else {
+    scale_rows(IndexRange(height));
+  }
+}
 
-  /* prepare initialization data */
-  init_data.ibuf = ibuf;
+/** Weighted sum of float rows: `dst[i] += weight * src[i]`. */
+static void scale_row_accumulate(float *dst, const float *src, const float weight, int64_t size)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 weight4 = _mm_set1_ps(weight);
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(dst + i,
+                  _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(weight4, _mm_loadu_ps(src + i))));
+  }
+#endif
+  for (; i < size; i++) {
+    dst[i] += weight * src[i];
+  }
+}
 
-  init_data.newx = newx;
-  init_data.newy = newy;
+static void scale_row_store(float *dst, const float *src, const int64_t size)
+{
+  memcpy(dst, src, sizeof(float) * size);
+}
 
-  if (ibuf->byte_buffer.data) {
-    init_data.byte_buffer = static_cast<uchar *>(
-        MEM_mallocN(4 * newx * newy * sizeof(char), "threaded scale byte buffer"));
+static void scale_row_store(uchar *dst, const float *src, const int64_t size)
+{
+  for (const int64_t i : IndexRange(size)) {
+    dst[i] = uchar(std::clamp(src[i], 0.0f, 255.0f) + 0.5f);
   }
+}
 
-  if (ibuf->float_buffer.data) {
-    init_data.float_buffer = static_cast<float *>(
-        MEM_mallocN(ibuf->channels * newx * newy * sizeof(float), "threaded scale float buffer"));
+/** Scale the columns of the horizontally scaled `src` to `weights_y.first.size()` pixels. */
+template<typename T>
+static void scale_rows_vertical(const float *src,
+                                const int width,
+                                const int channels,
+                                const ScaleFilterWeights &weights_y,
+                                T *dst,
+                                const bool threaded)
+{
+  const int dst_height = int(weights_y.first.size());
+  const int64_t row_size = int64_t(width) * channels;
+  const int taps = weights_y.taps;
+
+  auto scale_rows = [&](const IndexRange y_range) {
+    Array<float> row(row_size, NoInitialization());
+    for (const int64_t y : y_range) {
+      const float *weights = &weights_y.weights[y * taps];
+      const float *src_row = src + weights_y.first[y] * row_size;
+      row.fill(0.0f);
+      for (const int tap : IndexRange(taps)) {
+        scale_row_accumulate(row.data(), src_row + tap * row_size, weights[tap], row_size);
+      }
+      scale_row_store(dst + y * row_size, row.data(), row_size);
+    }
+  };
+
+  if (threaded) {
+    threading::parallel_for(IndexRange(dst_height), 16, scale_rows);
+  }
+  else {
+    scale_rows(IndexRange(dst_height));
   }
+}
 
-  /* actual scaling threads */
-  IMB_processor_apply_threaded(
-      newy, sizeof(ScaleThreadData), &init_data, scale_thread_init, do_scale_thread);
+template<typename T>
+static void scale_filtered(const T *src,
+                           const int src_width,
+                           const int src_height,
+                           const int channels,
+                           T *dst,
+                           const int dst_width,
+                           const int dst_height,
+                           const eIMBScaleFilter filter,
+                           const bool threaded)
+{
+  const ScaleFilterWeights weights_x = scale_filter_weights(filter, src_width, dst_width);
+  const ScaleFilterWeights weights_y = scale_filter_weights(filter, src_height, dst_height);
 
-  /* alter image buffer */
-  ibuf->x = newx;
-  ibuf->y = newy;
+  Array<float> horizontal(int64_t(dst_width) * src_height * channels, NoInitialization());
+  scale_rows_horizontal(
+      src, src_width, src_height, channels, weights_x, horizontal.data(), threaded);
+  scale_rows_vertical(horizontal.data(), dst_width, channels, weights_y, dst, threaded);
+}
 
-  if (ibuf->byte_buffer.data) {
-    imb_freerectImBuf(ibuf);
-    IMB_assign_byte_buffer(ibuf, init_data.byte_buffer, IB_TAKE_OWNERSHIP);
+static void scale_filtered_buffers(const ImBuf *src,
+                                   const uint newx,
+                                   const uint newy,
+                                   const eIMBScaleFilter filter,
+                                   const bool threaded,
+                                   uchar **r_byte_buffer,
+                                   float **r_float_buffer)
+{
+  *r_byte_buffer = nullptr;
+  *r_float_buffer = nullptr;
+
+  if (src->byte_buffer.data) {
+    *r_byte_buffer = static_cast<uchar *>(
+        MEM_mallocN(sizeof(uchar[4]) * size_t(newx) * newy, "filtered scale byte buffer"));
+    scale_filtered(src->byte_buffer.data,
+                   src->x,
+                   src->y,
+                   4,
+                   *r_byte_buffer,
+                   newx,
+                   newy,
+                   filter,
+                   threaded);
+  }
+
+  if (src->float_buffer.data) {
+    *r_float_buffer = static_cast<float *>(MEM_mallocN(
+        sizeof(float) * src->channels * size_t(newx) * newy, "filtered scale float buffer"));
+    scale_filtered(src->float_buffer.data,
+                   src->x,
+                   src->y,
+                   src->channels,
+                   *r_float_buffer,
+                   newx,
+                   newy,
+                   filter,
+                   threaded);
   }
+}
 
-  if (ibuf->float_buffer.data) {
+}  // namespace blender::imbuf
+
+bool IMB_scale_filtered(ImBuf *ibuf, uint newx, uint newy, eIMBScaleFilter filter, bool threaded)
+{
+  using namespace blender::imbuf;
+  BLI_assert_msg(newx > 0 && newy > 0, "Images must be at least 1 on both dimensions!");
+
+  if (ibuf == nullptr) {
+    return false;
+  }
+  if (ibuf->byte_buffer.data == nullptr && ibuf->float_buffer.data == nullptr) {
+    return false;
+  }
+  if (newx == ibuf->x && newy == ibuf->y) {
+    return false;
+  }
+
+  uchar *byte_buffer;
+  float *float_buffer;
+  scale_filtered_buffers(ibuf, newx, newy, filter, threaded, &byte_buffer, &float_buffer);
+
+  if (byte_buffer) {
+    imb_freerectImBuf(ibuf);
+    IMB_assign_byte_buffer(ibuf, byte_buffer, IB_TAKE_OWNERSHIP);
+  }
+  if (float_buffer) {
     imb_freerectfloatImBuf(ibuf);
-    IMB_assign_float_buffer(ibuf, init_data.float_buffer, IB_TAKE_OWNERSHIP);
+    IMB_assign_float_buffer(ibuf, float_buffer, IB_TAKE_OWNERSHIP);
+  }
+
+  ibuf->x = newx;
+  ibuf->y = newy;
+  return true;
+}
+
+ImBuf *IMB_scale_filtered_into_new(
+    const ImBuf *ibuf, uint newx, uint newy, eIMBScaleFilter filter, bool threaded)
+{
+  using namespace blender::imbuf;
+  BLI_assert_msg(newx > 0 && newy > 0, "Images must be at least 1 on both dimensions!");
+
+  uchar *byte_buffer;
+  float *float_buffer;
+  scale_filtered_buffers(ibuf, newx, newy, filter, threaded, &byte_buffer, &float_buffer);
+
+  ImBuf *result = IMB_allocImBuf(newx, newy, ibuf->planes, 0);
+  result->channels = ibuf->channels;
+  if (byte_buffer) {
+    IMB_assign_byte_buffer(result, byte_buffer, IB_TAKE_OWNERSHIP);
+    result->byte_buffer.colorspace = ibuf->byte_buffer.colorspace;
   }
+  if (float_buffer) {
+    IMB_assign_float_buffer(result, float_buffer, IB_TAKE_OWNERSHIP);
+    result->float_buffer.colorspace = ibuf->float_buffer.colorspace;
+  }
+  return result;
 }
+
+/** \} */
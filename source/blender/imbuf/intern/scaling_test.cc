@@ -0,0 +1,153 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_color.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rect.h"
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+namespace blender::imbuf::tests {
+
+static ImBuf *create_4x2_test_image()
+{
+  ImBuf *img = IMB_allocImBuf(4, 2, 32, IB_rect | IB_rectfloat);
+  ColorTheme4b *col = reinterpret_cast<ColorTheme4b *>(img->byte_buffer.data);
+  float4 *colf = reinterpret_cast<float4 *>(img->float_buffer.data);
+
+  /* Two 2x2 blocks, the box filter averages each block when scaling down by two. */
+  col[0] = ColorTheme4b(0, 0, 0, 255);
+  col[1] = ColorTheme4b(255, 0, 0, 255);
+  col[4] = ColorTheme4b(255, 255, 0, 255);
+  col[5] = ColorTheme4b(255, 255, 255, 255);
+
+  col[2] = ColorTheme4b(10, 20, 30, 40);
+  col[3] = ColorTheme4b(20, 30, 40, 50);
+  col[6] = ColorTheme4b(30, 40, 50, 60);
+  col[7] = ColorTheme4b(40, 50, 60, 70);
+
+  for (int i = 0; i < 8; i++) {
+    colf[i] = float4(col[i].r, col[i].g, col[i].b, col[i].a) / 255.0f;
+  }
+
+  return img;
+}
+
+static ImBuf *create_uniform_image(int width, int height)
+{
+  ImBuf *img = IMB_allocImBuf(width, height, 32, IB_rect | IB_rectfloat);
+  ColorTheme4b *col = reinterpret_cast<ColorTheme4b *>(img->byte_buffer.data);
+  float4 *colf = reinterpret_cast<float4 *>(img->float_buffer.data);
+  for (int i = 0; i < width * height; i++) {
+    col[i] = ColorTheme4b(200, 100, 50, 255);
+    colf[i] = float4(0.75f, 0.5f, 0.25f, 1.0f);
+  }
+  return img;
+}
+
+TEST(imbuf_scaling, box_half)
+{
+  ImBuf *res = create_4x2_test_image();
+  EXPECT_TRUE(IMB_scale_filtered(res, 2, 1, IMB_SCALE_FILTER_BOX));
+  EXPECT_EQ(res->x, 2);
+  EXPECT_EQ(res->y, 1);
+
+  const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  EXPECT_EQ(got[0], ColorTheme4b(191, 128, 64, 255));
+  EXPECT_EQ(got[1], ColorTheme4b(25, 35, 45, 55));
+
+  const float4 *gotf = reinterpret_cast<float4 *>(res->float_buffer.data);
+  EXPECT_V4_NEAR(gotf[0], float4(0.75f, 0.5f, 0.25f, 1.0f), 1e-6f);
+  EXPECT_V4_NEAR(gotf[1], float4(25.0f, 35.0f, 45.0f, 55.0f) / 255.0f, 1e-6f);
+
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, uniform_stays_uniform)
+{
+  for (const eIMBScaleFilter filter :
+       {IMB_SCALE_FILTER_BOX, IMB_SCALE_FILTER_MITCHELL, IMB_SCALE_FILTER_LANCZOS})
+  {
+    for (const int2 size : {int2(7, 5), int2(33, 41), int2(1, 1)}) {
+      ImBuf *res = create_uniform_image(13, 17);
+      EXPECT_TRUE(IMB_scale_filtered(res, size.x, size.y, filter));
+      const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+      const float4 *gotf = reinterpret_cast<float4 *>(res->float_buffer.data);
+      for (int i = 0; i < size.x * size.y; i++) {
+        EXPECT_EQ(got[i], ColorTheme4b(200, 100, 50, 255));
+        EXPECT_V4_NEAR(gotf[i], float4(0.75f, 0.5f, 0.25f, 1.0f), 1e-5f);
+      }
+      IMB_freeImBuf(res);
+    }
+  }
+}
+
+TEST(imbuf_scaling, threaded_matches_single_threaded)
+{
+  ImBuf *src = IMB_allocImBuf(300, 200, 32, IB_rect);
+  uchar *bytes = src->byte_buffer.data;
+  for (int i = 0; i < 300 * 200 * 4; i++) {
+    bytes[i] = uchar((i * 7919) >> 3);
+  }
+
+  ImBuf *res_single = IMB_scale_filtered_into_new(src, 123, 77, IMB_SCALE_FILTER_LANCZOS, false);
+  ImBuf *res_threaded = IMB_scale_filtered_into_new(src, 123, 77, IMB_SCALE_FILTER_LANCZOS, true);
+  EXPECT_EQ(src->x, 300);
+  EXPECT_EQ(src->y, 200);
+  EXPECT_EQ(res_threaded->x, 123);
+  EXPECT_EQ(res_threaded->y, 77);
+  EXPECT_EQ(res_threaded->float_buffer.data, nullptr);
+  EXPECT_EQ(
+      memcmp(res_single->byte_buffer.data, res_threaded->byte_buffer.data, 123 * 77 * 4), 0);
+
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(res_single);
+  IMB_freeImBuf(res_threaded);
+}
+
+TEST(imbuf_scaling, mipmap_region_update)
+{
+  ImBuf *img = IMB_allocImBuf(100, 60, 32, IB_rect);
+  uchar *bytes = img->byte_buffer.data;
+  for (int i = 0; i < 100 * 60 * 4; i++) {
+    bytes[i] = uchar(i * 13);
+  }
+  IMB_makemipmap(img, false);
+
+  /* Change a region, and only update the mipmaps for that region. */
+  rcti region;
+  BLI_rcti_init(&region, 21, 38, 7, 30);
+  for (int y = region.ymin; y < region.ymax; y++) {
+    for (int x = region.xmin; x < region.xmax; x++) {
+      bytes[(y * 100 + x) * 4 + 1] = 255;
+      bytes[(y * 100 + x) * 4 + 3] = uchar(x * y);
+    }
+  }
+  IMB_mipmap_invalidate_region(img, &region);
+  IMB_remakemipmap(img, false);
+
+  ImBuf *expected = IMB_dupImBuf(img);
+  IMB_mipmap_invalidate_region(expected, &region);
+  IMB_makemipmap(expected, false);
+  EXPECT_FALSE(expected->userflags & IB_MIPMAP_INVALID_REGION);
+
+  EXPECT_EQ(img->miptot, expected->miptot);
+  for (int level = 1; level < expected->miptot; level++) {
+    const ImBuf *got_level = IMB_getmipmap(img, level);
+    const ImBuf *expected_level = IMB_getmipmap(expected, level);
+    EXPECT_EQ(got_level->x, expected_level->x);
+    EXPECT_EQ(got_level->y, expected_level->y);
+    EXPECT_EQ(memcmp(got_level->byte_buffer.data,
+                     expected_level->byte_buffer.data,
+                     size_t(got_level->x) * got_level->y * 4),
+              0);
+  }
+
+  IMB_freeImBuf(img);
+  IMB_freeImBuf(expected);
+}
+
+}  // namespace blender::imbuf::tests
@@ -124,6 +124,10 @@ typedef struct ABCReadParams {
   int read_flags;
   const char *velocity_name;
   float velocity_scale;
+  /* Memory budget in megabytes of the sample cache of the archive, zero disables caching. */
+  int sample_cache_size;
+  /* Number of samples to read ahead during playback. */
+  int prefetch_frames;
 } ABCReadParams;
 
 #ifdef __cplusplus
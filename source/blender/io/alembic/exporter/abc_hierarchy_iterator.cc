@@ -18,6 +18,7 @@
 #include <string>
 
 #include "BLI_assert.h"
+#include "BLI_task.hh"
 
 #include "DNA_layer_types.h"
 #include "DNA_object_types.h"
@@ -28,13 +29,40 @@ ABCHierarchyIterator::ABCHierarchyIterator(Main *bmain,
                                            Depsgraph *depsgraph,
                                            ABCArchive *abc_archive,
                                            const AlembicExportParams &params)
-    : AbstractHierarchyIterator(bmain, depsgraph), abc_archive_(abc_archive), params_(params)
+    : AbstractHierarchyIterator(bmain, depsgraph),
+      abc_archive_(abc_archive),
+      params_(params),
+      write_queue_(std::make_unique<ABCDeferredWriteQueue>())
 {
 }
 
+void ABCDeferredWriteQueue::push(ABCAbstractWriter *writer)
+{
+  writers_.append(writer);
+  if (writers_.size() >= max_size) {
+    flush();
+  }
+}
+
+void ABCDeferredWriteQueue::flush()
+{
+  const Vector<ABCAbstractWriter *> writers = std::move(writers_);
+  writers_.clear();
+
+  threading::parallel_for(writers.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      writers[i]->prepare_deferred_write();
+    }
+  });
+  for (ABCAbstractWriter *writer : writers) {
+    writer->finish_deferred_write();
+  }
+}
+
 void ABCHierarchyIterator::iterate_and_write()
 {
   AbstractHierarchyIterator::iterate_and_write();
+  write_queue_->flush();
   update_archive_bounding_box();
 }
 
@@ -145,6 +173,7 @@ ABCWriterConstructorArgs ABCHierarchyIterator::writer_constructor_args(
   ABCWriterConstructorArgs constructor_args;
   constructor_args.depsgraph = depsgraph_;
   constructor_args.abc_archive = abc_archive_;
+  constructor_args.write_queue = write_queue_.get();
   constructor_args.abc_parent = get_alembic_parent(context);
   constructor_args.abc_name = context->export_name;
   constructor_args.abc_path = context->export_path;
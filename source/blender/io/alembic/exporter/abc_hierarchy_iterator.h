@@ -8,6 +8,9 @@
 
 #include "IO_abstract_hierarchy_iterator.h"
 
+#include "BLI_vector.hh"
+
+#include <memory>
 #include <string>
 
 #include <Alembic/Abc/OObject.h>
@@ -21,9 +24,24 @@ namespace blender::io::alembic {
 class ABCAbstractWriter;
 class ABCHierarchyIterator;
 
+/* Queue of writers whose samples are converted in parallel. Conversion happens when the queue is
+ * full or flushed; after that the samples are submitted to Alembic in queue order, on the calling
+ * thread. The queue size is bounded to limit the memory used by converted samples. */
+class ABCDeferredWriteQueue {
+ private:
+  Vector<ABCAbstractWriter *> writers_;
+
+ public:
+  static constexpr int64_t max_size = 64;
+
+  void push(ABCAbstractWriter *writer);
+  void flush();
+};
+
 struct ABCWriterConstructorArgs {
   Depsgraph *depsgraph;
   ABCArchive *abc_archive;
+  ABCDeferredWriteQueue *write_queue;
   Alembic::Abc::OObject abc_parent;
   std::string abc_name;
   std::string abc_path;
@@ -35,6 +53,7 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
  private:
   ABCArchive *abc_archive_;
   const AlembicExportParams &params_;
+  std::unique_ptr<ABCDeferredWriteQueue> write_queue_;
 
  public:
   ABCHierarchyIterator(Main *bmain,
@@ -64,6 +64,16 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
    */
   virtual Alembic::Abc::OCompoundProperty abc_prop_for_custom_props() = 0;
 
+  /* Writers with expensive data conversion can queue themselves on the #ABCDeferredWriteQueue
+   * from do_write(), instead of writing immediately.
+   *
+   * prepare_deferred_write() is called from a worker thread, in parallel with other writers. It
+   * should gather the sample data, and must not touch any Alembic object, as the Alembic library
+   * is not thread-safe. finish_deferred_write() is then called from the main thread, in the order
+   * in which the writers were queued, to submit the sample to Alembic. */
+  virtual void prepare_deferred_write() {}
+  virtual void finish_deferred_write() {}
+
  protected:
   virtual void do_write(HierarchyContext &context) = 0;
 
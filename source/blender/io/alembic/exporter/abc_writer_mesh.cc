@@ -11,6 +11,7 @@
 #include "intern/abc_axis_conversion.h"
 
 #include "BLI_math_vector.h"
+#include "BLI_task.hh"
 
 #include "BKE_attribute.hh"
 #include "BKE_lib_id.hh"
@@ -132,6 +133,33 @@ bool ABCGenericMeshWriter::is_supported(const HierarchyContext *context) const
   return true;
 }
 
+struct ABCGenericMeshWriter::MeshSample {
+  Object *object;
+  Mesh *mesh;
+  bool mesh_needs_free;
+  bool write_face_sets;
+
+  std::vector<Imath::V3f> points;
+  std::vector<int32_t> face_verts, loop_counts;
+
+  const char *uv_name = nullptr;
+  UVSample uvs_and_indices;
+  std::vector<Imath::V3f> normals;
+  std::vector<Imath::V3f> velocities;
+  bool has_velocities = false;
+
+  std::vector<int32_t> edge_crease_indices, edge_crease_lengths, vert_crease_indices;
+  std::vector<float> edge_crease_sharpness, vert_crease_sharpness;
+};
+
+ABCGenericMeshWriter::~ABCGenericMeshWriter()
+{
+  /* A sample can only be left behind when an exception interrupted the deferred write. */
+  if (deferred_sample_ && deferred_sample_->mesh_needs_free) {
+    ABCGenericMeshWriter::free_export_mesh(deferred_sample_->mesh);
+  }
+}
+
 void ABCGenericMeshWriter::do_write(HierarchyContext &context)
 {
   Object *object = context.object;
@@ -146,6 +174,44 @@ void ABCGenericMeshWriter::do_write(HierarchyContext &context)
   /* Ensure data exists if currently in edit mode. */
   BKE_mesh_wrapper_ensure_mdata(mesh);
 
+  BLI_assert(!deferred_sample_);
+  deferred_sample_ = std::make_unique<MeshSample>();
+  deferred_sample_->object = object;
+  deferred_sample_->mesh = mesh;
+  deferred_sample_->mesh_needs_free = needsfree;
+  deferred_sample_->write_face_sets = !frame_has_been_written_ &&
+                                      args_.export_params->face_sets;
+
+  if (!args_.export_params->triangulate) {
+    /* Gaining write access can un-share the mesh data, which is not thread-safe when the mesh is
+     * shared between writers, so do that here instead of in #prepare_deferred_write. */
+    init_custom_data_config(mesh);
+  }
+
+  if (args_.write_queue == nullptr) {
+    prepare_deferred_write();
+    finish_deferred_write();
+    return;
+  }
+  args_.write_queue->push(this);
+}
+
+void ABCGenericMeshWriter::init_custom_data_config(Mesh *mesh)
+{
+  m_custom_data_config.pack_uvs = args_.export_params->packuv;
+  m_custom_data_config.mesh = mesh;
+  m_custom_data_config.face_offsets = mesh->face_offsets_for_write().data();
+  m_custom_data_config.corner_verts = mesh->corner_verts_for_write().data();
+  m_custom_data_config.faces_num = mesh->faces_num;
+  m_custom_data_config.totloop = mesh->corners_num;
+  m_custom_data_config.totvert = mesh->verts_num;
+  m_custom_data_config.timesample_index = timesample_index_;
+}
+
+void ABCGenericMeshWriter::prepare_deferred_write()
+{
+  MeshSample &sample = *deferred_sample_;
+
   if (args_.export_params->triangulate) {
     const bool tag_only = false;
     const int quad_method = args_.export_params->quad_method;
@@ -155,44 +221,65 @@ void ABCGenericMeshWriter::do_write(HierarchyContext &context)
     BMeshFromMeshParams bmesh_from_mesh_params{};
     bmesh_from_mesh_params.calc_face_normal = true;
     bmesh_from_mesh_params.calc_vert_normal = true;
-    BMesh *bm = BKE_mesh_to_bmesh_ex(mesh, &bmesh_create_params, &bmesh_from_mesh_params);
+    BMesh *bm = BKE_mesh_to_bmesh_ex(sample.mesh, &bmesh_create_params, &bmesh_from_mesh_params);
 
     BM_mesh_triangulate(bm, quad_method, ngon_method, 4, tag_only, nullptr, nullptr, nullptr);
 
-    Mesh *triangulated_mesh = BKE_mesh_from_bmesh_for_eval_nomain(bm, nullptr, mesh);
+    Mesh *triangulated_mesh = BKE_mesh_from_bmesh_for_eval_nomain(bm, nullptr, sample.mesh);
     BM_mesh_free(bm);
 
-    if (needsfree) {
-      free_export_mesh(mesh);
+    if (sample.mesh_needs_free) {
+      free_export_mesh(sample.mesh);
     }
-    mesh = triangulated_mesh;
-    needsfree = true;
+    sample.mesh = triangulated_mesh;
+    sample.mesh_needs_free = true;
+
+    init_custom_data_config(sample.mesh);
   }
 
-  m_custom_data_config.pack_uvs = args_.export_params->packuv;
-  m_custom_data_config.mesh = mesh;
-  m_custom_data_config.face_offsets = mesh->face_offsets_for_write().data();
-  m_custom_data_config.corner_verts = mesh->corner_verts_for_write().data();
-  m_custom_data_config.faces_num = mesh->faces_num;
-  m_custom_data_config.totloop = mesh->corners_num;
-  m_custom_data_config.totvert = mesh->verts_num;
-  m_custom_data_config.timesample_index = timesample_index_;
+  Mesh *mesh = sample.mesh;
+  get_vertices(mesh, sample.points);
+  get_topology(mesh, sample.face_verts, sample.loop_counts);
+
+  if (args_.export_params->uvs) {
+    sample.uv_name = get_uv_sample(
+        sample.uvs_and_indices, m_custom_data_config, &mesh->corner_data);
+  }
+
+  if (is_subd_) {
+    get_edge_creases(mesh,
+                     sample.edge_crease_indices,
+                     sample.edge_crease_lengths,
+                     sample.edge_crease_sharpness);
+    get_vert_creases(mesh, sample.vert_crease_indices, sample.vert_crease_sharpness);
+    return;
+  }
+
+  if (args_.export_params->normals) {
+    get_loop_normals(mesh, sample.normals);
+  }
+  sample.has_velocities = get_velocities(mesh, sample.velocities);
+}
+
+void ABCGenericMeshWriter::finish_deferred_write()
+{
+  std::unique_ptr<MeshSample> sample = std::move(deferred_sample_);
 
   try {
     if (is_subd_) {
-      write_subd(context, mesh);
+      write_subd(*sample);
     }
     else {
-      write_mesh(context, mesh);
+      write_mesh(*sample);
     }
 
-    if (needsfree) {
-      free_export_mesh(mesh);
+    if (sample->mesh_needs_free) {
+      free_export_mesh(sample->mesh);
     }
   }
   catch (...) {
-    if (needsfree) {
-      free_export_mesh(mesh);
+    if (sample->mesh_needs_free) {
+      free_export_mesh(sample->mesh);
     }
     throw;
   }
@@ -203,26 +290,21 @@ void ABCGenericMeshWriter::free_export_mesh(Mesh *mesh)
   BKE_id_free(nullptr, mesh);
 }
 
-void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
+void ABCGenericMeshWriter::write_mesh(MeshSample &sample)
 {
-  std::vector<Imath::V3f> points, normals;
-  std::vector<int32_t> face_verts, loop_counts;
-  std::vector<Imath::V3f> velocities;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, face_verts, loop_counts);
+  Mesh *mesh = sample.mesh;
 
-  if (!frame_has_been_written_ && args_.export_params->face_sets) {
-    write_face_sets(context.object, mesh, abc_poly_mesh_schema_);
+  if (sample.write_face_sets) {
+    write_face_sets(sample.object, mesh, abc_poly_mesh_schema_);
   }
 
   OPolyMeshSchema::Sample mesh_sample = OPolyMeshSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(face_verts), Int32ArraySample(loop_counts));
-
-  UVSample uvs_and_indices;
+      V3fArraySample(sample.points),
+      Int32ArraySample(sample.face_verts),
+      Int32ArraySample(sample.loop_counts));
 
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(uvs_and_indices, m_custom_data_config, &mesh->corner_data);
+    const UVSample &uvs_and_indices = sample.uvs_and_indices;
 
     if (!uvs_and_indices.indices.empty() && !uvs_and_indices.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
@@ -230,7 +312,7 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
       uv_sample.setIndices(UInt32ArraySample(uvs_and_indices.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      abc_poly_mesh_schema_.setUVSourceName(name);
+      abc_poly_mesh_schema_.setUVSourceName(sample.uv_name);
       mesh_sample.setUVs(uv_sample);
     }
 
@@ -241,12 +323,10 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   }
 
   if (args_.export_params->normals) {
-    get_loop_normals(mesh, normals);
-
     ON3fGeomParam::Sample normals_sample;
-    if (!normals.empty()) {
+    if (!sample.normals.empty()) {
       normals_sample.setScope(kFacevaryingScope);
-      normals_sample.setVals(V3fArraySample(normals));
+      normals_sample.setVals(V3fArraySample(sample.normals));
     }
 
     mesh_sample.setNormals(normals_sample);
@@ -256,11 +336,11 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
     write_generated_coordinates(abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config);
   }
 
-  if (get_velocities(mesh, velocities)) {
-    mesh_sample.setVelocities(V3fArraySample(velocities));
+  if (sample.has_velocities) {
+    mesh_sample.setVelocities(V3fArraySample(sample.velocities));
   }
 
-  update_bounding_box(context.object);
+  update_bounding_box(sample.object);
   mesh_sample.setSelfBounds(bounding_box_);
 
   abc_poly_mesh_schema_.set(mesh_sample);
@@ -268,36 +348,28 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   write_arb_geo_params(mesh);
 }
 
-void ABCGenericMeshWriter::write_subd(HierarchyContext &context, Mesh *mesh)
+void ABCGenericMeshWriter::write_subd(MeshSample &sample)
 {
-  std::vector<float> edge_crease_sharpness, vert_crease_sharpness;
-  std::vector<Imath::V3f> points;
-  std::vector<int32_t> face_verts, loop_counts;
-  std::vector<int32_t> edge_crease_indices, edge_crease_lengths, vert_crease_indices;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, face_verts, loop_counts);
-  get_edge_creases(mesh, edge_crease_indices, edge_crease_lengths, edge_crease_sharpness);
-  get_vert_creases(mesh, vert_crease_indices, vert_crease_sharpness);
+  Mesh *mesh = sample.mesh;
 
-  if (!frame_has_been_written_ && args_.export_params->face_sets) {
-    write_face_sets(context.object, mesh, abc_subdiv_schema_);
+  if (sample.write_face_sets) {
+    write_face_sets(sample.object, mesh, abc_subdiv_schema_);
   }
 
-  OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(face_verts), Int32ArraySample(loop_counts));
+  OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(V3fArraySample(sample.points),
+                                                          Int32ArraySample(sample.face_verts),
+                                                          Int32ArraySample(sample.loop_counts));
 
-  UVSample sample;
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->corner_data);
+    const UVSample &uvs_and_indices = sample.uvs_and_indices;
 
-    if (!sample.indices.empty() && !sample.uvs.empty()) {
+    if (!uvs_and_indices.indices.empty() && !uvs_and_indices.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(sample.uvs));
-      uv_sample.setIndices(UInt32ArraySample(sample.indices));
+      uv_sample.setVals(V2fArraySample(uvs_and_indices.uvs));
+      uv_sample.setIndices(UInt32ArraySample(uvs_and_indices.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      abc_subdiv_schema_.setUVSourceName(name);
+      abc_subdiv_schema_.setUVSourceName(sample.uv_name);
       subdiv_sample.setUVs(uv_sample);
     }
 
@@ -311,18 +383,18 @@ void ABCGenericMeshWriter::write_subd(HierarchyContext &context, Mesh *mesh)
     write_generated_coordinates(abc_subdiv_schema_.getArbGeomParams(), m_custom_data_config);
   }
 
-  if (!edge_crease_indices.empty()) {
-    subdiv_sample.setCreaseIndices(Int32ArraySample(edge_crease_indices));
-    subdiv_sample.setCreaseLengths(Int32ArraySample(edge_crease_lengths));
-    subdiv_sample.setCreaseSharpnesses(FloatArraySample(edge_crease_sharpness));
+  if (!sample.edge_crease_indices.empty()) {
+    subdiv_sample.setCreaseIndices(Int32ArraySample(sample.edge_crease_indices));
+    subdiv_sample.setCreaseLengths(Int32ArraySample(sample.edge_crease_lengths));
+    subdiv_sample.setCreaseSharpnesses(FloatArraySample(sample.edge_crease_sharpness));
   }
 
-  if (!vert_crease_indices.empty()) {
-    subdiv_sample.setCornerIndices(Int32ArraySample(vert_crease_indices));
-    subdiv_sample.setCornerSharpnesses(FloatArraySample(vert_crease_sharpness));
+  if (!sample.vert_crease_indices.empty()) {
+    subdiv_sample.setCornerIndices(Int32ArraySample(sample.vert_crease_indices));
+    subdiv_sample.setCornerSharpnesses(FloatArraySample(sample.vert_crease_sharpness));
   }
 
-  update_bounding_box(context.object);
+  update_bounding_box(sample.object);
   subdiv_sample.setSelfBounds(bounding_box_);
   abc_subdiv_schema_.set(subdiv_sample);
 
@@ -377,9 +449,11 @@ bool ABCGenericMeshWriter::get_velocities(Mesh *mesh, std::vector<Imath::V3f> &v
   vels.clear();
   vels.resize(totverts);
 
-  for (int i = 0; i < totverts; i++) {
-    copy_yup_from_zup(vels[i].getValue(), mesh_velocities[i]);
-  }
+  threading::parallel_for(IndexRange(totverts), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      copy_yup_from_zup(vels[i].getValue(), mesh_velocities[i]);
+    }
+  });
 
   return true;
 }
@@ -434,9 +508,11 @@ static void get_vertices(Mesh *mesh, std::vector<Imath::V3f> &points)
   points.resize(mesh->verts_num);
 
   const Span<float3> positions = mesh->vert_positions();
-  for (int i = 0, e = mesh->verts_num; i < e; i++) {
-    copy_yup_from_zup(points[i].getValue(), positions[i]);
-  }
+  threading::parallel_for(positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      copy_yup_from_zup(points[i].getValue(), positions[i]);
+    }
+  });
 }
 
 static void get_topology(Mesh *mesh,
@@ -448,19 +524,19 @@ static void get_topology(Mesh *mesh,
 
   face_verts.clear();
   loop_counts.clear();
-  face_verts.reserve(corner_verts.size());
-  loop_counts.reserve(faces.size());
+  face_verts.resize(corner_verts.size());
+  loop_counts.resize(faces.size());
 
   /* NOTE: data needs to be written in the reverse order. */
-  for (const int i : faces.index_range()) {
-    const IndexRange face = faces[i];
-    loop_counts.push_back(face.size());
-
-    int corner = face.start() + (face.size() - 1);
-    for (int j = 0; j < face.size(); j++, corner--) {
-      face_verts.push_back(corner_verts[corner]);
+  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      const IndexRange face = faces[i];
+      loop_counts[i] = face.size();
+      for (const int j : face.index_range()) {
+        face_verts[face[j]] = corner_verts[face.last(j)];
+      }
     }
-  }
+  });
 }
 
 static void get_edge_creases(Mesh *mesh,
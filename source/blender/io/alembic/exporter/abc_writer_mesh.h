@@ -13,6 +13,8 @@
 #include <Alembic/AbcGeom/OPolyMesh.h>
 #include <Alembic/AbcGeom/OSubD.h>
 
+#include <memory>
+
 struct ModifierData;
 
 namespace blender::io::alembic {
@@ -36,13 +38,21 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
 
   CDStreamConfig m_custom_data_config;
 
+  /* Data of the current frame, from #do_write until the write queue finishes this writer. */
+  struct MeshSample;
+  std::unique_ptr<MeshSample> deferred_sample_;
+
  public:
   explicit ABCGenericMeshWriter(const ABCWriterConstructorArgs &args);
+  ~ABCGenericMeshWriter();
 
   virtual void create_alembic_objects(const HierarchyContext *context) override;
   virtual Alembic::Abc::OObject get_alembic_object() const override;
   Alembic::Abc::OCompoundProperty abc_prop_for_custom_props() override;
 
+  virtual void prepare_deferred_write() override;
+  virtual void finish_deferred_write() override;
+
  protected:
   virtual bool is_supported(const HierarchyContext *context) const override;
   virtual void do_write(HierarchyContext &context) override;
@@ -53,8 +63,9 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
   virtual bool export_as_subdivision_surface(Object *ob_eval) const;
 
  private:
-  void write_mesh(HierarchyContext &context, Mesh *mesh);
-  void write_subd(HierarchyContext &context, Mesh *mesh);
+  void init_custom_data_config(Mesh *mesh);
+  void write_mesh(MeshSample &sample);
+  void write_subd(MeshSample &sample);
   template<typename Schema> void write_face_sets(Object *object, Mesh *mesh, Schema &schema);
 
   void write_arb_geo_params(Mesh *mesh);
@@ -36,13 +36,12 @@ struct UVSample {
 };
 
 struct CDStreamConfig {
-  int *corner_verts;
+  const int *corner_verts;
   int totloop;
 
-  int *face_offsets;
+  const int *face_offsets;
   int faces_num;
 
-  float3 *positions;
   int totvert;
 
   float2 *mloopuv;
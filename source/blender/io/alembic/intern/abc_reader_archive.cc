@@ -142,4 +142,9 @@ Alembic::Abc::IObject ArchiveReader::getTop()
   return m_archive.getTop();
 }
 
+SampleCache &ArchiveReader::sample_cache()
+{
+  return m_sample_cache;
+}
+
 }  // namespace blender::io::alembic
@@ -7,6 +7,8 @@
  * \ingroup balembic
  */
 
+#include "abc_sample_cache.h"
+
 #include <Alembic/Abc/IArchive.h>
 #include <Alembic/Abc/IObject.h>
 
@@ -29,6 +31,8 @@ class ArchiveReader {
 
   std::vector<ArchiveReader *> m_readers;
 
+  SampleCache m_sample_cache;
+
   ArchiveReader(const std::vector<ArchiveReader *> &readers);
 
   ArchiveReader(const struct Main *bmain, const char *filename);
@@ -41,6 +45,8 @@ class ArchiveReader {
   bool valid() const;
 
   Alembic::Abc::IObject getTop();
+
+  SampleCache &sample_cache();
 };
 
 }  // namespace blender::io::alembic
@@ -22,9 +22,11 @@
 #include "BLI_map.hh"
 #include "BLI_math_vector.h"
 #include "BLI_ordered_edge.hh"
+#include "BLI_set.hh"
 
 #include "BLT_translation.hh"
 
+#include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_geometry_set.hh"
 #include "BKE_lib_id.hh"
@@ -141,10 +143,10 @@ static void read_mverts_interp(float3 *vert_positions,
 
 static void read_mverts(CDStreamConfig &config, const AbcMeshData &mesh_data)
 {
-  float3 *vert_positions = config.positions;
   const P3fArraySamplePtr &positions = mesh_data.positions;
 
   if (mesh_data.interpolation_settings.has_value()) {
+    float3 *vert_positions = config.mesh->vert_positions_for_write().data();
     BLI_assert_msg(
         mesh_data.ceil_positions != nullptr,
         "AbcMeshData does not have ceil positions although it has some interpolation settings.");
@@ -178,25 +180,60 @@ void read_mverts(Mesh &mesh, const P3fArraySamplePtr positions, const N3fArraySa
   }
 }
 
-static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
+static void read_loop_uvs(CDStreamConfig &config, const AbcMeshData &mesh_data)
 {
-  int *face_offsets = config.face_offsets;
-  int *corner_verts = config.corner_verts;
   float2 *mloopuvs = config.mloopuv;
 
   const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
   const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
   const V2fArraySamplePtr &uvs = mesh_data.uvs;
-  const size_t uvs_size = uvs == nullptr ? 0 : uvs->size();
-
   const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
 
-  const bool do_uvs = (mloopuvs && uvs && uvs_indices);
-  const bool do_uvs_per_loop = do_uvs && mesh_data.uv_scope == ABC_UV_SCOPE_LOOP;
-  BLI_assert(!do_uvs || mesh_data.uv_scope != ABC_UV_SCOPE_NONE);
+  if (!(mloopuvs && uvs && uvs_indices)) {
+    return;
+  }
+
+  BLI_assert(mesh_data.uv_scope != ABC_UV_SCOPE_NONE);
+  const bool do_uvs_per_loop = mesh_data.uv_scope == ABC_UV_SCOPE_LOOP;
+  const size_t uvs_size = uvs->size();
+  uint loop_index = 0;
+
+  for (int i = 0; i < face_counts->size(); i++) {
+    const int face_size = (*face_counts)[i];
+
+    /* NOTE: Alembic data is stored in the reverse order. */
+    uint rev_loop_index = loop_index + (face_size - 1);
+
+    for (int f = 0; f < face_size; f++, loop_index++, rev_loop_index--) {
+      const int vert = (*face_indices)[loop_index];
+      const uint uv_index = (*uvs_indices)[do_uvs_per_loop ? loop_index : vert];
+
+      /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
+      if (uv_index >= uvs_size) {
+        continue;
+      }
+
+      mloopuvs[rev_loop_index][0] = (*uvs)[uv_index][0];
+      mloopuvs[rev_loop_index][1] = (*uvs)[uv_index][1];
+    }
+  }
+}
+
+/**
+ * Read the faces and UVs, and compute the edges.
+ * \return False when the faces had to be corrected, so that the mesh topology doesn't match the
+ * Alembic topology anymore.
+ */
+static bool read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
+{
+  MutableSpan<int> face_offsets = config.mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = config.mesh->corner_verts_for_write();
+
+  const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
+
   uint loop_index = 0;
   uint rev_loop_index = 0;
-  uint uv_index = 0;
   bool seen_invalid_geometry = false;
 
   for (int i = 0; i < face_counts->size(); i++) {
@@ -221,21 +258,12 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
         seen_invalid_geometry = true;
       }
       last_vertex_index = vert;
-
-      if (do_uvs) {
-        uv_index = (*uvs_indices)[do_uvs_per_loop ? loop_index : last_vertex_index];
-
-        /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
-        if (uv_index >= uvs_size) {
-          continue;
-        }
-
-        mloopuvs[rev_loop_index][0] = (*uvs)[uv_index][0];
-        mloopuvs[rev_loop_index][1] = (*uvs)[uv_index][1];
-      }
     }
   }
 
+  /* UVs have to be read before validation, which may remove corners. */
+  read_loop_uvs(config, mesh_data);
+
   bke::mesh_calc_edges(*config.mesh, false, false);
   if (seen_invalid_geometry) {
     if (config.modifier_error_message) {
@@ -243,6 +271,8 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
     }
     BKE_mesh_validate(config.mesh, true, true);
   }
+
+  return !seen_invalid_geometry;
 }
 
 static void process_no_normals(CDStreamConfig & /*config*/)
@@ -431,25 +461,29 @@ static bool samples_have_same_topology(const SampleType &sample, const SampleTyp
   return true;
 }
 
-static void read_mesh_sample(const std::string &iobject_full_name,
+/**
+ * \param abc_mesh_data: Topology and, unless they were taken from the sample cache, positions of
+ * the sample.
+ * \param topology_is_current: The mesh already has the topology of the sample, so that only the
+ * data that is stored on top of the topology has to be read.
+ * \return False when the faces had to be corrected while reading them.
+ */
+static bool read_mesh_sample(const std::string &iobject_full_name,
                              ImportSettings *settings,
                              const IPolyMeshSchema &schema,
                              const ISampleSelector &selector,
+                             AbcMeshData &abc_mesh_data,
+                             const bool topology_is_current,
                              CDStreamConfig &config)
 {
-  const IPolyMeshSchema::Sample sample = schema.getValue(selector);
-
-  AbcMeshData abc_mesh_data;
-  abc_mesh_data.face_counts = sample.getFaceCounts();
-  abc_mesh_data.face_indices = sample.getFaceIndices();
-  abc_mesh_data.positions = sample.getPositions();
-
   const std::optional<SampleInterpolationSettings> interpolation_settings =
       get_sample_interpolation_settings(
           selector, schema.getTimeSampling(), schema.getNumSamples());
 
   const bool use_vertex_interpolation = settings->read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES;
-  if (use_vertex_interpolation && interpolation_settings.has_value()) {
+  if (use_vertex_interpolation && interpolation_settings.has_value() && abc_mesh_data.positions)
+  {
+    const IPolyMeshSchema::Sample sample = schema.getValue(selector);
     Alembic::AbcGeom::IPolyMeshSchema::Sample ceil_sample;
     schema.get(ceil_sample, Alembic::Abc::ISampleSelector(interpolation_settings->ceil_index));
     if (samples_have_same_topology(sample, ceil_sample)) {
@@ -464,12 +498,20 @@ static void read_mesh_sample(const std::string &iobject_full_name,
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_VERT) != 0) {
-    read_mverts(config, abc_mesh_data);
+    if (abc_mesh_data.positions) {
+      read_mverts(config, abc_mesh_data);
+    }
     read_generated_coordinates(schema.getArbGeomParams(), config, selector);
   }
 
+  bool topology_is_valid = true;
   if ((settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-    read_mpolys(config, abc_mesh_data);
+    if (topology_is_current) {
+      read_loop_uvs(config, abc_mesh_data);
+    }
+    else {
+      topology_is_valid = read_mpolys(config, abc_mesh_data);
+    }
     process_normals(config, schema.getNormalsParam(), selector);
   }
 
@@ -483,15 +525,16 @@ static void read_mesh_sample(const std::string &iobject_full_name,
       read_velocity(velocities, config, settings->velocity_scale);
     }
   }
+
+  return topology_is_valid;
 }
 
 static CDStreamConfig get_config(Mesh *mesh)
 {
   CDStreamConfig config;
   config.mesh = mesh;
-  config.positions = mesh->vert_positions_for_write().data();
-  config.corner_verts = mesh->corner_verts_for_write().data();
-  config.face_offsets = mesh->face_offsets_for_write().data();
+  config.corner_verts = mesh->corner_verts().data();
+  config.face_offsets = mesh->face_offsets().data();
   config.totvert = mesh->verts_num;
   config.totloop = mesh->corners_num;
   config.faces_num = mesh->faces_num;
@@ -514,6 +557,13 @@ AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
   get_min_max_time(m_iobject, m_schema, m_min_time, m_max_time);
 }
 
+AbcMeshReader::~AbcMeshReader()
+{
+  if (m_topology_mesh) {
+    BKE_id_free(nullptr, m_topology_mesh);
+  }
+}
+
 bool AbcMeshReader::valid() const
 {
   return m_schema.valid();
@@ -622,9 +672,15 @@ bool AbcMeshReader::accepts_object_type(
 
 bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSelector &sample_sel)
 {
-  IPolyMeshSchema::Sample sample;
+  Int32ArraySamplePtr face_indices;
+  Int32ArraySamplePtr face_counts;
+  size_t positions_num;
   try {
-    sample = m_schema.getValue(sample_sel);
+    m_schema.getFaceIndicesProperty().get(face_indices, sample_sel);
+    m_schema.getFaceCountsProperty().get(face_counts, sample_sel);
+    Alembic::Util::Dimensions dimensions;
+    m_schema.getPositionsProperty().getDimensions(dimensions, sample_sel);
+    positions_num = dimensions.numPoints();
   }
   catch (Alembic::Util::Exception &ex) {
     printf("Alembic: error reading mesh sample for '%s/%s' at time %f: %s\n",
@@ -636,12 +692,16 @@ bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSel
     return false;
   }
 
-  const P3fArraySamplePtr &positions = sample.getPositions();
-  const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
-  const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
+  return topology_changed(existing_mesh, positions_num, face_counts, face_indices);
+}
 
+bool AbcMeshReader::topology_changed(const Mesh *existing_mesh,
+                                     const size_t positions_num,
+                                     const Int32ArraySamplePtr &face_counts,
+                                     const Int32ArraySamplePtr &face_indices) const
+{
   /* It the counters are different, we can be sure the topology is different. */
-  const bool different_counters = positions->size() != existing_mesh->verts_num ||
+  const bool different_counters = positions_num != existing_mesh->verts_num ||
                                   face_counts->size() != existing_mesh->faces_num ||
                                   face_indices->size() != existing_mesh->corners_num;
   if (different_counters) {
@@ -683,6 +743,76 @@ bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSel
   return false;
 }
 
+bool AbcMeshReader::use_sample_cache(const ISampleSelector &sample_sel, const int read_flag) const
+{
+  if (m_sample_cache == nullptr || !m_sample_cache->is_enabled()) {
+    return false;
+  }
+  /* Interpolated positions are computed from two samples, they are not cached. */
+  if ((read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES) != 0) {
+    return !get_sample_interpolation_settings(
+                sample_sel, m_schema.getTimeSampling(), m_schema.getNumSamples())
+                .has_value();
+  }
+  return true;
+}
+
+void AbcMeshReader::start_prefetch(const ISampleSelector &sample_sel)
+{
+  const int64_t sample_index = sample_sel.getIndex(m_schema.getTimeSampling(),
+                                                   m_schema.getNumSamples());
+  const bool is_playing_forward = sample_index == m_last_sample_index + 1;
+  m_last_sample_index = sample_index;
+
+  const int prefetch_samples = m_sample_cache->prefetch_samples();
+  if (!is_playing_forward || prefetch_samples == 0 || *m_is_prefetching) {
+    return;
+  }
+
+  const IndexRange samples = IndexRange(sample_index + 1, prefetch_samples)
+                                 .intersect(IndexRange(m_schema.getNumSamples()));
+  if (samples.is_empty()) {
+    return;
+  }
+
+  m_sample_cache->prefetch_positions(m_schema.getPositionsProperty(), samples, m_is_prefetching);
+}
+
+/**
+ * Remove the attributes that are read for every sample from the mesh that stores the topology,
+ * so that meshes created from it don't keep data of an earlier sample when a following sample
+ * doesn't contain it anymore.
+ */
+static void remove_sample_attributes(Mesh &mesh)
+{
+  static const Set<StringRef> topology_attributes = {
+      "position", ".edge_verts", ".corner_vert", ".corner_edge"};
+  bke::MutableAttributeAccessor attributes = mesh.attributes_for_write();
+  Vector<std::string> names_to_remove;
+  attributes.for_all(
+      [&](const bke::AttributeIDRef &attribute_id, const bke::AttributeMetaData & /*meta_data*/) {
+        if (!topology_attributes.contains(attribute_id.name())) {
+          names_to_remove.append(attribute_id.name());
+        }
+        return true;
+      });
+  for (const StringRef name : names_to_remove) {
+    attributes.remove(name);
+  }
+  CustomData_free_layers(&mesh.corner_data, CD_CUSTOMLOOPNORMAL, mesh.corners_num);
+}
+
+static void assign_cached_positions(Mesh &mesh,
+                                    const ImplicitSharingPtr<SampleCache::Positions> &positions)
+{
+  CustomData_free_layer_named(&mesh.vert_data, "position", mesh.verts_num);
+  mesh.attributes_for_write().add<float3>(
+      "position",
+      bke::AttrDomain::Point,
+      bke::AttributeInitShared(positions->data.data(), *positions));
+  mesh.tag_positions_changed();
+}
+
 void AbcMeshReader::read_geometry(bke::GeometrySet &geometry_set,
                                   const Alembic::Abc::ISampleSelector &sample_sel,
                                   const int read_flag,
@@ -708,9 +838,24 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
                                const float velocity_scale,
                                const char **err_str)
 {
-  IPolyMeshSchema::Sample sample;
+  const bool use_sample_cache = this->use_sample_cache(sample_sel, read_flag);
+
+  AbcMeshData abc_mesh_data;
+  ImplicitSharingPtr<SampleCache::Positions> cached_positions;
+  Alembic::AbcCoreAbstract::ArraySampleKey face_counts_key;
+  Alembic::AbcCoreAbstract::ArraySampleKey face_indices_key;
   try {
-    sample = m_schema.getValue(sample_sel);
+    m_schema.getFaceIndicesProperty().get(abc_mesh_data.face_indices, sample_sel);
+    m_schema.getFaceCountsProperty().get(abc_mesh_data.face_counts, sample_sel);
+    m_schema.getFaceCountsProperty().getKey(face_counts_key, sample_sel);
+    m_schema.getFaceIndicesProperty().getKey(face_indices_key, sample_sel);
+    if (use_sample_cache) {
+      cached_positions = m_sample_cache->ensure_positions(m_schema.getPositionsProperty(),
+                                                          sample_sel);
+    }
+    if (!cached_positions) {
+      m_schema.getPositionsProperty().get(abc_mesh_data.positions, sample_sel);
+    }
   }
   catch (Alembic::Util::Exception &ex) {
     if (err_str != nullptr) {
@@ -724,9 +869,14 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
     return existing_mesh;
   }
 
-  const P3fArraySamplePtr &positions = sample.getPositions();
-  const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
-  const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
+  if (use_sample_cache) {
+    this->start_prefetch(sample_sel);
+  }
+
+  const Int32ArraySamplePtr &face_indices = abc_mesh_data.face_indices;
+  const Int32ArraySamplePtr &face_counts = abc_mesh_data.face_counts;
+  const size_t positions_num = cached_positions ? size_t(cached_positions->data.size()) :
+                                                  abc_mesh_data.positions->size();
 
   /* Do some very minimal mesh validation. */
   const int poly_count = face_counts->size();
@@ -744,6 +894,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   }
 
   Mesh *new_mesh = nullptr;
+  bool topology_is_current = true;
 
   /* Only read point data when streaming meshes, unless we need to create new ones. */
   ImportSettings settings;
@@ -751,9 +902,21 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   settings.velocity_name = velocity_name;
   settings.velocity_scale = velocity_scale;
 
-  if (topology_changed(existing_mesh, sample_sel)) {
-    new_mesh = BKE_mesh_new_nomain_from_template(
-        existing_mesh, positions->size(), 0, face_counts->size(), face_indices->size());
+  if (topology_changed(existing_mesh, positions_num, face_counts, face_indices)) {
+    if (m_topology_mesh && face_counts_key == m_topology_face_counts_key &&
+        face_indices_key == m_topology_face_indices_key &&
+        positions_num == size_t(m_topology_mesh->verts_num))
+    {
+      /* The topology is the same as the one of the last mesh created by this reader, share its
+       * arrays instead of building the topology again. The number of vertices is checked as well,
+       * since loose vertices can be added or removed without changing the faces. */
+      new_mesh = BKE_mesh_copy_for_eval(*m_topology_mesh);
+    }
+    else {
+      new_mesh = BKE_mesh_new_nomain_from_template(
+          existing_mesh, positions_num, 0, face_counts->size(), face_indices->size());
+      topology_is_current = false;
+    }
 
     settings.read_flag |= MOD_MESHSEQ_READ_ALL;
   }
@@ -779,7 +942,17 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   config.time = sample_sel.getRequestedTime();
   config.modifier_error_message = err_str;
 
-  read_mesh_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
+  if (cached_positions && (settings.read_flag & MOD_MESHSEQ_READ_VERT) != 0) {
+    assign_cached_positions(*mesh_to_export, cached_positions);
+  }
+
+  const bool topology_is_valid = read_mesh_sample(m_iobject.getFullName(),
+                                                  &settings,
+                                                  m_schema,
+                                                  sample_sel,
+                                                  abc_mesh_data,
+                                                  topology_is_current,
+                                                  config);
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
@@ -795,6 +968,17 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
       material_indices.finish();
     }
 
+    if (!topology_is_current && topology_is_valid && m_sample_cache != nullptr) {
+      /* Remember the topology, so that it can be shared by the meshes of following samples. */
+      if (m_topology_mesh) {
+        BKE_id_free(nullptr, m_topology_mesh);
+      }
+      m_topology_mesh = BKE_mesh_copy_for_eval(*new_mesh);
+      remove_sample_attributes(*m_topology_mesh);
+      m_topology_face_counts_key = face_counts_key;
+      m_topology_face_indices_key = face_indices_key;
+    }
+
     return new_mesh;
   }
 
@@ -10,10 +10,14 @@
 #include "BLI_span.hh"
 
 #include "abc_reader_object.h"
+#include "abc_sample_cache.h"
 
 #include <Alembic/AbcGeom/IPolyMesh.h>
 #include <Alembic/AbcGeom/ISubD.h>
 
+#include <atomic>
+#include <memory>
+
 struct Mesh;
 
 namespace blender::io::alembic {
@@ -21,8 +25,21 @@ namespace blender::io::alembic {
 class AbcMeshReader final : public AbcObjectReader {
   Alembic::AbcGeom::IPolyMeshSchema m_schema;
 
+  /** Mesh with the topology of the last sample that required a new mesh, shared by the meshes
+   * of following samples with the same face keys. Only used when a sample cache is set. */
+  Mesh *m_topology_mesh = nullptr;
+  Alembic::AbcCoreAbstract::ArraySampleKey m_topology_face_counts_key;
+  Alembic::AbcCoreAbstract::ArraySampleKey m_topology_face_indices_key;
+
+  /** Background loading of the positions of the samples following the current one. The flag is
+   * shared with the prefetching task, which belongs to the sample cache. */
+  std::shared_ptr<std::atomic<bool>> m_is_prefetching = std::make_shared<std::atomic<bool>>(
+      false);
+  int64_t m_last_sample_index = -1;
+
  public:
   AbcMeshReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+  ~AbcMeshReader() override;
 
   bool valid() const override;
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
@@ -48,6 +65,14 @@ class AbcMeshReader final : public AbcObjectReader {
                         const Alembic::Abc::ISampleSelector &sample_sel) override;
 
  private:
+  bool topology_changed(const Mesh *existing_mesh,
+                        size_t positions_num,
+                        const Alembic::Abc::Int32ArraySamplePtr &face_counts,
+                        const Alembic::Abc::Int32ArraySamplePtr &face_indices) const;
+
+  bool use_sample_cache(const Alembic::Abc::ISampleSelector &sample_sel, int read_flag) const;
+  void start_prefetch(const Alembic::Abc::ISampleSelector &sample_sel);
+
   void readFaceSetsSample(Main *bmain,
                           Mesh *mesh,
                           const Alembic::AbcGeom::ISampleSelector &sample_sel);
@@ -102,6 +102,16 @@ void AbcObjectReader::object(Object *ob)
   m_object = ob;
 }
 
+SampleCache *AbcObjectReader::sample_cache() const
+{
+  return m_sample_cache;
+}
+
+void AbcObjectReader::sample_cache(SampleCache *cache)
+{
+  m_sample_cache = cache;
+}
+
 static Imath::M44d blend_matrices(const Imath::M44d &m0,
                                   const Imath::M44d &m1,
                                   const double weight)
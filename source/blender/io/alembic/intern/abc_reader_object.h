@@ -29,6 +29,8 @@ using Alembic::AbcCoreAbstract::chrono_t;
 
 namespace blender::io::alembic {
 
+class SampleCache;
+
 struct ImportSettings {
   bool do_convert_mat;
   float conversion_mat[4][4];
@@ -102,6 +104,9 @@ class AbcObjectReader {
 
   bool m_inherits_xform;
 
+  /* Cache shared by the readers of the archive, only set for readers of cache modifiers. */
+  SampleCache *m_sample_cache = nullptr;
+
  public:
   AbcObjectReader *parent_reader;
 
@@ -123,6 +128,9 @@ class AbcObjectReader {
   Object *object() const;
   void object(Object *ob);
 
+  SampleCache *sample_cache() const;
+  void sample_cache(SampleCache *cache);
+
   const std::string &name() const
   {
     return m_name;
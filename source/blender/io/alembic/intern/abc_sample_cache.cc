@@ -0,0 +1,209 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "abc_sample_cache.h"
+#include "abc_axis_conversion.h"
+
+#include "BLI_task.h"
+#include "BLI_task.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include <limits>
+#include <optional>
+
+namespace blender::io::alembic {
+
+SampleCache::~SampleCache()
+{
+  if (prefetch_pool_) {
+    BLI_task_pool_cancel(prefetch_pool_);
+    BLI_task_pool_free(prefetch_pool_);
+  }
+}
+
+static int64_t positions_memory_size(const SampleCache::Positions &positions)
+{
+  return positions.data.as_span().size_in_bytes();
+}
+
+void SampleCache::set_memory_budget(const int64_t bytes)
+{
+  std::lock_guard lock{mutex_};
+  memory_budget_ = bytes;
+  this->evict_to_budget();
+}
+
+void SampleCache::set_prefetch_samples(const int samples)
+{
+  std::lock_guard lock{mutex_};
+  prefetch_samples_ = samples;
+}
+
+bool SampleCache::is_enabled()
+{
+  std::lock_guard lock{mutex_};
+  return memory_budget_ > 0;
+}
+
+int SampleCache::prefetch_samples()
+{
+  std::lock_guard lock{mutex_};
+  return memory_budget_ > 0 ? prefetch_samples_ : 0;
+}
+
+bool SampleCache::contains(const Alembic::AbcCoreAbstract::ArraySampleKey &sample_key)
+{
+  std::lock_guard lock{mutex_};
+  return entries_.contains({sample_key});
+}
+
+ImplicitSharingPtr<SampleCache::Positions> SampleCache::lookup(
+    const Alembic::AbcCoreAbstract::ArraySampleKey &sample_key)
+{
+  std::lock_guard lock{mutex_};
+  Entry *entry = entries_.lookup_ptr({sample_key});
+  if (entry == nullptr) {
+    return {};
+  }
+  entry->last_use = use_counter_++;
+  return entry->positions;
+}
+
+void SampleCache::add(const Alembic::AbcCoreAbstract::ArraySampleKey &sample_key,
+                      ImplicitSharingPtr<Positions> positions)
+{
+  std::lock_guard lock{mutex_};
+  const int64_t size = positions_memory_size(*positions);
+  if (size > memory_budget_) {
+    return;
+  }
+  const bool added = entries_.add({sample_key}, {std::move(positions), use_counter_++});
+  if (added) {
+    memory_used_ += size;
+    this->evict_to_budget();
+  }
+}
+
+ImplicitSharingPtr<SampleCache::Positions> SampleCache::ensure_positions(
+    const Alembic::Abc::IP3fArrayProperty &positions_prop,
+    const Alembic::Abc::ISampleSelector &sample_sel)
+{
+  Alembic::AbcCoreAbstract::ArraySampleKey key;
+  if (!positions_prop.getKey(key, sample_sel)) {
+    return {};
+  }
+  if (ImplicitSharingPtr<Positions> positions = this->lookup(key)) {
+    return positions;
+  }
+
+  Alembic::Abc::P3fArraySamplePtr abc_positions;
+  positions_prop.get(abc_positions, sample_sel);
+
+  Positions *new_positions = new Positions(abc_positions->size());
+  MutableSpan<float3> dst = new_positions->data;
+  threading::parallel_for(dst.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      copy_zup_from_yup(dst[i], (*abc_positions)[i].getValue());
+    }
+  });
+
+  ImplicitSharingPtr<Positions> positions(new_positions);
+  this->add(key, positions);
+  return positions;
+}
+
+struct PrefetchPositionsTask {
+  Alembic::Abc::IP3fArrayProperty positions_prop;
+  IndexRange samples;
+  std::shared_ptr<std::atomic<bool>> is_prefetching;
+
+  PrefetchPositionsTask(const Alembic::Abc::IP3fArrayProperty &positions_prop,
+                        const IndexRange samples,
+                        std::shared_ptr<std::atomic<bool>> is_prefetching)
+      : positions_prop(positions_prop), samples(samples), is_prefetching(std::move(is_prefetching))
+  {
+    *this->is_prefetching = true;
+  }
+  PrefetchPositionsTask(const PrefetchPositionsTask &other) = delete;
+
+  /* Also called when the task is canceled before it runs. */
+  ~PrefetchPositionsTask()
+  {
+    *is_prefetching = false;
+  }
+};
+
+static void prefetch_positions_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SampleCache *cache = static_cast<SampleCache *>(BLI_task_pool_user_data(pool));
+  const PrefetchPositionsTask &task = *static_cast<PrefetchPositionsTask *>(taskdata);
+  for (const int64_t sample_index : task.samples) {
+    if (BLI_task_pool_current_canceled(pool)) {
+      break;
+    }
+    try {
+      cache->ensure_positions(task.positions_prop,
+                              Alembic::Abc::ISampleSelector(Alembic::Abc::index_t(sample_index)));
+    }
+    catch (Alembic::Util::Exception & /*ex*/) {
+      /* The error is reported when the sample is read for evaluation. */
+      break;
+    }
+  }
+}
+
+static void prefetch_positions_task_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  MEM_delete(static_cast<PrefetchPositionsTask *>(taskdata));
+}
+
+void SampleCache::prefetch_positions(const Alembic::Abc::IP3fArrayProperty &positions_prop,
+                                     const IndexRange samples,
+                                     std::shared_ptr<std::atomic<bool>> is_prefetching)
+{
+  TaskPool *pool;
+  {
+    std::lock_guard lock{mutex_};
+    if (prefetch_pool_ == nullptr) {
+      prefetch_pool_ = BLI_task_pool_create_background(this, TASK_PRIORITY_LOW);
+    }
+    pool = prefetch_pool_;
+  }
+  PrefetchPositionsTask *taskdata = MEM_new<PrefetchPositionsTask>(
+      __func__, positions_prop, samples, std::move(is_prefetching));
+  BLI_task_pool_push(pool, prefetch_positions_task, taskdata, true, prefetch_positions_task_free);
+}
+
+void SampleCache::clear()
+{
+  std::lock_guard lock{mutex_};
+  entries_.clear();
+  memory_used_ = 0;
+}
+
+void SampleCache::evict_to_budget()
+{
+  while (memory_used_ > memory_budget_) {
+    std::optional<Key> oldest_key;
+    int64_t oldest_use = std::numeric_limits<int64_t>::max();
+    for (const auto item : entries_.items()) {
+      if (item.value.last_use < oldest_use) {
+        oldest_use = item.value.last_use;
+        oldest_key = item.key;
+      }
+    }
+    if (!oldest_key) {
+      break;
+    }
+    const Entry entry = entries_.pop(*oldest_key);
+    memory_used_ -= positions_memory_size(*entry.positions);
+  }
+}
+
+}  // namespace blender::io::alembic
@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#pragma once
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "BLI_array.hh"
+#include "BLI_implicit_sharing.hh"
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_index_range.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+
+#include <Alembic/Abc/ISampleSelector.h>
+#include <Alembic/Abc/ITypedArrayProperty.h>
+#include <Alembic/AbcCoreAbstract/ArraySampleKey.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+struct TaskPool;
+
+namespace blender::io::alembic {
+
+/**
+ * Cache of converted vertex positions, shared by all mesh readers of an archive.
+ *
+ * Entries are identified by the digest of the Alembic array sample, so samples that are identical
+ * in the archive (e.g. static meshes that are written every frame) are only converted once. The
+ * positions are implicitly shared, so that meshes can use them without copying. When the memory
+ * budget is exceeded, the least recently used entries are removed.
+ *
+ * All functions are thread-safe, as the cache is also filled by prefetching tasks. The prefetching
+ * tasks belong to the cache, so that they are canceled when the archive is closed, even when
+ * readers are still alive.
+ */
+class SampleCache {
+ public:
+  using Positions = ImplicitSharedValue<Array<float3>>;
+
+ private:
+  struct Entry {
+    ImplicitSharingPtr<Positions> positions;
+    int64_t last_use;
+  };
+
+  struct Key {
+    Alembic::AbcCoreAbstract::ArraySampleKey sample_key;
+
+    uint64_t hash() const
+    {
+      return sample_key.digest.words[0];
+    }
+
+    friend bool operator==(const Key &a, const Key &b)
+    {
+      return a.sample_key == b.sample_key;
+    }
+  };
+
+  std::mutex mutex_;
+  Map<Key, Entry> entries_;
+  int64_t memory_budget_ = 0;
+  int64_t memory_used_ = 0;
+  int64_t use_counter_ = 0;
+  int prefetch_samples_ = 0;
+
+  TaskPool *prefetch_pool_ = nullptr;
+
+ public:
+  SampleCache() = default;
+  SampleCache(const SampleCache &other) = delete;
+  SampleCache &operator=(const SampleCache &other) = delete;
+  /** Cancels prefetching and waits for running tasks. */
+  ~SampleCache();
+
+  /** Set the maximum amount of memory used by the cache; zero disables caching. */
+  void set_memory_budget(int64_t bytes);
+  /** Set the number of samples that readers load ahead during playback. */
+  void set_prefetch_samples(int samples);
+
+  bool is_enabled();
+  int prefetch_samples();
+
+  bool contains(const Alembic::AbcCoreAbstract::ArraySampleKey &sample_key);
+  ImplicitSharingPtr<Positions> lookup(const Alembic::AbcCoreAbstract::ArraySampleKey &sample_key);
+  void add(const Alembic::AbcCoreAbstract::ArraySampleKey &sample_key,
+           ImplicitSharingPtr<Positions> positions);
+
+  /**
+   * Return the positions of the sample converted to Z-up, converting and adding them to the cache
+   * when they are not cached yet. Returns nothing when the sample has no key.
+   */
+  ImplicitSharingPtr<Positions> ensure_positions(
+      const Alembic::Abc::IP3fArrayProperty &positions_prop,
+      const Alembic::Abc::ISampleSelector &sample_sel);
+
+  /**
+   * Convert the positions of the samples in the background. \a is_prefetching is set while the
+   * task is pending or running, so that callers don't start more than one task at a time.
+   */
+  void prefetch_positions(const Alembic::Abc::IP3fArrayProperty &positions_prop,
+                          IndexRange samples,
+                          std::shared_ptr<std::atomic<bool>> is_prefetching);
+
+  void clear();
+
+ private:
+  void evict_to_budget();
+};
+
+}  // namespace blender::io::alembic
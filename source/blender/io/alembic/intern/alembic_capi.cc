@@ -813,6 +813,11 @@ void ABC_read_geometry(CacheReader *reader,
     return;
   }
 
+  if (SampleCache *sample_cache = abc_reader->sample_cache()) {
+    sample_cache->set_memory_budget(int64_t(params->sample_cache_size) * 1024 * 1024);
+    sample_cache->set_prefetch_samples(params->prefetch_frames);
+  }
+
   ISampleSelector sample_sel = sample_selector_for_time(params->time);
   return abc_reader->read_geometry(geometry_set,
                                    sample_sel,
@@ -886,6 +891,7 @@ CacheReader *CacheReader_open_alembic_object(CacheArchiveHandle *handle,
     return nullptr;
   }
   abc_reader->object(object);
+  abc_reader->sample_cache(&archive->sample_cache());
   abc_reader->incref();
 
   return reinterpret_cast<CacheReader *>(abc_reader);
@@ -0,0 +1,188 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+/* Keep first since utildefines defines AT which conflicts with STL. */
+#include "intern/abc_sample_cache.h"
+
+#include "BKE_appdir.hh"
+
+#include "BLI_path_util.h"
+
+#include <Alembic/AbcCoreOgawa/ReadWrite.h>
+#include <Alembic/AbcGeom/IPolyMesh.h>
+#include <Alembic/AbcGeom/OPolyMesh.h>
+
+#include <string>
+#include <thread>
+
+namespace blender::io::alembic {
+
+using Alembic::AbcCoreAbstract::ArraySampleKey;
+
+static ArraySampleKey create_key(const uint64_t id)
+{
+  ArraySampleKey key;
+  key.numBytes = 0;
+  key.origPOD = Alembic::Util::kFloat32POD;
+  key.readPOD = Alembic::Util::kFloat32POD;
+  key.digest.words[0] = id;
+  key.digest.words[1] = 0;
+  return key;
+}
+
+static ImplicitSharingPtr<SampleCache::Positions> create_positions(const int64_t size)
+{
+  return ImplicitSharingPtr<SampleCache::Positions>(
+      new SampleCache::Positions(size, float3(0.0f)));
+}
+
+TEST(abc_sample_cache, disabled_without_budget)
+{
+  SampleCache cache;
+  cache.set_prefetch_samples(4);
+  EXPECT_FALSE(cache.is_enabled());
+  EXPECT_EQ(cache.prefetch_samples(), 0);
+
+  cache.add(create_key(0), create_positions(10));
+  EXPECT_FALSE(cache.contains(create_key(0)));
+}
+
+TEST(abc_sample_cache, skip_entries_larger_than_budget)
+{
+  SampleCache cache;
+  cache.set_memory_budget(sizeof(float3) * 10);
+  cache.add(create_key(0), create_positions(11));
+  EXPECT_FALSE(cache.contains(create_key(0)));
+  cache.add(create_key(1), create_positions(10));
+  EXPECT_TRUE(cache.contains(create_key(1)));
+}
+
+TEST(abc_sample_cache, evict_least_recently_used)
+{
+  SampleCache cache;
+  cache.set_memory_budget(sizeof(float3) * 20);
+  const ImplicitSharingPtr<SampleCache::Positions> positions_0 = create_positions(10);
+  cache.add(create_key(0), positions_0);
+  cache.add(create_key(1), create_positions(10));
+
+  /* Using the first entry makes the second one the least recently used. */
+  EXPECT_EQ(cache.lookup(create_key(0)).get(), positions_0.get());
+  cache.add(create_key(2), create_positions(10));
+  EXPECT_TRUE(cache.contains(create_key(0)));
+  EXPECT_FALSE(cache.contains(create_key(1)));
+  EXPECT_TRUE(cache.contains(create_key(2)));
+
+  /* Lowering the budget evicts entries right away. */
+  cache.set_memory_budget(sizeof(float3) * 10);
+  EXPECT_FALSE(cache.contains(create_key(0)));
+  EXPECT_TRUE(cache.contains(create_key(2)));
+
+  cache.clear();
+  EXPECT_FALSE(cache.contains(create_key(2)));
+  EXPECT_FALSE(cache.lookup(create_key(2)));
+}
+
+class AlembicSampleCacheTest : public testing::Test {
+ protected:
+  static constexpr int samples_num = 8;
+  std::string filepath;
+
+  void SetUp() override
+  {
+    BKE_tempdir_init(nullptr);
+    filepath = std::string(BKE_tempdir_session()) + SEP_STR + "sample_cache_test.abc";
+
+    /* Write a triangle that moves along the Y axis, the up axis in Alembic. */
+    Alembic::Abc::OArchive archive(Alembic::AbcCoreOgawa::WriteArchive(), filepath);
+    Alembic::AbcGeom::OPolyMesh mesh(archive.getTop(), "triangle");
+    Alembic::AbcGeom::OPolyMeshSchema &schema = mesh.getSchema();
+    const int32_t face_indices[3] = {0, 1, 2};
+    const int32_t face_counts[1] = {3};
+    for (const int sample : IndexRange(samples_num)) {
+      const Imath::V3f positions[3] = {Imath::V3f(0.0f, float(sample), 0.0f),
+                                       Imath::V3f(1.0f, float(sample), 0.0f),
+                                       Imath::V3f(0.0f, float(sample), 1.0f)};
+      schema.set(Alembic::AbcGeom::OPolyMeshSchema::Sample(
+          Alembic::AbcGeom::P3fArraySample(positions, 3),
+          Alembic::AbcGeom::Int32ArraySample(face_indices, 3),
+          Alembic::AbcGeom::Int32ArraySample(face_counts, 1)));
+    }
+  }
+
+  void TearDown() override
+  {
+    BKE_tempdir_session_purge();
+  }
+
+  Alembic::Abc::IP3fArrayProperty read_positions_property() const
+  {
+    Alembic::Abc::IArchive archive(Alembic::AbcCoreOgawa::ReadArchive(), filepath);
+    Alembic::AbcGeom::IPolyMesh mesh(archive.getTop(), "triangle");
+    return mesh.getSchema().getPositionsProperty();
+  }
+
+  static ArraySampleKey sample_key(const Alembic::Abc::IP3fArrayProperty &positions_prop,
+                                   const int sample)
+  {
+    ArraySampleKey key;
+    positions_prop.getKey(key, Alembic::Abc::ISampleSelector(Alembic::Abc::index_t(sample)));
+    return key;
+  }
+};
+
+TEST_F(AlembicSampleCacheTest, ensure_positions)
+{
+  const Alembic::Abc::IP3fArrayProperty positions_prop = read_positions_property();
+  SampleCache cache;
+  cache.set_memory_budget(1024 * 1024);
+
+  const Alembic::Abc::ISampleSelector sample_sel(Alembic::Abc::index_t(3));
+  const ImplicitSharingPtr<SampleCache::Positions> positions = cache.ensure_positions(
+      positions_prop, sample_sel);
+  ASSERT_TRUE(positions);
+  ASSERT_EQ(positions->data.size(), 3);
+  /* The Y-up positions are converted to Z-up. */
+  EXPECT_EQ(positions->data[0], float3(0.0f, 0.0f, 3.0f));
+  EXPECT_EQ(positions->data[1], float3(1.0f, 0.0f, 3.0f));
+  EXPECT_EQ(positions->data[2], float3(0.0f, -1.0f, 3.0f));
+
+  /* The converted positions are shared instead of being read again. */
+  EXPECT_TRUE(cache.contains(sample_key(positions_prop, 3)));
+  EXPECT_EQ(cache.ensure_positions(positions_prop, sample_sel).get(), positions.get());
+}
+
+TEST_F(AlembicSampleCacheTest, prefetch_positions)
+{
+  const Alembic::Abc::IP3fArrayProperty positions_prop = read_positions_property();
+  SampleCache cache;
+  cache.set_memory_budget(1024 * 1024);
+
+  std::shared_ptr<std::atomic<bool>> is_prefetching = std::make_shared<std::atomic<bool>>(false);
+  cache.prefetch_positions(positions_prop, IndexRange(2, 4), is_prefetching);
+  while (*is_prefetching) {
+    std::this_thread::yield();
+  }
+
+  for (const int sample : IndexRange(samples_num)) {
+    EXPECT_EQ(cache.contains(sample_key(positions_prop, sample)),
+              IndexRange(2, 4).contains(sample));
+  }
+}
+
+TEST_F(AlembicSampleCacheTest, free_while_prefetching)
+{
+  const Alembic::Abc::IP3fArrayProperty positions_prop = read_positions_property();
+  std::shared_ptr<std::atomic<bool>> is_prefetching = std::make_shared<std::atomic<bool>>(false);
+  {
+    SampleCache cache;
+    cache.set_memory_budget(1024 * 1024);
+    cache.prefetch_positions(positions_prop, IndexRange(samples_num), is_prefetching);
+    /* Freeing the cache cancels the task or waits for it, so it can't use the freed cache. */
+  }
+  EXPECT_FALSE(*is_prefetching);
+}
+
+}  // namespace blender::io::alembic
@@ -0,0 +1,68 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#pragma once
+
+/** \file
+ * \ingroup io
+ *
+ * Reading and writing of files that are transparently compressed with Gzip or Zstd, so that
+ * text based formats can be stored compressed without an extra decompression step.
+ */
+
+#include <cstdio>
+#include <memory>
+
+#include "BLI_string_ref.hh"
+
+struct FileReader;
+
+namespace blender::io {
+
+enum class FileCompression {
+  None,
+  Gzip,
+  Zstd,
+};
+
+/** Compression to use when writing a file, determined by its extension (`.gz` or `.zst`). */
+FileCompression file_compression_from_path(StringRefNull filepath);
+
+/**
+ * Open a file for reading. Gzip and Zstd compressed files are detected by their contents and
+ * decompressed while reading. Returns null if the file can't be opened.
+ * The reader has to be freed with its `close` callback.
+ */
+FileReader *file_reader_open(const char *filepath);
+
+/**
+ * Read until \a size bytes have been read or the end of the file is reached.
+ * \return The number of bytes read.
+ */
+size_t file_reader_read(FileReader *reader, void *buffer, size_t size);
+
+/**
+ * File that is written sequentially, compressed according to #file_compression_from_path.
+ * Zstd compression uses multiple threads.
+ */
+class FileWriter {
+ public:
+  virtual ~FileWriter() = default;
+
+  /**
+   * Open the file for writing, replacing existing files. Returns null if the file can't be
+   * created.
+   */
+  static std::unique_ptr<FileWriter> open(const char *filepath);
+
+  /** \return False when the data could not be written. */
+  virtual bool write(const void *data, size_t size) = 0;
+
+  /**
+   * Finish writing and close the file, this has to be called before the writer is destroyed.
+   * \return False when the remaining data could not be written.
+   */
+  virtual bool close() = 0;
+};
+
+}  // namespace blender::io
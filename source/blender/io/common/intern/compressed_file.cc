@@ -0,0 +1,237 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup io
+ */
+
+#include "IO_compressed_file.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_filereader.h"
+#include "BLI_path_util.h"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#ifdef WIN32
+#  include "BLI_winstuff.h"
+#else
+#  include <unistd.h>
+#endif
+
+namespace blender::io {
+
+FileCompression file_compression_from_path(StringRefNull filepath)
+{
+  if (BLI_path_extension_check(filepath.c_str(), ".gz")) {
+    return FileCompression::Gzip;
+  }
+  if (BLI_path_extension_check(filepath.c_str(), ".zst")) {
+    return FileCompression::Zstd;
+  }
+  return FileCompression::None;
+}
+
+FileReader *file_reader_open(const char *filepath)
+{
+  const int filedes = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (filedes == -1) {
+    return nullptr;
+  }
+
+  FileReader *rawfile = BLI_filereader_new_file(filedes);
+  if (rawfile == nullptr) {
+    close(filedes);
+    return nullptr;
+  }
+
+  char header[4];
+  const bool has_header = rawfile->read(rawfile, header, sizeof(header)) == sizeof(header);
+  /* Rewind the file after reading the header. */
+  rawfile->seek(rawfile, 0, SEEK_SET);
+  if (!has_header) {
+    return rawfile;
+  }
+
+  FileReader *file = nullptr;
+  if (BLI_file_magic_is_gzip(header)) {
+    file = BLI_filereader_new_gzip(rawfile);
+  }
+  else if (BLI_file_magic_is_zstd(header)) {
+    file = BLI_filereader_new_zstd(rawfile);
+  }
+  /* Compressed readers take ownership of `rawfile`, otherwise it is read as is. */
+  return file ? file : rawfile;
+}
+
+size_t file_reader_read(FileReader *reader, void *buffer, const size_t size)
+{
+  size_t total = 0;
+  while (total < size) {
+    const int64_t read = reader->read(reader, static_cast<char *>(buffer) + total, size - total);
+    if (read <= 0) {
+      break;
+    }
+    total += size_t(read);
+  }
+  return total;
+}
+
+class RawFileWriter : public FileWriter {
+  FILE *file_;
+
+ public:
+  RawFileWriter(FILE *file) : file_(file) {}
+
+  ~RawFileWriter() override
+  {
+    if (file_) {
+      fclose(file_);
+    }
+  }
+
+  bool write(const void *data, const size_t size) override
+  {
+    return fwrite(data, 1, size, file_) == size;
+  }
+
+  bool close() override
+  {
+    const bool ok = fclose(file_) == 0;
+    file_ = nullptr;
+    return ok;
+  }
+};
+
+class GzipFileWriter : public FileWriter {
+  gzFile file_;
+
+ public:
+  GzipFileWriter(gzFile file) : file_(file) {}
+
+  ~GzipFileWriter() override
+  {
+    if (file_) {
+      gzclose(file_);
+    }
+  }
+
+  bool write(const void *data, const size_t size) override
+  {
+    const char *bytes = static_cast<const char *>(data);
+    size_t written = 0;
+    /* `gzwrite` takes the length as unsigned int, write large buffers in parts. */
+    while (written < size) {
+      const uint part = uint(std::min<size_t>(size - written, 1 << 30));
+      if (gzwrite(file_, bytes + written, part) != int(part)) {
+        return false;
+      }
+      written += part;
+    }
+    return true;
+  }
+
+  bool close() override
+  {
+    const bool ok = gzclose(file_) == Z_OK;
+    file_ = nullptr;
+    return ok;
+  }
+};
+
+class ZstdFileWriter : public FileWriter {
+  FILE *file_;
+  ZSTD_CCtx *context_;
+  Vector<char> out_buffer_;
+
+ public:
+  ZstdFileWriter(FILE *file, ZSTD_CCtx *context) : file_(file), context_(context)
+  {
+    ZSTD_CCtx_setParameter(context_, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+    /* Compress on worker threads, this has no effect when Zstd is built without threading. */
+    ZSTD_CCtx_setParameter(context_, ZSTD_c_nbWorkers, BLI_system_thread_count());
+    out_buffer_.resize(ZSTD_CStreamOutSize());
+  }
+
+  ~ZstdFileWriter() override
+  {
+    ZSTD_freeCCtx(context_);
+    if (file_) {
+      fclose(file_);
+    }
+  }
+
+  bool write(const void *data, const size_t size) override
+  {
+    ZSTD_inBuffer input = {data, size, 0};
+    while (input.pos < input.size) {
+      if (!this->compress(input, ZSTD_e_continue)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool close() override
+  {
+    ZSTD_inBuffer input = {nullptr, 0, 0};
+    bool ok = true;
+    /* Flush the remaining data and finalize the frame. */
+    size_t remaining = 1;
+    while (ok && remaining != 0) {
+      ok = this->compress(input, ZSTD_e_end, &remaining);
+    }
+    ok &= fclose(file_) == 0;
+    file_ = nullptr;
+    return ok;
+  }
+
+ private:
+  bool compress(ZSTD_inBuffer &input,
+                const ZSTD_EndDirective directive,
+                size_t *r_remaining = nullptr)
+  {
+    ZSTD_outBuffer output = {out_buffer_.data(), size_t(out_buffer_.size()), 0};
+    const size_t ret = ZSTD_compressStream2(context_, &output, &input, directive);
+    if (ZSTD_isError(ret)) {
+      return false;
+    }
+    if (r_remaining) {
+      *r_remaining = ret;
+    }
+    return fwrite(out_buffer_.data(), 1, output.pos, file_) == output.pos;
+  }
+};
+
+std::unique_ptr<FileWriter> FileWriter::open(const char *filepath)
+{
+  if (file_compression_from_path(filepath) == FileCompression::Gzip) {
+    gzFile file = static_cast<gzFile>(BLI_gzopen(filepath, "wb"));
+    if (file == nullptr) {
+      return nullptr;
+    }
+    return std::make_unique<GzipFileWriter>(file);
+  }
+
+  FILE *file = BLI_fopen(filepath, "wb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  if (file_compression_from_path(filepath) == FileCompression::Zstd) {
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    if (context == nullptr) {
+      fclose(file);
+      return nullptr;
+    }
+    return std::make_unique<ZstdFileWriter>(file, context);
+  }
+  return std::make_unique<RawFileWriter>(file);
+}
+
+}  // namespace blender::io
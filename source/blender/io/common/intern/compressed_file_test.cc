@@ -0,0 +1,162 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "IO_compressed_file.hh"
+
+#include "testing/testing.h"
+
+#include "BKE_appdir.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_filereader.h"
+#include "BLI_path_util.h"
+#include "BLI_vector.hh"
+
+#include <string>
+
+namespace blender::io::tests {
+
+class CompressedFileTest : public testing::Test {
+ protected:
+  void SetUp() override
+  {
+    BKE_tempdir_init(nullptr);
+  }
+
+  void TearDown() override
+  {
+    BKE_tempdir_session_purge();
+  }
+
+  static std::string temp_filepath(const char *filename)
+  {
+    return std::string(BKE_tempdir_session()) + SEP_STR + filename;
+  }
+};
+
+/* Data that is larger than the internal buffers, and written in multiple calls. */
+static Vector<char> create_test_data()
+{
+  Vector<char> data;
+  for (int i = 0; i < 300000; i++) {
+    const std::string line = "v " + std::to_string(i) + " " + std::to_string(i % 97) + " 1.0\n";
+    data.extend(Span<char>(line.data(), line.size()));
+  }
+  return data;
+}
+
+static void write_file(const std::string &filepath, const Span<char> data)
+{
+  std::unique_ptr<FileWriter> writer = FileWriter::open(filepath.c_str());
+  ASSERT_NE(writer, nullptr);
+  const int64_t part_size = 12345;
+  for (int64_t start = 0; start < data.size(); start += part_size) {
+    const Span<char> part = data.slice(start, std::min(part_size, data.size() - start));
+    EXPECT_TRUE(writer->write(part.data(), part.size()));
+  }
+  EXPECT_TRUE(writer->close());
+}
+
+static Vector<char> read_file(const std::string &filepath, const int64_t expected_size)
+{
+  FileReader *reader = file_reader_open(filepath.c_str());
+  EXPECT_NE(reader, nullptr);
+  if (reader == nullptr) {
+    return {};
+  }
+  /* Read one more byte than expected, to check that the end of the file is reached. */
+  Vector<char> data(expected_size + 1);
+  data.resize(file_reader_read(reader, data.data(), data.size()));
+  reader->close(reader);
+  return data;
+}
+
+static void read_file_header(const std::string &filepath, char r_header[4])
+{
+  FILE *file = BLI_fopen(filepath.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(fread(r_header, 1, 4, file), 4);
+  fclose(file);
+}
+
+TEST(compressed_file, compression_from_path)
+{
+  EXPECT_EQ(file_compression_from_path("/tmp/file.obj"), FileCompression::None);
+  EXPECT_EQ(file_compression_from_path("/tmp/file.obj.gz"), FileCompression::Gzip);
+  EXPECT_EQ(file_compression_from_path("/tmp/file.OBJ.GZ"), FileCompression::Gzip);
+  EXPECT_EQ(file_compression_from_path("/tmp/file.ply.zst"), FileCompression::Zstd);
+  EXPECT_EQ(file_compression_from_path("/tmp/file.zst.ply"), FileCompression::None);
+}
+
+TEST_F(CompressedFileTest, uncompressed_round_trip)
+{
+  const Vector<char> data = create_test_data();
+  const std::string filepath = temp_filepath("uncompressed.obj");
+  write_file(filepath, data);
+
+  char header[4];
+  read_file_header(filepath, header);
+  EXPECT_FALSE(BLI_file_magic_is_gzip(header));
+  EXPECT_FALSE(BLI_file_magic_is_zstd(header));
+  EXPECT_EQ(BLI_file_size(filepath.c_str()), size_t(data.size()));
+
+  EXPECT_EQ(read_file(filepath, data.size()).as_span(), data.as_span());
+}
+
+TEST_F(CompressedFileTest, gzip_round_trip)
+{
+  const Vector<char> data = create_test_data();
+  const std::string filepath = temp_filepath("compressed.obj.gz");
+  write_file(filepath, data);
+
+  char header[4];
+  read_file_header(filepath, header);
+  EXPECT_TRUE(BLI_file_magic_is_gzip(header));
+  EXPECT_LT(BLI_file_size(filepath.c_str()), size_t(data.size()));
+
+  EXPECT_EQ(read_file(filepath, data.size()).as_span(), data.as_span());
+}
+
+TEST_F(CompressedFileTest, zstd_round_trip)
+{
+  const Vector<char> data = create_test_data();
+  const std::string filepath = temp_filepath("compressed.obj.zst");
+  write_file(filepath, data);
+
+  char header[4];
+  read_file_header(filepath, header);
+  EXPECT_TRUE(BLI_file_magic_is_zstd(header));
+  EXPECT_LT(BLI_file_size(filepath.c_str()), size_t(data.size()));
+
+  EXPECT_EQ(read_file(filepath, data.size()).as_span(), data.as_span());
+}
+
+TEST_F(CompressedFileTest, detect_compression_by_contents)
+{
+  /* The reader uses the magic bytes, not the extension. */
+  const Vector<char> data = create_test_data();
+  const std::string gzip_filepath = temp_filepath("compressed_gzip.obj.gz");
+  const std::string zstd_filepath = temp_filepath("compressed_zstd.obj.zst");
+  write_file(gzip_filepath, data);
+  write_file(zstd_filepath, data);
+
+  const std::string renamed_gzip_filepath = temp_filepath("compressed_gzip.obj");
+  const std::string renamed_zstd_filepath = temp_filepath("compressed_zstd.obj");
+  ASSERT_EQ(BLI_rename(gzip_filepath.c_str(), renamed_gzip_filepath.c_str()), 0);
+  ASSERT_EQ(BLI_rename(zstd_filepath.c_str(), renamed_zstd_filepath.c_str()), 0);
+
+  EXPECT_EQ(read_file(renamed_gzip_filepath, data.size()).as_span(), data.as_span());
+  EXPECT_EQ(read_file(renamed_zstd_filepath, data.size()).as_span(), data.as_span());
+}
+
+TEST_F(CompressedFileTest, empty_file)
+{
+  for (const char *filename : {"empty.obj", "empty.obj.gz", "empty.obj.zst"}) {
+    const std::string filepath = temp_filepath(filename);
+    write_file(filepath, {});
+    EXPECT_TRUE(read_file(filepath, 0).is_empty());
+  }
+}
+
+}  // namespace blender::io::tests
@@ -27,10 +27,28 @@
 
 namespace blender::io::ply {
 
-void exporter_main(bContext *C, const PLYExportParams &export_params)
+/**
+ * Write the PLY data of the meshes, loading only a bounded number of elements at a time, so
+ * that memory usage doesn't grow with the size of the exported meshes.
+ */
+static void write_meshes(FileBuffer &buffer,
+                         const PlyExportMeshes &meshes,
+                         const PLYExportParams &export_params)
 {
-  std::unique_ptr<blender::io::ply::PlyData> plyData = std::make_unique<PlyData>();
+  const int64_t chunk_size = 1024 * 1024;
+
+  write_header(buffer, meshes.layout(), export_params);
+
+  meshes.foreach_vertex_chunk(chunk_size,
+                              [&](const PlyData &chunk) { write_vertices(buffer, chunk); });
+
+  meshes.foreach_face_chunk(chunk_size, [&](const PlyData &chunk) { write_faces(buffer, chunk); });
+
+  meshes.foreach_edge_chunk(chunk_size, [&](const PlyData &chunk) { write_edges(buffer, chunk); });
+}
 
+void exporter_main(bContext *C, const PLYExportParams &export_params)
+{
   Depsgraph *depsgraph = nullptr;
   bool needs_free = false;
 
@@ -58,39 +76,37 @@ void exporter_main(bContext *C, const PLYExportParams &export_params)
     depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
   }
 
-  load_plydata(*plyData, depsgraph, export_params);
-
-  if (needs_free) {
-    DEG_graph_free(depsgraph);
-  }
+  /* The mesh data is loaded from the evaluated depsgraph while writing, so it is freed after
+   * the meshes have been written. */
+  {
+    const PlyExportMeshes meshes(depsgraph, export_params);
 
-  std::unique_ptr<FileBuffer> buffer;
+    std::unique_ptr<FileBuffer> buffer;
 
-  try {
-    if (export_params.ascii_format) {
-      buffer = std::make_unique<FileBufferAscii>(export_params.filepath);
+    try {
+      if (export_params.ascii_format) {
+        buffer = std::make_unique<FileBufferAscii>(export_params.filepath);
+      }
+      else {
+        buffer = std::make_unique<FileBufferBinary>(export_params.filepath);
+      }
     }
-    else {
-      buffer = std::make_unique<FileBufferBinary>(export_params.filepath);
+    catch (const std::system_error &ex) {
+      fprintf(stderr, "%s\n", ex.what());
+      BKE_reportf(export_params.reports,
+                  RPT_ERROR,
+                  "PLY Export: Cannot open file '%s'",
+                  export_params.filepath);
     }
-  }
-  catch (const std::system_error &ex) {
-    fprintf(stderr, "%s\n", ex.what());
-    BKE_reportf(export_params.reports,
-                RPT_ERROR,
-                "PLY Export: Cannot open file '%s'",
-                export_params.filepath);
-    return;
-  }
-
-  write_header(*buffer.get(), *plyData.get(), export_params);
-
-  write_vertices(*buffer.get(), *plyData.get());
 
-  write_faces(*buffer.get(), *plyData.get());
-
-  write_edges(*buffer.get(), *plyData.get());
+    if (buffer) {
+      write_meshes(*buffer, meshes, export_params);
+      buffer->close_file();
+    }
+  }
 
-  buffer->close_file();
+  if (needs_free) {
+    DEG_graph_free(depsgraph);
+  }
 }
 }  // namespace blender::io::ply
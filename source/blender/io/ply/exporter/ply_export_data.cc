@@ -10,53 +10,109 @@
 #include "ply_data.hh"
 #include "ply_file_buffer.hh"
 
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_math_base.h"
+#include "BLI_task.hh"
+
 namespace blender::io::ply {
 
+/**
+ * Format the elements into separate buffers in parallel, and write them to the file in order.
+ * This is done in batches, so that only part of the output is kept in memory at a time.
+ */
+static void write_elements_in_parallel(
+    FileBuffer &buffer,
+    const int64_t elements_num,
+    const FunctionRef<void(FileBuffer &chunk_buffer, IndexRange range)> write_fn)
+{
+  const int64_t chunk_size = 16 * 1024;
+  const int64_t batch_size = chunk_size * 64;
+  for (int64_t batch_start = 0; batch_start < elements_num; batch_start += batch_size) {
+    const IndexRange batch(batch_start, std::min(batch_size, elements_num - batch_start));
+    const int64_t chunks_num = divide_ceil_ul(batch.size(), chunk_size);
+    Array<std::unique_ptr<FileBuffer>> chunk_buffers(chunks_num);
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange chunks) {
+      for (const int64_t chunk : chunks) {
+        chunk_buffers[chunk] = buffer.create_memory_buffer();
+        write_fn(*chunk_buffers[chunk],
+                 batch.slice(chunk * chunk_size,
+                             std::min(chunk_size, batch.size() - chunk * chunk_size)));
+      }
+    });
+    for (std::unique_ptr<FileBuffer> &chunk_buffer : chunk_buffers) {
+      buffer.append_from(*chunk_buffer);
+    }
+    buffer.write_to_file();
+  }
+}
+
 void write_vertices(FileBuffer &buffer, const PlyData &ply_data)
 {
-  for (int i = 0; i < ply_data.vertices.size(); i++) {
-    buffer.write_vertex(ply_data.vertices[i].x, ply_data.vertices[i].y, ply_data.vertices[i].z);
+  write_elements_in_parallel(
+      buffer, ply_data.vertices.size(), [&](FileBuffer &chunk_buffer, const IndexRange range) {
+        for (const int i : range) {
+          chunk_buffer.write_vertex(
+              ply_data.vertices[i].x, ply_data.vertices[i].y, ply_data.vertices[i].z);
 
-    if (!ply_data.vertex_normals.is_empty()) {
-      buffer.write_vertex_normal(ply_data.vertex_normals[i].x,
-                                 ply_data.vertex_normals[i].y,
-                                 ply_data.vertex_normals[i].z);
-    }
+          if (!ply_data.vertex_normals.is_empty()) {
+            chunk_buffer.write_vertex_normal(ply_data.vertex_normals[i].x,
+                                             ply_data.vertex_normals[i].y,
+                                             ply_data.vertex_normals[i].z);
+          }
 
-    if (!ply_data.vertex_colors.is_empty()) {
-      buffer.write_vertex_color(uchar(ply_data.vertex_colors[i].x * 255),
-                                uchar(ply_data.vertex_colors[i].y * 255),
-                                uchar(ply_data.vertex_colors[i].z * 255),
-                                uchar(ply_data.vertex_colors[i].w * 255));
-    }
+          if (!ply_data.vertex_colors.is_empty()) {
+            chunk_buffer.write_vertex_color(uchar(ply_data.vertex_colors[i].x * 255),
+                                            uchar(ply_data.vertex_colors[i].y * 255),
+                                            uchar(ply_data.vertex_colors[i].z * 255),
+                                            uchar(ply_data.vertex_colors[i].w * 255));
+          }
 
-    if (!ply_data.uv_coordinates.is_empty()) {
-      buffer.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
-    }
+          if (!ply_data.uv_coordinates.is_empty()) {
+            chunk_buffer.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
+          }
 
-    for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
-      buffer.write_data(attr.data[i]);
-    }
+          for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
+            chunk_buffer.write_data(attr.data[i]);
+          }
 
-    buffer.write_vertex_end();
-  }
+          chunk_buffer.write_vertex_end();
+        }
+      });
   buffer.write_to_file();
 }
 
 void write_faces(FileBuffer &buffer, const PlyData &ply_data)
 {
-  const uint32_t *indices = ply_data.face_vertices.data();
-  for (uint32_t face_size : ply_data.face_sizes) {
-    buffer.write_face(char(face_size), Span<uint32_t>(indices, face_size));
-    indices += face_size;
+  /* The start of every face in the face vertex indices. */
+  Array<int64_t> face_offsets(ply_data.face_sizes.size());
+  int64_t offset = 0;
+  for (const int64_t i : ply_data.face_sizes.index_range()) {
+    face_offsets[i] = offset;
+    offset += ply_data.face_sizes[i];
   }
+
+  const Span<uint32_t> face_vertices = ply_data.face_vertices;
+  write_elements_in_parallel(
+      buffer, ply_data.face_sizes.size(), [&](FileBuffer &chunk_buffer, const IndexRange range) {
+        for (const int64_t i : range) {
+          const uint32_t face_size = ply_data.face_sizes[i];
+          chunk_buffer.write_face(char(face_size),
+                                  face_vertices.slice(face_offsets[i], face_size));
+        }
+      });
   buffer.write_to_file();
 }
+
 void write_edges(FileBuffer &buffer, const PlyData &ply_data)
 {
-  for (const std::pair<int, int> &edge : ply_data.edges) {
-    buffer.write_edge(edge.first, edge.second);
-  }
+  write_elements_in_parallel(
+      buffer, ply_data.edges.size(), [&](FileBuffer &chunk_buffer, const IndexRange range) {
+        for (const int64_t i : range) {
+          chunk_buffer.write_edge(ply_data.edges[i].first, ply_data.edges[i].second);
+        }
+      });
   buffer.write_to_file();
 }
+
 }  // namespace blender::io::ply
@@ -16,7 +16,7 @@
 namespace blender::io::ply {
 
 void write_header(FileBuffer &buffer,
-                  const PlyData &ply_data,
+                  const PlyExportLayout &layout,
                   const PLYExportParams &export_params)
 {
   buffer.write_string("ply");
@@ -27,40 +27,40 @@ void write_header(FileBuffer &buffer,
   StringRef version = BKE_blender_version_string();
   buffer.write_string("comment Created in Blender version " + version);
 
-  buffer.write_header_element("vertex", int32_t(ply_data.vertices.size()));
+  buffer.write_header_element("vertex", int32_t(layout.vertices_num));
   buffer.write_header_scalar_property("float", "x");
   buffer.write_header_scalar_property("float", "y");
   buffer.write_header_scalar_property("float", "z");
 
-  if (!ply_data.vertex_normals.is_empty()) {
+  if (layout.has_normals) {
     buffer.write_header_scalar_property("float", "nx");
     buffer.write_header_scalar_property("float", "ny");
     buffer.write_header_scalar_property("float", "nz");
   }
 
-  if (!ply_data.vertex_colors.is_empty()) {
+  if (layout.has_colors) {
     buffer.write_header_scalar_property("uchar", "red");
     buffer.write_header_scalar_property("uchar", "green");
     buffer.write_header_scalar_property("uchar", "blue");
     buffer.write_header_scalar_property("uchar", "alpha");
   }
 
-  if (!ply_data.uv_coordinates.is_empty()) {
+  if (layout.has_uvs) {
     buffer.write_header_scalar_property("float", "s");
     buffer.write_header_scalar_property("float", "t");
   }
 
-  for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
-    buffer.write_header_scalar_property("float", attr.name);
+  for (const std::string &name : layout.custom_attribute_names) {
+    buffer.write_header_scalar_property("float", name);
   }
 
-  if (!ply_data.face_sizes.is_empty()) {
-    buffer.write_header_element("face", int(ply_data.face_sizes.size()));
+  if (layout.faces_num > 0) {
+    buffer.write_header_element("face", int(layout.faces_num));
     buffer.write_header_list_property("uchar", "uint", "vertex_indices");
   }
 
-  if (!ply_data.edges.is_empty()) {
-    buffer.write_header_element("edge", int(ply_data.edges.size()));
+  if (layout.edges_num > 0) {
+    buffer.write_header_element("edge", int(layout.edges_num));
     buffer.write_header_scalar_property("int", "vertex1");
     buffer.write_header_scalar_property("int", "vertex2");
   }
@@ -69,4 +69,21 @@ void write_header(FileBuffer &buffer,
   buffer.write_to_file();
 }
 
+void write_header(FileBuffer &buffer,
+                  const PlyData &ply_data,
+                  const PLYExportParams &export_params)
+{
+  PlyExportLayout layout;
+  layout.vertices_num = ply_data.vertices.size();
+  layout.faces_num = ply_data.face_sizes.size();
+  layout.edges_num = ply_data.edges.size();
+  layout.has_normals = !ply_data.vertex_normals.is_empty();
+  layout.has_colors = !ply_data.vertex_colors.is_empty();
+  layout.has_uvs = !ply_data.uv_coordinates.is_empty();
+  for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
+    layout.custom_attribute_names.append(attr.name);
+  }
+  write_header(buffer, layout, export_params);
+}
+
 }  // namespace blender::io::ply
@@ -14,6 +14,11 @@ namespace blender::io::ply {
 
 class FileBuffer;
 struct PlyData;
+struct PlyExportLayout;
+
+void write_header(FileBuffer &buffer,
+                  const PlyExportLayout &layout,
+                  const PLYExportParams &export_params);
 
 void write_header(FileBuffer &buffer,
                   const PlyData &ply_data,
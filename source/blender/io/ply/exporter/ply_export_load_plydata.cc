@@ -15,12 +15,17 @@
 #include "BKE_mesh.hh"
 #include "BKE_mesh_wrapper.hh"
 #include "BKE_object.hh"
+#include "BLI_array.hh"
+#include "BLI_bit_vector.hh"
 #include "BLI_color.hh"
+#include "BLI_function_ref.hh"
 #include "BLI_hash.hh"
 #include "BLI_math_matrix.h"
 #include "BLI_math_quaternion_types.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_set.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "DEG_depsgraph_query.hh"
@@ -85,6 +90,19 @@ struct uv_vertex_key {
   }
 };
 
+/** The UV map exported for the mesh, empty when UVs are not exported. */
+static VArray<float2> get_export_uv_map(const Mesh &mesh, const PLYExportParams &export_params)
+{
+  if (!export_params.export_uv) {
+    return {};
+  }
+  const StringRef uv_name = CustomData_get_active_layer_name(&mesh.corner_data, CD_PROP_FLOAT2);
+  if (uv_name.is_empty()) {
+    return {};
+  }
+  return *mesh.attributes().lookup<float2>(uv_name, bke::AttrDomain::Corner);
+}
+
 static void generate_vertex_map(const Mesh *mesh,
                                 const PLYExportParams &export_params,
                                 Vector<int> &r_ply_to_vertex,
@@ -92,34 +110,18 @@ static void generate_vertex_map(const Mesh *mesh,
                                 Vector<int> &r_loop_to_ply,
                                 Vector<float2> &r_uvs)
 {
-  bool export_uv = false;
-  VArraySpan<float2> uv_map;
-  if (export_params.export_uv) {
-    const StringRef uv_name = CustomData_get_active_layer_name(&mesh->corner_data, CD_PROP_FLOAT2);
-    if (!uv_name.is_empty()) {
-      const bke::AttributeAccessor attributes = mesh->attributes();
-      uv_map = *attributes.lookup<float2>(uv_name, bke::AttrDomain::Corner);
-      export_uv = !uv_map.is_empty();
-    }
+  const VArraySpan<float2> uv_map = get_export_uv_map(*mesh, export_params);
+
+  /* If we do not export or have UVs, then PLY vertices are the mesh vertices, and the mappings
+   * are left empty. */
+  if (uv_map.is_empty()) {
+    return;
   }
 
   const Span<int> corner_verts = mesh->corner_verts();
   r_vertex_to_ply.resize(mesh->verts_num, -1);
   r_loop_to_ply.resize(mesh->corners_num, -1);
 
-  /* If we do not export or have UVs, then mapping of vertex indices is simple. */
-  if (!export_uv) {
-    r_ply_to_vertex.resize(mesh->verts_num);
-    for (int index = 0; index < mesh->verts_num; index++) {
-      r_vertex_to_ply[index] = index;
-      r_ply_to_vertex[index] = index;
-    }
-    for (int index = 0; index < mesh->corners_num; index++) {
-      r_loop_to_ply[index] = corner_verts[index];
-    }
-    return;
-  }
-
   /* We are exporting UVs. Need to build mappings of what
    * any unique (vertex, UV) values will map into the PLY data. */
   Map<uv_vertex_key, int> vertex_map;
@@ -151,52 +153,113 @@ static void generate_vertex_map(const Mesh *mesh,
   }
 }
 
-static float *find_or_add_attribute(const StringRef name,
-                                    int64_t size,
-                                    uint32_t vertex_offset,
-                                    Vector<PlyCustomAttribute> &r_attributes)
+/**
+ * The number of PLY vertices #generate_vertex_map creates for the mesh, without building the
+ * mappings.
+ */
+static int64_t count_ply_vertices(const Mesh &mesh, const PLYExportParams &export_params)
 {
-  /* Do we have this attribute from some other object already? */
-  for (PlyCustomAttribute &attr : r_attributes) {
-    if (attr.name == name) {
-      BLI_assert(attr.data.size() == vertex_offset);
-      attr.data.resize(attr.data.size() + size, 0.0f);
-      return attr.data.data() + vertex_offset;
+  const VArraySpan<float2> uv_map = get_export_uv_map(mesh, export_params);
+  if (uv_map.is_empty()) {
+    return mesh.verts_num;
+  }
+
+  const Span<int> corner_verts = mesh.corner_verts();
+  Set<uv_vertex_key> unique_keys;
+  unique_keys.reserve(mesh.verts_num);
+  BitVector<> used_verts(mesh.verts_num, false);
+  for (const int corner : corner_verts.index_range()) {
+    const int vert = corner_verts[corner];
+    unique_keys.add({uv_map[corner], vert});
+    used_verts[vert].set();
+  }
+
+  /* Loose vertices are exported with zero UVs. */
+  int64_t loose_verts_num = 0;
+  for (const int vert : IndexRange(mesh.verts_num)) {
+    if (!used_verts[vert]) {
+      loose_verts_num++;
     }
   }
-  /* We don't have it yet, create and fill with zero data for previous objects. */
-  r_attributes.append(PlyCustomAttribute(name, vertex_offset + size));
-  return r_attributes.last().data.data() + vertex_offset;
+  return unique_keys.size() + loose_verts_num;
 }
 
-static void load_custom_attributes(const Mesh *mesh,
-                                   const Span<int> ply_to_vertex,
-                                   uint32_t vertex_offset,
-                                   Vector<PlyCustomAttribute> &r_attributes)
+/** Call the function for every attribute that is exported as custom PLY vertex properties. */
+static void foreach_custom_attribute(
+    const Mesh &mesh,
+    const FunctionRef<void(const bke::AttributeIDRef &attribute_id,
+                           const bke::AttributeMetaData &meta_data)> fn)
 {
-  const bke::AttributeAccessor attributes = mesh->attributes();
-  const StringRef color_name = mesh->active_color_attribute;
-  const StringRef uv_name = CustomData_get_active_layer_name(&mesh->corner_data, CD_PROP_FLOAT2);
-  const int64_t size = ply_to_vertex.size();
+  const StringRef color_name = mesh.active_color_attribute;
+  const StringRef uv_name = CustomData_get_active_layer_name(&mesh.corner_data, CD_PROP_FLOAT2);
 
-  attributes.for_all([&](const bke::AttributeIDRef &attribute_id,
-                         const bke::AttributeMetaData &meta_data) {
+  mesh.attributes().for_all([&](const bke::AttributeIDRef &attribute_id,
+                                const bke::AttributeMetaData &meta_data) {
     /* Skip internal, standard and non-vertex domain attributes. */
     if (meta_data.domain != bke::AttrDomain::Point || attribute_id.name()[0] == '.' ||
         attribute_id.is_anonymous() || ELEM(attribute_id.name(), "position", color_name, uv_name))
     {
       return true;
     }
+    fn(attribute_id, meta_data);
+    return true;
+  });
+}
+
+/** Names of the PLY properties an attribute is exported to, one for every component. */
+static Vector<std::string> custom_attribute_names(const StringRef name,
+                                                  const eCustomDataType data_type)
+{
+  switch (data_type) {
+    case CD_PROP_FLOAT:
+    case CD_PROP_INT8:
+    case CD_PROP_INT32:
+    case CD_PROP_BOOL:
+      return {std::string(name)};
+    case CD_PROP_INT32_2D:
+    case CD_PROP_FLOAT2:
+      return {name + "_x", name + "_y"};
+    case CD_PROP_FLOAT3:
+      return {name + "_x", name + "_y", name + "_z"};
+    case CD_PROP_BYTE_COLOR:
+    case CD_PROP_COLOR:
+      return {name + "_r", name + "_g", name + "_b", name + "_a"};
+    case CD_PROP_QUATERNION:
+      return {name + "_x", name + "_y", name + "_z", name + "_w"};
+    default:
+      return {};
+  }
+}
 
+static float *find_attribute(const StringRef name, Vector<PlyCustomAttribute> &r_attributes)
+{
+  for (PlyCustomAttribute &attr : r_attributes) {
+    if (attr.name == name) {
+      return attr.data.data();
+    }
+  }
+  BLI_assert_unreachable();
+  return nullptr;
+}
+
+/**
+ * Load the custom attributes of the given mesh vertices into attributes that have been created
+ * for all names returned by #custom_attribute_names.
+ */
+static void load_custom_attributes(const Mesh *mesh,
+                                   const Span<int> ply_to_vertex,
+                                   Vector<PlyCustomAttribute> &r_attributes)
+{
+  foreach_custom_attribute(*mesh, [&](const bke::AttributeIDRef &attribute_id,
+                                      const bke::AttributeMetaData &meta_data) {
     const GVArraySpan attribute = *mesh->attributes().lookup(
         attribute_id, meta_data.domain, meta_data.data_type);
     if (attribute.is_empty()) {
-      return true;
+      return;
     }
     switch (meta_data.data_type) {
       case CD_PROP_FLOAT: {
-        float *attr = find_or_add_attribute(
-            attribute_id.name(), size, vertex_offset, r_attributes);
+        float *attr = find_attribute(attribute_id.name(), r_attributes);
         auto typed = attribute.typed<float>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           attr[i] = typed[ply_to_vertex[i]];
@@ -204,8 +267,7 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_INT8: {
-        float *attr = find_or_add_attribute(
-            attribute_id.name(), size, vertex_offset, r_attributes);
+        float *attr = find_attribute(attribute_id.name(), r_attributes);
         auto typed = attribute.typed<int8_t>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           attr[i] = typed[ply_to_vertex[i]];
@@ -213,8 +275,7 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_INT32: {
-        float *attr = find_or_add_attribute(
-            attribute_id.name(), size, vertex_offset, r_attributes);
+        float *attr = find_attribute(attribute_id.name(), r_attributes);
         auto typed = attribute.typed<int32_t>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           attr[i] = typed[ply_to_vertex[i]];
@@ -222,10 +283,8 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_INT32_2D: {
-        float *attr_x = find_or_add_attribute(
-            attribute_id.name() + "_x", size, vertex_offset, r_attributes);
-        float *attr_y = find_or_add_attribute(
-            attribute_id.name() + "_y", size, vertex_offset, r_attributes);
+        float *attr_x = find_attribute(attribute_id.name() + "_x", r_attributes);
+        float *attr_y = find_attribute(attribute_id.name() + "_y", r_attributes);
         auto typed = attribute.typed<int2>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           int j = ply_to_vertex[i];
@@ -235,10 +294,8 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_FLOAT2: {
-        float *attr_x = find_or_add_attribute(
-            attribute_id.name() + "_x", size, vertex_offset, r_attributes);
-        float *attr_y = find_or_add_attribute(
-            attribute_id.name() + "_y", size, vertex_offset, r_attributes);
+        float *attr_x = find_attribute(attribute_id.name() + "_x", r_attributes);
+        float *attr_y = find_attribute(attribute_id.name() + "_y", r_attributes);
         auto typed = attribute.typed<float2>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           int j = ply_to_vertex[i];
@@ -248,12 +305,9 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_FLOAT3: {
-        float *attr_x = find_or_add_attribute(
-            attribute_id.name() + "_x", size, vertex_offset, r_attributes);
-        float *attr_y = find_or_add_attribute(
-            attribute_id.name() + "_y", size, vertex_offset, r_attributes);
-        float *attr_z = find_or_add_attribute(
-            attribute_id.name() + "_z", size, vertex_offset, r_attributes);
+        float *attr_x = find_attribute(attribute_id.name() + "_x", r_attributes);
+        float *attr_y = find_attribute(attribute_id.name() + "_y", r_attributes);
+        float *attr_z = find_attribute(attribute_id.name() + "_z", r_attributes);
         auto typed = attribute.typed<float3>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           int j = ply_to_vertex[i];
@@ -264,14 +318,10 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_BYTE_COLOR: {
-        float *attr_r = find_or_add_attribute(
-            attribute_id.name() + "_r", size, vertex_offset, r_attributes);
-        float *attr_g = find_or_add_attribute(
-            attribute_id.name() + "_g", size, vertex_offset, r_attributes);
-        float *attr_b = find_or_add_attribute(
-            attribute_id.name() + "_b", size, vertex_offset, r_attributes);
-        float *attr_a = find_or_add_attribute(
-            attribute_id.name() + "_a", size, vertex_offset, r_attributes);
+        float *attr_r = find_attribute(attribute_id.name() + "_r", r_attributes);
+        float *attr_g = find_attribute(attribute_id.name() + "_g", r_attributes);
+        float *attr_b = find_attribute(attribute_id.name() + "_b", r_attributes);
+        float *attr_a = find_attribute(attribute_id.name() + "_a", r_attributes);
         auto typed = attribute.typed<ColorGeometry4b>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           ColorGeometry4f col = typed[ply_to_vertex[i]].decode();
@@ -283,14 +333,10 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_COLOR: {
-        float *attr_r = find_or_add_attribute(
-            attribute_id.name() + "_r", size, vertex_offset, r_attributes);
-        float *attr_g = find_or_add_attribute(
-            attribute_id.name() + "_g", size, vertex_offset, r_attributes);
-        float *attr_b = find_or_add_attribute(
-            attribute_id.name() + "_b", size, vertex_offset, r_attributes);
-        float *attr_a = find_or_add_attribute(
-            attribute_id.name() + "_a", size, vertex_offset, r_attributes);
+        float *attr_r = find_attribute(attribute_id.name() + "_r", r_attributes);
+        float *attr_g = find_attribute(attribute_id.name() + "_g", r_attributes);
+        float *attr_b = find_attribute(attribute_id.name() + "_b", r_attributes);
+        float *attr_a = find_attribute(attribute_id.name() + "_a", r_attributes);
         auto typed = attribute.typed<ColorGeometry4f>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           ColorGeometry4f col = typed[ply_to_vertex[i]];
@@ -302,8 +348,7 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_BOOL: {
-        float *attr = find_or_add_attribute(
-            attribute_id.name(), size, vertex_offset, r_attributes);
+        float *attr = find_attribute(attribute_id.name(), r_attributes);
         auto typed = attribute.typed<bool>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           attr[i] = typed[ply_to_vertex[i]] ? 1.0f : 0.0f;
@@ -311,14 +356,10 @@ static void load_custom_attributes(const Mesh *mesh,
         break;
       }
       case CD_PROP_QUATERNION: {
-        float *attr_x = find_or_add_attribute(
-            attribute_id.name() + "_x", size, vertex_offset, r_attributes);
-        float *attr_y = find_or_add_attribute(
-            attribute_id.name() + "_y", size, vertex_offset, r_attributes);
-        float *attr_z = find_or_add_attribute(
-            attribute_id.name() + "_z", size, vertex_offset, r_attributes);
-        float *attr_w = find_or_add_attribute(
-            attribute_id.name() + "_w", size, vertex_offset, r_attributes);
+        float *attr_x = find_attribute(attribute_id.name() + "_x", r_attributes);
+        float *attr_y = find_attribute(attribute_id.name() + "_y", r_attributes);
+        float *attr_z = find_attribute(attribute_id.name() + "_z", r_attributes);
+        float *attr_w = find_attribute(attribute_id.name() + "_w", r_attributes);
         auto typed = attribute.typed<math::Quaternion>();
         for (const int64_t i : ply_to_vertex.index_range()) {
           int j = ply_to_vertex[i];
@@ -332,11 +373,200 @@ static void load_custom_attributes(const Mesh *mesh,
       default:
         BLI_assert_msg(0, "Unsupported attribute type for PLY export.");
     }
-    return true;
   });
 }
 
-void load_plydata(PlyData &plyData, Depsgraph *depsgraph, const PLYExportParams &export_params)
+/**
+ * Exported object. Only the number of its PLY elements is known up front, its mesh is prepared
+ * for export (see #PlyExportMesh) while the elements are loaded.
+ */
+struct PlyExportObject {
+  /** Exported mesh, either the evaluated mesh or #triangulated_mesh. */
+  const Mesh *mesh = nullptr;
+  /**
+   * Triangulated copy of the evaluated mesh owned by the export. Triangulating is expensive, so
+   * it is only done once when the elements are counted, and the copy is used by all passes.
+   */
+  Mesh *triangulated_mesh = nullptr;
+
+  float world_and_axes_transform[4][4];
+  float world_and_axes_normal_transform[3][3];
+
+  /** Index of the first PLY vertex of this object in the exported data. */
+  uint32_t vertex_offset = 0;
+  int64_t vertices_num = 0;
+  int64_t faces_num = 0;
+  int64_t loose_edges_num = 0;
+
+  ~PlyExportObject()
+  {
+    if (triangulated_mesh) {
+      BKE_id_free(nullptr, triangulated_mesh);
+    }
+  }
+};
+
+/**
+ * Mesh of an exported object with the mappings between PLY and mesh vertices. Only one of these
+ * exists at a time, so that the memory used for the mappings doesn't grow with the number of
+ * exported objects.
+ */
+struct PlyExportMesh {
+  const PlyExportObject &object;
+  const Mesh *mesh = nullptr;
+
+  /** Mappings between PLY and mesh vertices, empty when they are the same. */
+  Vector<int> ply_to_vertex;
+  Vector<int> vertex_to_ply;
+  Vector<int> loop_to_ply;
+  Vector<float2> uvs;
+
+  PlyExportMesh(const PlyExportObject &object, const PLYExportParams &export_params)
+      : object(object), mesh(object.mesh)
+  {
+    generate_vertex_map(mesh, export_params, ply_to_vertex, vertex_to_ply, loop_to_ply, uvs);
+  }
+
+  int64_t vertices_num() const
+  {
+    return ply_to_vertex.is_empty() ? mesh->verts_num : ply_to_vertex.size();
+  }
+  int mesh_vertex(const int ply_index) const
+  {
+    return ply_to_vertex.is_empty() ? ply_index : ply_to_vertex[ply_index];
+  }
+  int ply_vertex(const int vertex) const
+  {
+    return vertex_to_ply.is_empty() ? vertex : vertex_to_ply[vertex];
+  }
+};
+
+static bool has_vertex_colors(const Mesh &mesh, const PLYExportParams &export_params)
+{
+  return export_params.vertex_colors != PLY_VERTEX_COLOR_NONE &&
+         mesh.active_color_attribute != nullptr && mesh.active_color_attribute[0] != '\0' &&
+         mesh.verts_num > 0;
+}
+
+static void load_vertices(const PlyExportMesh &export_mesh,
+                          const IndexRange range,
+                          const PlyExportLayout &layout,
+                          const PLYExportParams &export_params,
+                          PlyData &r_data)
+{
+  const Mesh &mesh = *export_mesh.mesh;
+
+  Array<int> vertices(range.size());
+  for (const int64_t i : range.index_range()) {
+    vertices[i] = export_mesh.mesh_vertex(range[i]);
+  }
+
+  /* Vertices */
+  r_data.vertices.resize(range.size());
+  const Span<float3> vert_positions = mesh.vert_positions();
+  threading::parallel_for(vertices.index_range(), 4096, [&](const IndexRange chunk) {
+    for (const int64_t i : chunk) {
+      float3 pos = vert_positions[vertices[i]];
+      mul_m4_v3(export_mesh.object.world_and_axes_transform, pos);
+      mul_v3_fl(pos, export_params.global_scale);
+      r_data.vertices[i] = pos;
+    }
+  });
+
+  /* UV's */
+  if (layout.has_uvs) {
+    if (export_mesh.uvs.is_empty()) {
+      r_data.uv_coordinates.append_n_times(float2(0), range.size());
+    }
+    else {
+      r_data.uv_coordinates.extend(export_mesh.uvs.as_span().slice(range));
+    }
+  }
+
+  /* Normals */
+  if (layout.has_normals) {
+    r_data.vertex_normals.resize(range.size());
+    const Span<float3> vert_normals = mesh.vert_normals();
+    threading::parallel_for(vertices.index_range(), 4096, [&](const IndexRange chunk) {
+      for (const int64_t i : chunk) {
+        float3 normal = vert_normals[vertices[i]];
+        mul_m3_v3(export_mesh.object.world_and_axes_normal_transform, normal);
+        r_data.vertex_normals[i] = normal;
+      }
+    });
+  }
+
+  /* Colors */
+  if (layout.has_colors) {
+    if (has_vertex_colors(mesh, export_params)) {
+      const bke::AttributeAccessor attributes = mesh.attributes();
+      const VArray color_attribute = *attributes.lookup_or_default<ColorGeometry4f>(
+          mesh.active_color_attribute, bke::AttrDomain::Point, {0.0f, 0.0f, 0.0f, 0.0f});
+      r_data.vertex_colors.resize(range.size());
+      for (const int64_t i : vertices.index_range()) {
+        float4 color = float4(color_attribute[vertices[i]]);
+        if (export_params.vertex_colors == PLY_VERTEX_COLOR_SRGB) {
+          linearrgb_to_srgb_v4(color, color);
+        }
+        r_data.vertex_colors[i] = color;
+      }
+    }
+    else {
+      r_data.vertex_colors.append_n_times(float4(0), range.size());
+    }
+  }
+
+  /* Custom attributes */
+  if (!layout.custom_attribute_names.is_empty()) {
+    for (const std::string &name : layout.custom_attribute_names) {
+      r_data.vertex_custom_attr.append(PlyCustomAttribute(name, range.size()));
+    }
+    load_custom_attributes(&mesh, vertices, r_data.vertex_custom_attr);
+  }
+}
+
+static void load_faces(const PlyExportMesh &export_mesh, const IndexRange range, PlyData &r_data)
+{
+  const Mesh &mesh = *export_mesh.mesh;
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const IndexRange corners = IndexRange::from_begin_end(faces[range.first()].start(),
+                                                        faces[range.last()].one_after_last());
+
+  r_data.face_sizes.resize(range.size());
+  for (const int64_t i : range.index_range()) {
+    r_data.face_sizes[i] = faces[range[i]].size();
+  }
+
+  r_data.face_vertices.resize(corners.size());
+  for (const int64_t i : corners.index_range()) {
+    const int corner = corners[i];
+    const int ply_index = export_mesh.loop_to_ply.is_empty() ? corner_verts[corner] :
+                                                               export_mesh.loop_to_ply[corner];
+    BLI_assert(ply_index >= 0 && ply_index < export_mesh.object.vertices_num);
+    r_data.face_vertices[i] = ply_index + export_mesh.object.vertex_offset;
+  }
+}
+
+/** Load the loose edges among the given mesh edges. */
+static void load_loose_edges(const PlyExportMesh &export_mesh,
+                             const IndexRange range,
+                             PlyData &r_data)
+{
+  const Mesh &mesh = *export_mesh.mesh;
+  const bke::LooseEdgeCache &loose_edges = mesh.loose_edges();
+  const Span<int2> edges = mesh.edges();
+  for (const int i : range) {
+    if (loose_edges.is_loose_bits[i]) {
+      const int vertex_offset = int(export_mesh.object.vertex_offset);
+      r_data.edges.append({vertex_offset + export_mesh.ply_vertex(edges[i][0]),
+                           vertex_offset + export_mesh.ply_vertex(edges[i][1])});
+    }
+  }
+}
+
+PlyExportMeshes::PlyExportMeshes(Depsgraph *depsgraph, const PLYExportParams &export_params)
+    : export_params_(export_params)
 {
   DEGObjectIterSettings deg_iter_settings{};
   deg_iter_settings.depsgraph = depsgraph;
@@ -344,9 +574,6 @@ void load_plydata(PlyData &plyData, Depsgraph *depsgraph, const PLYExportParams
                             DEG_ITER_OBJECT_FLAG_LINKED_VIA_SET | DEG_ITER_OBJECT_FLAG_VISIBLE |
                             DEG_ITER_OBJECT_FLAG_DUPLI;
 
-  /* When exporting multiple objects, vertex indices have to be offset. */
-  uint32_t vertex_offset = 0;
-
   DEG_OBJECT_ITER_BEGIN (&deg_iter_settings, object) {
     if (object->type != OB_MESH) {
       continue;
@@ -364,7 +591,7 @@ void load_plydata(PlyData &plyData, Depsgraph *depsgraph, const PLYExportParams
     BKE_mesh_wrapper_ensure_mdata(mesh);
 
     bool force_triangulation = false;
-    OffsetIndices faces = mesh->faces();
+    const OffsetIndices faces = mesh->faces();
     for (const int i : faces.index_range()) {
       if (faces[i].size() > 255) {
         force_triangulation = true;
@@ -372,127 +599,150 @@ void load_plydata(PlyData &plyData, Depsgraph *depsgraph, const PLYExportParams
       }
     }
 
-    /* Triangulate */
-    bool manually_free_mesh = false;
+    std::unique_ptr<PlyExportObject> export_object = std::make_unique<PlyExportObject>();
+    export_object->mesh = mesh;
     if (export_params.export_triangulated_mesh || force_triangulation) {
-      mesh = do_triangulation(mesh, export_params.export_triangulated_mesh);
-      faces = mesh->faces();
-      manually_free_mesh = true;
+      export_object->triangulated_mesh = do_triangulation(mesh,
+                                                          export_params.export_triangulated_mesh);
+      export_object->mesh = export_object->triangulated_mesh;
     }
 
-    Vector<int> ply_to_vertex, vertex_to_ply, loop_to_ply;
-    Vector<float2> uvs;
-    generate_vertex_map(mesh, export_params, ply_to_vertex, vertex_to_ply, loop_to_ply, uvs);
-
-    float world_and_axes_transform[4][4];
-    float world_and_axes_normal_transform[3][3];
+    /* The object itself may be a temporary dupli object, so the transform is stored. */
     set_world_axes_transform(*obj_eval,
                              export_params.forward_axis,
                              export_params.up_axis,
-                             world_and_axes_transform,
-                             world_and_axes_normal_transform);
-
-    /* Face data. */
-    plyData.face_vertices.reserve(plyData.face_vertices.size() + mesh->corners_num);
-    for (const int corner : IndexRange(mesh->corners_num)) {
-      int ply_index = loop_to_ply[corner];
-      BLI_assert(ply_index >= 0 && ply_index < ply_to_vertex.size());
-      plyData.face_vertices.append_unchecked(ply_index + vertex_offset);
-    }
+                             export_object->world_and_axes_transform,
+                             export_object->world_and_axes_normal_transform);
+
+    /* Only count the elements here, the vertex mappings are built again while the mesh is
+     * written. Triangulation may remove duplicate faces, so the triangulated mesh is counted. */
+    const Mesh &export_mesh = *export_object->mesh;
+    export_object->vertices_num = count_ply_vertices(export_mesh, export_params);
+    export_object->faces_num = export_mesh.faces_num;
+    export_object->loose_edges_num = export_mesh.loose_edges().count;
+    export_object->vertex_offset = uint32_t(layout_.vertices_num);
+
+    layout_.vertices_num += export_object->vertices_num;
+    layout_.faces_num += export_object->faces_num;
+    layout_.edges_num += export_object->loose_edges_num;
+    layout_.has_uvs |= !get_export_uv_map(*mesh, export_params).is_empty() &&
+                       export_object->vertices_num > 0;
+    layout_.has_colors |= has_vertex_colors(*mesh, export_params);
 
-    plyData.face_sizes.reserve(plyData.face_sizes.size() + mesh->faces_num);
-    for (const int i : faces.index_range()) {
-      const IndexRange face = faces[i];
-      plyData.face_sizes.append_unchecked(face.size());
+    if (export_params.export_attributes) {
+      foreach_custom_attribute(
+          *mesh,
+          [&](const bke::AttributeIDRef &attribute_id, const bke::AttributeMetaData &meta_data) {
+            for (const std::string &name :
+                 custom_attribute_names(attribute_id.name(), meta_data.data_type))
+            {
+              layout_.custom_attribute_names.append_non_duplicates(name);
+            }
+          });
     }
 
-    /* Vertices */
-    plyData.vertices.reserve(plyData.vertices.size() + ply_to_vertex.size());
-    Span<float3> vert_positions = mesh->vert_positions();
-    for (int vertex_index : ply_to_vertex) {
-      float3 pos = vert_positions[vertex_index];
-      mul_m4_v3(world_and_axes_transform, pos);
-      mul_v3_fl(pos, export_params.global_scale);
-      plyData.vertices.append_unchecked(pos);
-    }
+    objects_.append(std::move(export_object));
+  }
+
+  DEG_OBJECT_ITER_END;
+
+  layout_.has_normals = export_params.export_normals && layout_.vertices_num > 0;
+}
 
-    /* UV's */
-    if (uvs.is_empty()) {
-      uvs.append_n_times(float2(0), ply_to_vertex.size());
+PlyExportMeshes::~PlyExportMeshes() = default;
+
+const PlyExportLayout &PlyExportMeshes::layout() const
+{
+  return layout_;
+}
+
+void PlyExportMeshes::foreach_vertex_chunk(const int64_t chunk_size,
+                                           const FunctionRef<void(const PlyData &chunk)> fn) const
+{
+  for (const std::unique_ptr<PlyExportObject> &export_object : objects_) {
+    if (export_object->vertices_num == 0) {
+      continue;
     }
-    else {
-      BLI_assert(uvs.size() == ply_to_vertex.size());
-      plyData.uv_coordinates.extend(uvs);
+    const PlyExportMesh export_mesh(*export_object, export_params_);
+    BLI_assert(export_mesh.vertices_num() == export_object->vertices_num);
+    const IndexRange vertices(export_object->vertices_num);
+    for (int64_t start = 0; start < vertices.size(); start += chunk_size) {
+      PlyData chunk;
+      load_vertices(export_mesh,
+                    vertices.slice(start, std::min(chunk_size, vertices.size() - start)),
+                    layout_,
+                    export_params_,
+                    chunk);
+      fn(chunk);
     }
+  }
+}
 
-    /* Normals */
-    if (export_params.export_normals) {
-      plyData.vertex_normals.reserve(plyData.vertex_normals.size() + ply_to_vertex.size());
-      const Span<float3> vert_normals = mesh->vert_normals();
-      for (int vertex_index : ply_to_vertex) {
-        float3 normal = vert_normals[vertex_index];
-        mul_m3_v3(world_and_axes_normal_transform, normal);
-        plyData.vertex_normals.append(normal);
-      }
+void PlyExportMeshes::foreach_face_chunk(const int64_t chunk_size,
+                                         const FunctionRef<void(const PlyData &chunk)> fn) const
+{
+  for (const std::unique_ptr<PlyExportObject> &export_object : objects_) {
+    if (export_object->faces_num == 0) {
+      continue;
     }
-
-    /* Colors */
-    if (export_params.vertex_colors != PLY_VERTEX_COLOR_NONE) {
-      const StringRef name = mesh->active_color_attribute;
-      if (!name.is_empty()) {
-        const bke::AttributeAccessor attributes = mesh->attributes();
-        const VArray color_attribute = *attributes.lookup_or_default<ColorGeometry4f>(
-            name, bke::AttrDomain::Point, {0.0f, 0.0f, 0.0f, 0.0f});
-        if (!color_attribute.is_empty()) {
-          if (plyData.vertex_colors.size() != vertex_offset) {
-            plyData.vertex_colors.resize(vertex_offset, float4(0));
-          }
-
-          plyData.vertex_colors.reserve(vertex_offset + ply_to_vertex.size());
-          for (int vertex_index : ply_to_vertex) {
-            float4 color = float4(color_attribute[vertex_index]);
-            if (export_params.vertex_colors == PLY_VERTEX_COLOR_SRGB) {
-              linearrgb_to_srgb_v4(color, color);
-            }
-            plyData.vertex_colors.append(color);
-          }
-        }
-      }
+    const PlyExportMesh export_mesh(*export_object, export_params_);
+    BLI_assert(export_mesh.mesh->faces_num == export_object->faces_num);
+    const IndexRange faces(export_object->faces_num);
+    for (int64_t start = 0; start < faces.size(); start += chunk_size) {
+      PlyData chunk;
+      load_faces(
+          export_mesh, faces.slice(start, std::min(chunk_size, faces.size() - start)), chunk);
+      fn(chunk);
     }
+  }
+}
 
-    /* Custom attributes */
-    if (export_params.export_attributes) {
-      load_custom_attributes(mesh, ply_to_vertex, vertex_offset, plyData.vertex_custom_attr);
+void PlyExportMeshes::foreach_edge_chunk(const int64_t chunk_size,
+                                         const FunctionRef<void(const PlyData &chunk)> fn) const
+{
+  for (const std::unique_ptr<PlyExportObject> &export_object : objects_) {
+    if (export_object->loose_edges_num == 0) {
+      continue;
     }
-
-    /* Loose edges */
-    const bke::LooseEdgeCache &loose_edges = mesh->loose_edges();
-    if (loose_edges.count > 0) {
-      Span<int2> edges = mesh->edges();
-      for (int i = 0; i < edges.size(); ++i) {
-        if (loose_edges.is_loose_bits[i]) {
-          plyData.edges.append({vertex_to_ply[edges[i][0]], vertex_to_ply[edges[i][1]]});
-        }
+    const PlyExportMesh export_mesh(*export_object, export_params_);
+    const IndexRange edges = export_mesh.mesh->edges().index_range();
+    for (int64_t start = 0; start < edges.size(); start += chunk_size) {
+      PlyData chunk;
+      load_loose_edges(
+          export_mesh, edges.slice(start, std::min(chunk_size, edges.size() - start)), chunk);
+      if (!chunk.edges.is_empty()) {
+        fn(chunk);
       }
     }
-
-    vertex_offset = int(plyData.vertices.size());
-    if (manually_free_mesh) {
-      BKE_id_free(nullptr, mesh);
-    }
   }
+}
 
-  DEG_OBJECT_ITER_END;
+void load_plydata(PlyData &plyData,
+                  Depsgraph *depsgraph,
+                  const PLYExportParams &export_params,
+                  const int64_t chunk_size)
+{
+  const PlyExportMeshes meshes(depsgraph, export_params);
 
-  /* Make sure color and attribute arrays are encompassing all input objects */
-  if (!plyData.vertex_colors.is_empty()) {
-    BLI_assert(plyData.vertex_colors.size() <= vertex_offset);
-    plyData.vertex_colors.resize(vertex_offset, float4(0));
-  }
-  for (PlyCustomAttribute &attr : plyData.vertex_custom_attr) {
-    BLI_assert(attr.data.size() <= vertex_offset);
-    attr.data.resize(vertex_offset, 0.0f);
+  for (const std::string &name : meshes.layout().custom_attribute_names) {
+    plyData.vertex_custom_attr.append(PlyCustomAttribute(name, 0));
   }
+
+  meshes.foreach_vertex_chunk(chunk_size, [&](const PlyData &chunk) {
+    plyData.vertices.extend(chunk.vertices);
+    plyData.vertex_normals.extend(chunk.vertex_normals);
+    plyData.vertex_colors.extend(chunk.vertex_colors);
+    plyData.uv_coordinates.extend(chunk.uv_coordinates);
+    for (const int i : chunk.vertex_custom_attr.index_range()) {
+      plyData.vertex_custom_attr[i].data.extend(chunk.vertex_custom_attr[i].data);
+    }
+  });
+  meshes.foreach_face_chunk(chunk_size, [&](const PlyData &chunk) {
+    plyData.face_sizes.extend(chunk.face_sizes);
+    plyData.face_vertices.extend(chunk.face_vertices);
+  });
+  meshes.foreach_edge_chunk(chunk_size,
+                            [&](const PlyData &chunk) { plyData.edges.extend(chunk.edges); });
 }
 
 }  // namespace blender::io::ply
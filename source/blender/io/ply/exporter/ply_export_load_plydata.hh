@@ -8,13 +8,54 @@
 
 #pragma once
 
+#include <limits>
+#include <memory>
+
+#include "BLI_function_ref.hh"
+#include "BLI_vector.hh"
+
+#include "ply_data.hh"
+
 struct Depsgraph;
 struct PLYExportParams;
 
 namespace blender::io::ply {
 
-struct PlyData;
+struct PlyExportObject;
+
+/**
+ * The meshes of the exported objects, whose PLY data can be loaded in chunks without keeping the
+ * data of all objects in memory at once. Only the element counts and the triangulated meshes are
+ * computed up front, each mesh is mapped to PLY vertices while its chunks are loaded.
+ */
+class PlyExportMeshes {
+  const PLYExportParams &export_params_;
+  Vector<std::unique_ptr<PlyExportObject>> objects_;
+  PlyExportLayout layout_;
 
-void load_plydata(PlyData &plyData, Depsgraph *depsgraph, const PLYExportParams &export_params);
+ public:
+  PlyExportMeshes(Depsgraph *depsgraph, const PLYExportParams &export_params);
+  ~PlyExportMeshes();
+
+  const PlyExportLayout &layout() const;
+
+  /**
+   * Call the function for consecutive chunks of the PLY vertices of all meshes, in export order.
+   * Every chunk contains all vertex properties of the layout.
+   */
+  void foreach_vertex_chunk(int64_t chunk_size, FunctionRef<void(const PlyData &chunk)> fn) const;
+  void foreach_face_chunk(int64_t chunk_size, FunctionRef<void(const PlyData &chunk)> fn) const;
+  /** Loose edges are loaded from slices of at most \a chunk_size mesh edges. */
+  void foreach_edge_chunk(int64_t chunk_size, FunctionRef<void(const PlyData &chunk)> fn) const;
+};
+
+/**
+ * Load the PLY data of all exported objects at once. The data is gathered from chunks of at most
+ * \a chunk_size elements, like when it is written.
+ */
+void load_plydata(PlyData &plyData,
+                  Depsgraph *depsgraph,
+                  const PLYExportParams &export_params,
+                  int64_t chunk_size = std::numeric_limits<int64_t>::max());
 
 }  // namespace blender::io::ply
@@ -18,31 +18,40 @@ namespace blender::io::ply {
 FileBuffer::FileBuffer(const char *filepath, size_t buffer_chunk_size)
     : buffer_chunk_size_(buffer_chunk_size), filepath_(filepath)
 {
-  outfile_ = BLI_fopen(filepath, "wb");
+  if (filepath == nullptr) {
+    return;
+  }
+  outfile_ = FileWriter::open(filepath);
   if (!outfile_) {
     throw std::system_error(
         errno, std::system_category(), "Cannot open file " + std::string(filepath) + ".");
   }
 }
 
+void FileBuffer::append_from(FileBuffer &other)
+{
+  blocks_.insert(blocks_.end(),
+                 std::make_move_iterator(other.blocks_.begin()),
+                 std::make_move_iterator(other.blocks_.end()));
+  other.blocks_.clear();
+}
+
 void FileBuffer::write_to_file()
 {
+  BLI_assert(outfile_ != nullptr);
   for (const VectorChar &b : blocks_) {
-    fwrite(b.data(), 1, b.size(), this->outfile_);
+    outfile_->write(b.data(), b.size());
   }
   blocks_.clear();
 }
 
 void FileBuffer::close_file()
 {
-  int close_status = std::fclose(outfile_);
-  if (close_status == EOF) {
-    return;
-  }
-  if (outfile_ && close_status) {
+  if (outfile_ && !outfile_->close()) {
     std::cerr << "Error: could not close the file '" << this->filepath_
               << "' properly, it may be corrupted." << std::endl;
   }
+  outfile_.reset();
 }
 
 void FileBuffer::write_header_element(StringRef name, int count)
@@ -8,12 +8,15 @@
 
 #pragma once
 
+#include <memory>
 #include <type_traits>
 
 #include "BLI_string_ref.hh"
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
 
+#include "IO_compressed_file.hh"
+
 /* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
 #undef SEP
 #include <fmt/format.h>
@@ -32,13 +35,22 @@ class FileBuffer : private NonMovable {
   Vector<VectorChar> blocks_;
   size_t buffer_chunk_size_;
   const char *filepath_;
-  FILE *outfile_;
+  /** Compressed with Gzip or Zstd when the file path has a `.gz` or `.zst` extension. */
+  std::unique_ptr<FileWriter> outfile_;
 
  public:
+  /* When the file path is null, the buffer is only used in memory. */
   FileBuffer(const char *filepath, size_t buffer_chunk_size = 64 * 1024);
 
   virtual ~FileBuffer() = default;
 
+  /* Create an in-memory buffer of the same format, to be filled on another thread and appended
+   * to this buffer with #append_from. */
+  virtual std::unique_ptr<FileBuffer> create_memory_buffer() const = 0;
+
+  /* Move the contents of the other buffer to the end of this buffer. */
+  void append_from(FileBuffer &other);
+
   /* Write contents to the buffer(s) into a file, and clear the buffers. */
   void write_to_file();
 
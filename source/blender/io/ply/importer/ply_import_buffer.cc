@@ -4,7 +4,9 @@
 
 #include "ply_import_buffer.hh"
 
-#include "BLI_fileops.h"
+#include "BLI_filereader.h"
+
+#include "IO_compressed_file.hh"
 
 #include <cstdio>
 #include <cstring>
@@ -20,13 +22,13 @@ namespace blender::io::ply {
 PlyReadBuffer::PlyReadBuffer(const char *file_path, size_t read_buffer_size)
     : buffer_(read_buffer_size), read_buffer_size_(read_buffer_size)
 {
-  file_ = BLI_fopen(file_path, "rb");
+  file_ = file_reader_open(file_path);
 }
 
 PlyReadBuffer::~PlyReadBuffer()
 {
   if (file_ != nullptr) {
-    fclose(file_);
+    file_->close(file_);
   }
 }
 
@@ -62,6 +64,18 @@ Span<char> PlyReadBuffer::read_line()
 
 bool PlyReadBuffer::read_bytes(void *dst, size_t size)
 {
+  if (size > read_buffer_size_ && file_ != nullptr) {
+    /* Large reads go directly into the destination, after what is left in the buffer. */
+    const size_t buffered = size_t(buf_used_ - pos_);
+    memcpy(dst, buffer_.data() + pos_, buffered);
+    pos_ = buf_used_;
+    const size_t to_read = size - buffered;
+    if (file_reader_read(file_, (char *)dst + buffered, to_read) != to_read) {
+      at_eof_ = true;
+      return false;
+    }
+    return true;
+  }
   while (size > 0) {
     if (pos_ + size > buf_used_) {
       if (!refill_buffer()) {
@@ -96,7 +110,7 @@ bool PlyReadBuffer::refill_buffer()
     memmove(buffer_.data(), buffer_.data() + pos_, keep);
   }
   /* Read in data from the file. */
-  size_t read = fread(buffer_.data() + keep, 1, read_buffer_size_ - keep, file_) + keep;
+  size_t read = file_reader_read(file_, buffer_.data() + keep, read_buffer_size_ - keep) + keep;
   at_eof_ = read < read_buffer_size_;
   pos_ = 0;
   buf_used_ = int(read);
@@ -13,6 +13,8 @@
 #include "BLI_array.hh"
 #include "BLI_span.hh"
 
+struct FileReader;
+
 namespace blender::io::ply {
 
 /**
@@ -42,7 +44,8 @@ class PlyReadBuffer {
   bool refill_buffer();
 
  private:
-  FILE *file_ = nullptr;
+  /** Reads the file contents, decompressing Gzip or Zstd compressed files. */
+  FileReader *file_ = nullptr;
   Array<char> buffer_;
   int pos_ = 0;
   int buf_used_ = 0;
@@ -37,6 +37,17 @@ struct PlyData {
   std::string error;
 };
 
+/** Element counts and vertex properties of exported data, to write the header beforehand. */
+struct PlyExportLayout {
+  int64_t vertices_num = 0;
+  int64_t faces_num = 0;
+  int64_t edges_num = 0;
+  bool has_normals = false;
+  bool has_colors = false;
+  bool has_uvs = false;
+  Vector<std::string> custom_attribute_names;
+};
+
 enum PlyFormatType { ASCII, BINARY_LE, BINARY_BE };
 
 struct PlyProperty {
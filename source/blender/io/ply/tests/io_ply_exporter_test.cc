@@ -430,6 +430,39 @@ class PLYExportPLYDataTest : public PLYExportTest {
 
     return data;
   }
+
+  /* Loading the data in small chunks gives the same result as loading it at once. */
+  void test_chunked_load(const std::string &blendfile, PLYExportParams &params)
+  {
+    if (!load_file_and_depsgraph(blendfile)) {
+      ADD_FAILURE();
+      return;
+    }
+    PlyData expected;
+    load_plydata(expected, depsgraph, params);
+    PlyData result;
+    load_plydata(result, depsgraph, params, 3);
+
+    /* The header is written from the counts, before any mesh is prepared for export. */
+    const PlyExportMeshes meshes(depsgraph, params);
+    EXPECT_EQ(meshes.layout().vertices_num, expected.vertices.size());
+    EXPECT_EQ(meshes.layout().faces_num, expected.face_sizes.size());
+    EXPECT_EQ(meshes.layout().edges_num, expected.edges.size());
+
+    EXPECT_FALSE(expected.vertices.is_empty());
+    EXPECT_EQ(result.vertices, expected.vertices);
+    EXPECT_EQ(result.vertex_normals, expected.vertex_normals);
+    EXPECT_EQ(result.vertex_colors, expected.vertex_colors);
+    EXPECT_EQ(result.uv_coordinates, expected.uv_coordinates);
+    EXPECT_EQ(result.edges, expected.edges);
+    EXPECT_EQ(result.face_sizes, expected.face_sizes);
+    EXPECT_EQ(result.face_vertices, expected.face_vertices);
+    ASSERT_EQ(result.vertex_custom_attr.size(), expected.vertex_custom_attr.size());
+    for (const int i : expected.vertex_custom_attr.index_range()) {
+      EXPECT_EQ(result.vertex_custom_attr[i].name, expected.vertex_custom_attr[i].name);
+      EXPECT_EQ(result.vertex_custom_attr[i].data, expected.vertex_custom_attr[i].data);
+    }
+  }
 };
 
 TEST_F(PLYExportPLYDataTest, CubeLoadPLYData)
@@ -538,6 +571,24 @@ TEST_F(PLYExportPLYDataTest, CubesVertexAttrs)
   EXPECT_EQ(plyData.vertex_custom_attr[0].data.size(), 28);
 }
 
+TEST_F(PLYExportPLYDataTest, CubesVertexAttrsChunked)
+{
+  PLYExportParams params = {};
+  params.export_uv = true;
+  params.export_normals = true;
+  params.export_attributes = true;
+  params.vertex_colors = PLY_VERTEX_COLOR_SRGB;
+  test_chunked_load("io_tests/blend_geometry/cubes_vertex_attrs.blend", params);
+}
+
+TEST_F(PLYExportPLYDataTest, CubeLooseEdgesChunked)
+{
+  PLYExportParams params = {};
+  params.export_uv = true;
+  params.export_triangulated_mesh = true;
+  test_chunked_load("io_tests/blend_geometry/cube_loose_edges_verts.blend", params);
+}
+
 TEST_F(PLYExportPLYDataTest, SuzanneLoadPLYDataUV)
 {
   PLYExportParams params = {};
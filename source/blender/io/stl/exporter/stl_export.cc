@@ -10,20 +10,27 @@
 #include <memory>
 
 #include "BKE_context.hh"
+#include "BKE_duplilist.hh"
+#include "BKE_geometry_set.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_mesh_wrapper.hh"
 #include "BKE_object.hh"
+#include "BKE_object_types.hh"
 #include "BKE_report.hh"
 #include "BKE_scene.hh"
 
+#include "BLI_array.hh"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 
 #include "DEG_depsgraph_query.hh"
 
 #include "DNA_mesh_types.h"
 #include "DNA_scene_types.h"
 
+#include "GEO_realize_instances.hh"
+
 #include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.hh"
@@ -37,6 +44,57 @@
 
 namespace blender::io::stl {
 
+/** Number of vertices of geometry instances that are realized and written at once. */
+static constexpr int64_t instances_chunk_size = 1024 * 1024;
+
+static void write_mesh_triangles(FileWriter &writer,
+                                 const Mesh &mesh,
+                                 const float xform[4][4],
+                                 const float global_scale)
+{
+  const Span<float3> positions = mesh.vert_positions();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const Span<int3> corner_tris = mesh.corner_tris();
+  Array<PackedTriangle> tris(corner_tris.size());
+  threading::parallel_for(corner_tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int tri_i : range) {
+      const int3 &tri = corner_tris[tri_i];
+      PackedTriangle &data = tris[tri_i];
+      for (int i = 0; i < 3; i++) {
+        float3 pos = positions[corner_verts[tri[i]]];
+        mul_m4_v3(xform, pos);
+        pos *= global_scale;
+        data.vertices[i] = pos;
+      }
+      data.normal = math::normal_tri(data.vertices[0], data.vertices[1], data.vertices[2]);
+      data.attribute_byte_count = 0;
+    }
+  });
+  writer.write_triangles(tris);
+}
+
+/**
+ * Realize the instances in chunks that are written right away, so that large amounts of
+ * instances never have to be realized all at once. Only the positions are needed.
+ */
+static void write_instances_triangles(FileWriter &writer,
+                                      const bke::GeometrySet &geometry,
+                                      const float xform[4][4],
+                                      const float global_scale)
+{
+  bke::GeometrySet instances;
+  instances.add(*geometry.get_component<bke::InstancesComponent>());
+
+  geometry::RealizeInstancesOptions options;
+  options.attribute_names.emplace();
+  geometry::realize_instances_chunked(
+      std::move(instances), options, instances_chunk_size, [&](const bke::GeometrySet chunk) {
+        if (const Mesh *mesh = chunk.get_mesh()) {
+          write_mesh_triangles(writer, *mesh, xform, global_scale);
+        }
+      });
+}
+
 void export_frame(Depsgraph *depsgraph,
                   float scene_unit_scale,
                   const STLExportParams &export_params)
@@ -65,7 +123,17 @@ void export_frame(Depsgraph *depsgraph,
                             DEG_ITER_OBJECT_FLAG_DUPLI;
 
   DEG_OBJECT_ITER_BEGIN (&deg_iter_settings, object) {
-    if (object->type != OB_MESH) {
+    const DupliObject *dupli = data_.dupli_object_current;
+    if (export_params.apply_modifiers && dupli && dupli->instance_data[0]) {
+      /* Geometry instances are written with the object that instances them, see below. */
+      continue;
+    }
+
+    Object *obj_eval = DEG_get_evaluated_object(depsgraph, object);
+    const bke::GeometrySet *geometry_eval = export_params.apply_modifiers ?
+                                                obj_eval->runtime->geometry_set_eval :
+                                                nullptr;
+    if (object->type != OB_MESH && !(geometry_eval && geometry_eval->has_instances())) {
       continue;
     }
 
@@ -102,13 +170,6 @@ void export_frame(Depsgraph *depsgraph,
       }
     }
 
-    Object *obj_eval = DEG_get_evaluated_object(depsgraph, object);
-    Mesh *mesh = export_params.apply_modifiers ? BKE_object_get_evaluated_mesh(obj_eval) :
-                                                 BKE_object_get_pre_modified_mesh(obj_eval);
-
-    /* Ensure data exists if currently in edit mode. */
-    BKE_mesh_wrapper_ensure_mdata(mesh);
-
     /* Calculate transform. */
     float global_scale = export_params.global_scale * scene_unit_scale;
     float axes_transform[3][3];
@@ -122,19 +183,15 @@ void export_frame(Depsgraph *depsgraph,
     mul_v3_m3v3(xform[3], axes_transform, obj_eval->object_to_world().location());
     xform[3][3] = obj_eval->object_to_world()[3][3];
 
-    /* Write triangles. */
-    const Span<float3> positions = mesh->vert_positions();
-    const Span<int> corner_verts = mesh->corner_verts();
-    for (const int3 &tri : mesh->corner_tris()) {
-      PackedTriangle data{};
-      for (int i = 0; i < 3; i++) {
-        float3 pos = positions[corner_verts[tri[i]]];
-        mul_m4_v3(xform, pos);
-        pos *= global_scale;
-        data.vertices[i] = pos;
-      }
-      data.normal = math::normal_tri(data.vertices[0], data.vertices[1], data.vertices[2]);
-      writer->write_triangle(data);
+    if (object->type == OB_MESH) {
+      Mesh *mesh = export_params.apply_modifiers ? BKE_object_get_evaluated_mesh(obj_eval) :
+                                                   BKE_object_get_pre_modified_mesh(obj_eval);
+      /* Ensure data exists if currently in edit mode. */
+      BKE_mesh_wrapper_ensure_mdata(mesh);
+      write_mesh_triangles(*writer, *mesh, xform, global_scale);
+    }
+    if (geometry_eval && geometry_eval->has_instances()) {
+      write_instances_triangles(*writer, *geometry_eval, xform, global_scale);
     }
   }
   DEG_OBJECT_ITER_END;
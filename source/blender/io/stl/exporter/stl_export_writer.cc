@@ -17,7 +17,9 @@
 #include "stl_data.hh"
 #include "stl_export_writer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.h"
+#include "BLI_task.hh"
 
 namespace blender::io::stl {
 
@@ -56,34 +58,58 @@ FileWriter::~FileWriter()
   fclose(file_);
 }
 
-void FileWriter::write_triangle(const PackedTriangle &data)
+static void format_triangle_ascii(fmt::memory_buffer &buf, const PackedTriangle &data)
 {
-  tris_num_++;
-  if (ascii_) {
-    fmt::print(file_,
-               "facet normal {} {} {}\n"
-               " outer loop\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               " endloop\n"
-               "endfacet\n",
+  fmt::format_to(fmt::appender(buf),
+                 "facet normal {} {} {}\n"
+                 " outer loop\n"
+                 "  vertex {} {} {}\n"
+                 "  vertex {} {} {}\n"
+                 "  vertex {} {} {}\n"
+                 " endloop\n"
+                 "endfacet\n",
+
+                 data.normal.x,
+                 data.normal.y,
+                 data.normal.z,
+                 data.vertices[0].x,
+                 data.vertices[0].y,
+                 data.vertices[0].z,
+                 data.vertices[1].x,
+                 data.vertices[1].y,
+                 data.vertices[1].z,
+                 data.vertices[2].x,
+                 data.vertices[2].y,
+                 data.vertices[2].z);
+}
 
-               data.normal.x,
-               data.normal.y,
-               data.normal.z,
-               data.vertices[0].x,
-               data.vertices[0].y,
-               data.vertices[0].z,
-               data.vertices[1].x,
-               data.vertices[1].y,
-               data.vertices[1].z,
-               data.vertices[2].x,
-               data.vertices[2].y,
-               data.vertices[2].z);
+void FileWriter::write_triangles(const Span<PackedTriangle> tris)
+{
+  tris_num_ += tris.size();
+  if (!ascii_) {
+    fwrite(tris.data(), sizeof(PackedTriangle), tris.size(), file_);
+    return;
   }
-  else {
-    fwrite(&data, sizeof(data), 1, file_);
+  /* Format chunks of triangles in parallel, and write them in order. */
+  const int64_t chunk_size = 4096;
+  const int64_t batch_size = chunk_size * 64;
+  for (int64_t batch_start = 0; batch_start < tris.size(); batch_start += batch_size) {
+    const Span<PackedTriangle> batch = tris.slice(
+        batch_start, std::min(batch_size, tris.size() - batch_start));
+    Array<fmt::memory_buffer> buffers((batch.size() + chunk_size - 1) / chunk_size);
+    threading::parallel_for(buffers.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t chunk : range) {
+        const int64_t start = chunk * chunk_size;
+        for (const PackedTriangle &tri :
+             batch.slice(start, std::min(chunk_size, batch.size() - start)))
+        {
+          format_triangle_ascii(buffers[chunk], tri);
+        }
+      }
+    });
+    for (const fmt::memory_buffer &buf : buffers) {
+      fwrite(buf.data(), 1, buf.size(), file_);
+    }
   }
 }
 
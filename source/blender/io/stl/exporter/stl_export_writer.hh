@@ -10,6 +10,8 @@
 
 #include <cstdio>
 
+#include "BLI_span.hh"
+
 namespace blender::io::stl {
 
 struct PackedTriangle;
@@ -18,7 +20,8 @@ class FileWriter {
  public:
   FileWriter(const char *filepath, bool ascii);
   ~FileWriter();
-  void write_triangle(const PackedTriangle &data);
+  /** Write the triangles, formatting ASCII output in parallel. */
+  void write_triangles(Span<PackedTriangle> tris);
 
  private:
   FILE *file_;
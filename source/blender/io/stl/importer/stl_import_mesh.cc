@@ -6,12 +6,17 @@
  * \ingroup stl
  */
 
+#include <array>
 #include <iostream>
 
 #include "BKE_mesh.hh"
 
+#include "BLI_array.hh"
 #include "BLI_array_utils.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_sort.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -79,4 +84,171 @@ Mesh *STLMeshHelper::to_mesh()
   return mesh;
 }
 
+/**
+ * A key that compares equal for equal positions. Adding zero turns negative zero into positive
+ * zero, so that they are merged like with `float3::operator==`.
+ */
+static std::array<uint32_t, 3> position_key(const float3 &position)
+{
+  const float3 co = position + float3(0.0f);
+  std::array<uint32_t, 3> key;
+  memcpy(key.data(), &co, sizeof(key));
+  return key;
+}
+
+/**
+ * Find the index of every triangle corner's vertex. Vertices are numbered in the order of their
+ * first use, like when they are added to a #VectorSet one by one.
+ */
+static Array<float3> merge_corner_positions(const Span<PackedTriangle> tris,
+                                            MutableSpan<int> r_corner_verts)
+{
+  const int corners_num = r_corner_verts.size();
+  Array<std::array<uint32_t, 3>> keys(corners_num);
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int tri : range) {
+      for (const int i : IndexRange(3)) {
+        keys[tri * 3 + i] = position_key(tris[tri].vertices[i]);
+      }
+    }
+  });
+
+  /* Sort the corners so that the ones with the same position are adjacent, with the first one in
+   * the file first in each group. */
+  Array<int> sorted_corners(corners_num);
+  array_utils::fill_index_range<int>(sorted_corners);
+  parallel_sort(sorted_corners.begin(), sorted_corners.end(), [&](const int a, const int b) {
+    if (keys[a] != keys[b]) {
+      return keys[a] < keys[b];
+    }
+    return a < b;
+  });
+
+  /* The first corner at every corner's position, temporarily stored in the result array. */
+  int group_first = 0;
+  for (const int i : sorted_corners.index_range()) {
+    const int corner = sorted_corners[i];
+    if (i == 0 || keys[sorted_corners[i - 1]] != keys[corner]) {
+      group_first = corner;
+    }
+    r_corner_verts[corner] = group_first;
+  }
+
+  Array<int> vert_by_first_corner(corners_num);
+  int verts_num = 0;
+  for (const int corner : IndexRange(corners_num)) {
+    if (r_corner_verts[corner] == corner) {
+      vert_by_first_corner[corner] = verts_num++;
+    }
+  }
+
+  Array<float3> positions(verts_num);
+  threading::parallel_for(r_corner_verts.index_range(), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      const int first_corner = r_corner_verts[corner];
+      const int vert = vert_by_first_corner[first_corner];
+      if (first_corner == corner) {
+        positions[vert] = tris[corner / 3].vertices[corner % 3];
+      }
+      r_corner_verts[corner] = vert;
+    }
+  });
+  return positions;
+}
+
+/**
+ * Find the triangles that aren't degenerate and that don't use the same vertices as a previous
+ * triangle, in any order.
+ */
+static IndexMask find_unique_triangles(const Span<int3> tris,
+                                       int &r_degenerate_tris_num,
+                                       int &r_duplicate_tris_num,
+                                       IndexMaskMemory &memory)
+{
+  Array<int3> sorted_verts(tris.size());
+  Array<bool> keep(tris.size());
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      int3 verts = tris[i];
+      if (verts.x > verts.y) {
+        std::swap(verts.x, verts.y);
+      }
+      if (verts.y > verts.z) {
+        std::swap(verts.y, verts.z);
+      }
+      if (verts.x > verts.y) {
+        std::swap(verts.x, verts.y);
+      }
+      sorted_verts[i] = verts;
+      keep[i] = verts.x != verts.y && verts.y != verts.z;
+    }
+  });
+  const IndexMask valid_tris = IndexMask::from_bools(keep, memory);
+  r_degenerate_tris_num = tris.size() - valid_tris.size();
+
+  Array<int> sorted_tris(valid_tris.size());
+  valid_tris.to_indices<int>(sorted_tris);
+  auto verts_less = [](const int3 &a, const int3 &b) {
+    return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+  };
+  parallel_sort(sorted_tris.begin(), sorted_tris.end(), [&](const int a, const int b) {
+    if (sorted_verts[a] != sorted_verts[b]) {
+      return verts_less(sorted_verts[a], sorted_verts[b]);
+    }
+    return a < b;
+  });
+  threading::parallel_for(sorted_tris.index_range().drop_front(1), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      if (sorted_verts[sorted_tris[i - 1]] == sorted_verts[sorted_tris[i]]) {
+        keep[sorted_tris[i]] = false;
+      }
+    }
+  });
+  const IndexMask unique_tris = IndexMask::from_bools(keep, memory);
+  r_duplicate_tris_num = valid_tris.size() - unique_tris.size();
+  return unique_tris;
+}
+
+Mesh *triangles_to_mesh(const Span<PackedTriangle> tris, const bool use_custom_normals)
+{
+  Array<int3> tri_verts(tris.size());
+  const Array<float3> positions = merge_corner_positions(
+      tris, tri_verts.as_mutable_span().cast<int>());
+
+  int degenerate_tris_num;
+  int duplicate_tris_num;
+  IndexMaskMemory memory;
+  const IndexMask unique_tris = find_unique_triangles(
+      tri_verts, degenerate_tris_num, duplicate_tris_num, memory);
+  if (degenerate_tris_num > 0) {
+    std::cout << "STL Importer: " << degenerate_tris_num << " degenerate triangles were removed"
+              << std::endl;
+  }
+  if (duplicate_tris_num > 0) {
+    std::cout << "STL Importer: " << duplicate_tris_num << " duplicate triangles were removed"
+              << std::endl;
+  }
+
+  const int faces_num = unique_tris.size();
+  Mesh *mesh = BKE_mesh_new_nomain(positions.size(), 0, faces_num, faces_num * 3);
+  mesh->vert_positions_for_write().copy_from(positions);
+  offset_indices::fill_constant_group_size(3, 0, mesh->face_offsets_for_write());
+  array_utils::gather(tri_verts.as_span(),
+                      unique_tris,
+                      mesh->corner_verts_for_write().cast<int3>());
+
+  /* NOTE: edges must be calculated first before setting custom normals. */
+  bke::mesh_calc_edges(*mesh, false, false);
+
+  if (use_custom_normals) {
+    Array<float3> corner_normals(mesh->corners_num);
+    unique_tris.foreach_index(GrainSize(4096), [&](const int tri, const int face) {
+      corner_normals.as_mutable_span().slice(face * 3, 3).fill(tris[tri].normal);
+    });
+    BKE_mesh_set_custom_normals(mesh, reinterpret_cast<float(*)[3]>(corner_normals.data()));
+  }
+
+  return mesh;
+}
+
 }  // namespace blender::io::stl
@@ -11,6 +11,7 @@
 #include <cstdint>
 
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 #include "stl_data.hh"
@@ -67,4 +68,11 @@ class STLMeshHelper {
   Mesh *to_mesh();
 };
 
+/**
+ * Create a mesh from all triangles at once, with the same merging of vertices and triangles as
+ * #STLMeshHelper. Vertices are merged by sorting the corners by position in parallel, instead of
+ * adding them to a hash table one by one.
+ */
+Mesh *triangles_to_mesh(Span<PackedTriangle> tris, bool use_custom_normals);
+
 }  // namespace blender::io::stl
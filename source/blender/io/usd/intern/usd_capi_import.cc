@@ -24,6 +24,7 @@
 #include "BLI_math_rotation.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_timeit.hh"
 
 #include "BLT_translation.hh"
@@ -325,6 +326,28 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     }
   }
 
+  /* Read the bulk of the prim data in parallel. This doesn't access the main database, which is
+   * only modified when reading the object data below. */
+  const Span<USDPrimReader *> readers = archive->readers();
+  threading::parallel_for(readers.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t index : range) {
+      if (G.is_break) {
+        return;
+      }
+      if (USDPrimReader *reader = readers[index]) {
+        reader->prepare_object_data(0.0);
+      }
+    }
+  });
+
+  *data->do_update = true;
+  *data->progress = 0.75f;
+
+  if (G.is_break) {
+    data->was_canceled = true;
+    return;
+  }
+
   /* Setup parenthood and read actual object data. */
   i = 0;
   for (USDPrimReader *reader : archive->readers()) {
@@ -346,7 +369,7 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
       ob->parent = parent->object();
     }
 
-    *data->progress = 0.5f + 0.5f * (++i / size);
+    *data->progress = 0.75f + 0.25f * (++i / size);
     *data->do_update = true;
 
     if (G.is_break) {
@@ -31,6 +31,8 @@ struct USDExporterContext {
   std::function<pxr::UsdTimeCode()> get_time_code;
   const USDExportParams &export_params;
   std::string export_file_path;
+  /** The iterator that creates the writers, null when the writers are used on their own. */
+  USDHierarchyIterator *hierarchy_iterator = nullptr;
 };
 
 }  // namespace blender::io::usd
@@ -69,6 +69,16 @@ void USDHierarchyIterator::process_usd_skel() const
   create_skel_roots(stage_, params_);
 }
 
+std::optional<pxr::SdfPath> USDHierarchyIterator::find_or_add_mesh_data_prim(
+    USDMeshDataKey key, const pxr::SdfPath &usd_path)
+{
+  const pxr::SdfPath &data_path = mesh_data_export_map_.lookup_or_add(std::move(key), usd_path);
+  if (data_path == usd_path) {
+    return std::nullopt;
+  }
+  return data_path;
+}
+
 void USDHierarchyIterator::set_export_frame(float frame_nr)
 {
   /* The USD stage is already set up to have FPS time-codes per frame. */
@@ -92,7 +102,7 @@ USDExporterContext USDHierarchyIterator::create_usd_export_context(const Hierarc
   auto get_time_code = [this]() { return this->export_time_; };
 
   return USDExporterContext{
-      bmain_, depsgraph_, stage_, path, get_time_code, params_, export_file_path};
+      bmain_, depsgraph_, stage_, path, get_time_code, params_, export_file_path, this};
 }
 
 AbstractHierarchyWriter *USDHierarchyIterator::create_transform_writer(
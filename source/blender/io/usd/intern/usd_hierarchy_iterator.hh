@@ -8,6 +8,12 @@
 #include "usd_exporter_context.hh"
 #include "usd_skel_convert.hh"
 
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_map.hh"
+#include "BLI_struct_equality_utils.hh"
+#include "BLI_vector.hh"
+
+#include <optional>
 #include <string>
 
 #include <pxr/usd/usd/common.h>
@@ -15,6 +21,7 @@
 
 struct Depsgraph;
 struct Main;
+struct Material;
 struct Object;
 
 namespace blender::io::usd {
@@ -23,6 +30,32 @@ using blender::io::AbstractHierarchyIterator;
 using blender::io::AbstractHierarchyWriter;
 using blender::io::HierarchyContext;
 
+/**
+ * Identifies the data of a mesh by the implicitly shared arrays it consists of. Meshes with the
+ * same key have the same data, so they are written to USD in the same way.
+ */
+struct USDMeshDataKey {
+  /* The arrays keep a user, so that their addresses are not reused while exporting. */
+  Vector<ImplicitSharingPtr<>> arrays;
+  Vector<std::string> layer_names;
+  /* Material of every slot of the object. The referenced prim contains the material subsets and
+   * bindings, so they have to match as well. */
+  Vector<const Material *> materials;
+  std::string active_uv_map;
+  std::string render_uv_map;
+
+  uint64_t hash() const
+  {
+    return get_default_hash(arrays.hash(),
+                            layer_names.hash(),
+                            materials.hash(),
+                            get_default_hash(active_uv_map, render_uv_map));
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_5(
+      USDMeshDataKey, arrays, layer_names, materials, active_uv_map, render_uv_map)
+};
+
 class USDHierarchyIterator : public AbstractHierarchyIterator {
  private:
   const pxr::UsdStageRefPtr stage_;
@@ -33,6 +66,9 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
   ObjExportMap skinned_mesh_export_map_;
   ObjExportMap shape_key_mesh_export_map_;
 
+  /** Prims that static mesh data has been written to, used to reference repeated data. */
+  Map<USDMeshDataKey, pxr::SdfPath> mesh_data_export_map_;
+
  public:
   USDHierarchyIterator(Main *bmain,
                        Depsgraph *depsgraph,
@@ -45,6 +81,13 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
 
   void process_usd_skel() const;
 
+  /**
+   * Return the prim that mesh data with the given key has already been written to. Otherwise
+   * remember \a usd_path as the prim for that data and return nothing.
+   */
+  std::optional<pxr::SdfPath> find_or_add_mesh_data_prim(USDMeshDataKey key,
+                                                         const pxr::SdfPath &usd_path);
+
  protected:
   virtual bool mark_as_weak_export(const Object *object) const override;
 
@@ -15,15 +15,18 @@
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_geometry_set.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_main.hh"
 #include "BKE_material.h"
 #include "BKE_mesh.hh"
 #include "BKE_object.hh"
 #include "BKE_report.hh"
 
+#include "BLI_array_utils.hh"
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_customdata_types.h"
 #include "DNA_material_types.h"
@@ -158,6 +161,13 @@ USDMeshReader::USDMeshReader(const pxr::UsdPrim &prim,
 {
 }
 
+USDMeshReader::~USDMeshReader()
+{
+  if (prepared_mesh_) {
+    BKE_id_free(nullptr, prepared_mesh_);
+  }
+}
+
 static const std::optional<bke::AttrDomain> convert_usd_varying_to_blender(
     const pxr::TfToken usd_domain)
 {
@@ -192,7 +202,7 @@ void USDMeshReader::create_object(Main *bmain, const double /*motionSampleTime*/
   object_->data = mesh;
 }
 
-void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
+void USDMeshReader::prepare_object_data(const double motionSampleTime)
 {
   Mesh *mesh = (Mesh *)object_->data;
 
@@ -200,10 +210,29 @@ void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
   const USDMeshReadParams params = create_mesh_read_params(motionSampleTime,
                                                            import_params_.mesh_read_flag);
 
+  /* The mesh is created outside of the main database, so this is safe to do in parallel with
+   * other readers. */
   Mesh *read_mesh = this->read_mesh(mesh, params, nullptr);
+  if (read_mesh != mesh) {
+    prepared_mesh_ = read_mesh;
+  }
 
   is_initial_load_ = false;
-  if (read_mesh != mesh) {
+  is_prepared_ = true;
+}
+
+void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
+{
+  Mesh *mesh = (Mesh *)object_->data;
+
+  if (!is_prepared_) {
+    this->prepare_object_data(motionSampleTime);
+  }
+  Mesh *read_mesh = prepared_mesh_;
+  prepared_mesh_ = nullptr;
+  is_prepared_ = false;
+
+  if (read_mesh) {
     BKE_mesh_nomain_to_mesh(read_mesh, mesh, object_);
   }
 
@@ -277,27 +306,25 @@ void USDMeshReader::read_mpolys(Mesh *mesh)
   MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
   MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
 
-  int loop_index = 0;
-
-  for (int i = 0; i < face_counts_.size(); i++) {
-    const int face_size = face_counts_[i];
+  face_offsets.drop_back(1).copy_from(Span(face_counts_.cdata(), face_counts_.size()));
+  const OffsetIndices faces = offset_indices::accumulate_counts_to_offsets(face_offsets);
 
-    face_offsets[i] = loop_index;
+  /* Polygons are always assumed to be smooth-shaded. If the mesh should be flat-shaded,
+   * this is encoded in custom loop normals. */
 
-    /* Polygons are always assumed to be smooth-shaded. If the mesh should be flat-shaded,
-     * this is encoded in custom loop normals. */
-
-    if (is_left_handed_) {
-      int loop_end_index = loop_index + (face_size - 1);
-      for (int f = 0; f < face_size; ++f, ++loop_index) {
-        corner_verts[loop_index] = face_indices_[loop_end_index - f];
-      }
-    }
-    else {
-      for (int f = 0; f < face_size; ++f, ++loop_index) {
-        corner_verts[loop_index] = face_indices_[loop_index];
+  const Span<int> usd_face_indices(face_indices_.cdata(), face_indices_.size());
+  if (is_left_handed_) {
+    threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+      for (const int i : range) {
+        const IndexRange face = faces[i];
+        for (const int corner : face) {
+          corner_verts[corner] = usd_face_indices[face.last() - (corner - face.start())];
+        }
       }
-    }
+    });
+  }
+  else {
+    array_utils::copy(usd_face_indices, corner_verts);
   }
 
   bke::mesh_calc_edges(*mesh, false, false);
@@ -558,9 +585,7 @@ void USDMeshReader::read_mesh_sample(ImportSettings *settings,
 
   if (new_mesh || (settings->read_flag & MOD_MESHSEQ_READ_VERT) != 0) {
     MutableSpan<float3> vert_positions = mesh->vert_positions_for_write();
-    for (int i = 0; i < positions_.size(); i++) {
-      vert_positions[i] = {positions_[i][0], positions_[i][1], positions_[i][2]};
-    }
+    array_utils::copy(Span(positions_.cdata(), positions_.size()).cast<float3>(), vert_positions);
     mesh->tag_positions_changed();
 
     read_vertex_creases(mesh, motionSampleTime);
@@ -40,14 +40,20 @@ class USDMeshReader : public USDGeomReader {
    * implemented.  Note this will break if faces or positions vary. */
   bool is_initial_load_;
 
+  /** New mesh read by prepare_object_data(), consumed by read_object_data(). */
+  Mesh *prepared_mesh_ = nullptr;
+  bool is_prepared_ = false;
+
  public:
   USDMeshReader(const pxr::UsdPrim &prim,
                 const USDImportParams &import_params,
                 const ImportSettings &settings);
+  ~USDMeshReader() override;
 
   bool valid() const override;
 
   void create_object(Main *bmain, double motionSampleTime) override;
+  void prepare_object_data(double motionSampleTime) override;
   void read_object_data(Main *bmain, double motionSampleTime) override;
 
   void read_geometry(bke::GeometrySet &geometry_set,
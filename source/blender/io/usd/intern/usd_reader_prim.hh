@@ -109,6 +109,11 @@ class USDPrimReader {
   virtual bool valid() const;
 
   virtual void create_object(Main *bmain, double motionSampleTime) = 0;
+  /**
+   * Read the data of the prim that doesn't depend on the main database, to be used by
+   * read_object_data() afterwards. Called for many readers in parallel, after create_object().
+   */
+  virtual void prepare_object_data(double /*motionSampleTime*/){};
   virtual void read_object_data(Main * /*bmain*/, double /*motionSampleTime*/){};
 
   Object *object() const;
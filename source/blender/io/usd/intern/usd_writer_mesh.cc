@@ -6,6 +6,7 @@
 #include "usd_armature_utils.hh"
 #include "usd_attribute_utils.hh"
 #include "usd_blend_shape_utils.hh"
+#include "usd_hierarchy_iterator.hh"
 #include "usd_skel_convert.hh"
 
 #include <pxr/usd/usdGeom/mesh.h>
@@ -24,6 +25,7 @@
 #include "BKE_lib_id.hh"
 #include "BKE_material.h"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
 #include "BKE_mesh_wrapper.hh"
 #include "BKE_object.hh"
 #include "BKE_report.hh"
@@ -333,6 +335,69 @@ struct USDMeshData {
   pxr::VtFloatArray corner_sharpnesses;
 };
 
+static void get_material_face_groups(const Mesh *mesh, USDMeshData &usd_mesh_data);
+
+/**
+ * Identify the mesh by its implicitly shared arrays, and the object's materials. Returns nothing
+ * when some of the data isn't shared, in which case it can't be compared cheaply.
+ */
+static std::optional<USDMeshDataKey> get_mesh_data_key(Object &object, const Mesh &mesh)
+{
+  USDMeshDataKey key;
+  auto add_array = [&](const ImplicitSharingInfo *sharing_info) {
+    sharing_info->add_user();
+    key.arrays.append(ImplicitSharingPtr<>(sharing_info));
+  };
+
+  if (mesh.face_offset_indices) {
+    if (!mesh.runtime->face_offsets_sharing_info) {
+      return std::nullopt;
+    }
+    add_array(mesh.runtime->face_offsets_sharing_info);
+  }
+  for (const CustomData *data :
+       {&mesh.vert_data, &mesh.edge_data, &mesh.face_data, &mesh.corner_data})
+  {
+    for (const CustomDataLayer &layer : Span(data->layers, data->totlayer)) {
+      if (!layer.sharing_info) {
+        return std::nullopt;
+      }
+      add_array(layer.sharing_info);
+      key.layer_names.append(layer.name);
+    }
+  }
+
+  for (const int slot : IndexRange(object.totcol)) {
+    key.materials.append(BKE_object_material_get(&object, slot + 1));
+  }
+  if (const char *name = CustomData_get_active_layer_name(&mesh.corner_data, CD_PROP_FLOAT2)) {
+    key.active_uv_map = name;
+  }
+  if (const char *name = CustomData_get_render_layer_name(&mesh.corner_data, CD_PROP_FLOAT2)) {
+    key.render_uv_map = name;
+  }
+  return key;
+}
+
+std::optional<pxr::SdfPath> USDGenericMeshWriter::find_mesh_data_prim(
+    const HierarchyContext &context, const Mesh *mesh, const SubsurfModifierData *subsurfData)
+{
+  /* Only share data that isn't animated, as the referenced prim is the same for all frames. The
+   * subdivision scheme is written on the mesh prim, so it has to match as well. */
+  if (!usd_export_context_.export_params.use_instancing || is_animated_ ||
+      usd_export_context_.hierarchy_iterator == nullptr || subsurfData != nullptr ||
+      !can_share_mesh_data())
+  {
+    return std::nullopt;
+  }
+  std::optional<USDMeshDataKey> key = get_mesh_data_key(*context.object, *mesh);
+  if (!key) {
+    return std::nullopt;
+  }
+  return usd_export_context_.hierarchy_iterator->find_or_add_mesh_data_prim(
+      std::move(*key), usd_export_context_.usd_path);
+}
+
 void USDGenericMeshWriter::write_mesh(HierarchyContext &context,
                                       Mesh *mesh,
                                       const SubsurfModifierData *subsurfData)
@@ -347,6 +412,26 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context,
   USDMeshData usd_mesh_data;
   /* Ensure data exists if currently in edit mode. */
   BKE_mesh_wrapper_ensure_mdata(mesh);
+
+  if (const std::optional<pxr::SdfPath> data_path = find_mesh_data_prim(
+          context, mesh, subsurfData))
+  {
+    /* The same data and materials have been written before, reference it instead of writing it
+     * again. The material bindings point outside of the referenced prim, so they are authored
+     * again with the same paths, like for instances. */
+    if (usd_mesh.GetPrim().GetReferences().AddInternalReference(*data_path)) {
+      if (usd_export_context_.export_params.export_materials) {
+        get_material_face_groups(mesh, usd_mesh_data);
+        assign_materials(context, usd_mesh, usd_mesh_data.face_groups);
+      }
+      return;
+    }
+    CLOG_WARN(&LOG,
+              "Unable to add reference from %s to %s, writing mesh data instead",
+              usd_export_context_.usd_path.GetAsString().c_str(),
+              data_path->GetAsString().c_str());
+  }
+
   get_geometry_data(mesh, usd_mesh_data);
 
   if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
@@ -539,7 +624,7 @@ static void get_positions(const Mesh *mesh, USDMeshData &usd_mesh_data)
   usd_mesh_data.points = pxr::VtArray<pxr::GfVec3f>(positions.begin(), positions.end());
 }
 
-static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
+static void get_material_face_groups(const Mesh *mesh, USDMeshData &usd_mesh_data)
 {
   /* Only construct face groups (a.k.a. geometry subsets) when we need them for material
    * assignments. */
@@ -552,6 +637,11 @@ static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
       usd_mesh_data.face_groups.lookup_or_add_default(indices_span[i]).push_back(i);
     }
   }
+}
+
+static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  get_material_face_groups(mesh, usd_mesh_data);
 
   usd_mesh_data.face_vertex_counts.resize(mesh->faces_num);
   const OffsetIndices faces = mesh->faces();
@@ -879,6 +969,12 @@ void USDMeshWriter::do_write(HierarchyContext &context)
   }
 }
 
+bool USDMeshWriter::can_share_mesh_data() const
+{
+  /* Skinning and blend shapes are written on top of the mesh prim. */
+  return !write_skinned_mesh_ && !write_blend_shapes_;
+}
+
 Mesh *USDMeshWriter::get_export_mesh(Object *object_eval, bool &r_needsfree)
 {
   if (write_blend_shapes_) {
@@ -9,6 +9,8 @@
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+#include <optional>
+
 struct Key;
 struct SubsurfModifierData;
 
@@ -32,12 +34,24 @@ class USDGenericMeshWriter : public USDAbstractWriter {
 
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) = 0;
   virtual void free_export_mesh(Mesh *mesh);
+  /** Whether the prim can reference the prim of another mesh with the same data. */
+  virtual bool can_share_mesh_data() const
+  {
+    return true;
+  }
 
  private:
   /* Mapping from material slot number to array of face indices with that material. */
   using MaterialFaceGroups = Map<short, pxr::VtIntArray>;
 
   void write_mesh(HierarchyContext &context, Mesh *mesh, const SubsurfModifierData *subsurfData);
+  /**
+   * Find the prim of a mesh that was exported with the same data, or register this writer's prim
+   * for the data of \a mesh.
+   */
+  std::optional<pxr::SdfPath> find_mesh_data_prim(const HierarchyContext &context,
+                                                  const Mesh *mesh,
+                                                  const SubsurfModifierData *subsurfData);
   pxr::TfToken get_subdiv_scheme(const SubsurfModifierData *subsurfData);
   void write_subdiv(const pxr::TfToken &subdiv_scheme,
                     pxr::UsdGeomMesh &usd_mesh,
@@ -75,6 +89,7 @@ class USDMeshWriter : public USDGenericMeshWriter {
   virtual void do_write(HierarchyContext &context) override;
 
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) override;
+  virtual bool can_share_mesh_data() const override;
 
   /**
    * Determine whether we should write skinned mesh or blend shape data
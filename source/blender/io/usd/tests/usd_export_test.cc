@@ -15,16 +15,20 @@
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/usd/usdGeom/subset.h>
 #include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/usd/usdShade/materialBindingAPI.h>
 
 #include "DNA_image_types.h"
 #include "DNA_material_types.h"
 #include "DNA_node_types.h"
 
+#include "BKE_collection.hh"
 #include "BKE_context.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_main.hh"
+#include "BKE_material.h"
 #include "BKE_mesh.hh"
 #include "BKE_node.hh"
+#include "BKE_object.hh"
 #include "BLI_fileops.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_util.h"
@@ -196,6 +200,12 @@ class UsdExportTest : public BlendfileLoadingBaseTest {
     EXPECT_EQ(mesh->corners_num, face_indices.size());
     EXPECT_EQ(mesh->corners_num, normals.size());
   }
+
+  const pxr::UsdPrim get_object_mesh_prim(const pxr::UsdStageRefPtr stage, const Object *object)
+  {
+    const pxr::SdfPath sdf_path("/" + pxr::TfMakeValidIdentifier(object->id.name + 2));
+    return get_first_child_mesh(stage->GetPrimAtPath(sdf_path));
+  }
 };
 
 TEST_F(UsdExportTest, usd_export_rain_mesh)
@@ -238,6 +248,84 @@ TEST_F(UsdExportTest, usd_export_rain_mesh)
   }
 }
 
+/*
+ * Export objects that share a mesh. Mesh data is only written once when the materials match, an
+ * object with different materials has to get its own mesh data and bindings.
+ */
+TEST_F(UsdExportTest, usd_export_shared_mesh_materials)
+{
+  if (!blendfile_load(materials_filename.c_str())) {
+    FAIL() << "Unable to load file: " << materials_filename;
+    return;
+  }
+  Main *bmain = bfile->main;
+  Scene *scene = bfile->curscene;
+
+  Object *object = static_cast<Object *>(bmain->objects.first);
+  ASSERT_NE(object, nullptr);
+  ASSERT_EQ(object->type, OB_MESH);
+  Mesh *mesh = static_cast<Mesh *>(object->data);
+  Material *material = BKE_object_material_get(object, 1);
+  ASSERT_NE(material, nullptr);
+
+  Object *object_same = BKE_object_add_only_object(bmain, OB_MESH, "SameMaterial");
+  object_same->data = mesh;
+  id_us_plus(&mesh->id);
+  BKE_object_materials_test(bmain, object_same, &mesh->id);
+  BKE_collection_object_add(bmain, scene->master_collection, object_same);
+
+  Object *object_other = BKE_object_add_only_object(bmain, OB_MESH, "OtherMaterial");
+  object_other->data = mesh;
+  id_us_plus(&mesh->id);
+  BKE_object_materials_test(bmain, object_other, &mesh->id);
+  BKE_collection_object_add(bmain, scene->master_collection, object_other);
+  Material *other_material = BKE_material_add(bmain, "Other");
+  BKE_object_material_assign(bmain, object_other, other_material, 1, BKE_MAT_ASSIGN_OBJECT);
+
+  depsgraph_create(DAG_EVAL_VIEWPORT);
+  context = CTX_create();
+  CTX_data_main_set(context, bmain);
+  CTX_data_scene_set(context, scene);
+
+  USDExportParams params;
+  params.export_materials = true;
+  params.export_textures = false;
+  params.use_instancing = true;
+  params.relative_paths = false;
+
+  const bool result = USD_export(context, output_filename.c_str(), &params, false, nullptr);
+  ASSERT_TRUE(result) << "Unable to export stage to " << output_filename;
+
+  pxr::UsdStageRefPtr stage = pxr::UsdStage::Open(output_filename);
+  ASSERT_NE(stage, nullptr) << "Unable to open exported stage: " << output_filename;
+
+  const pxr::UsdPrim mesh_prim = get_object_mesh_prim(stage, object);
+  const pxr::UsdPrim mesh_prim_same = get_object_mesh_prim(stage, object_same);
+  const pxr::UsdPrim mesh_prim_other = get_object_mesh_prim(stage, object_other);
+  ASSERT_TRUE(bool(mesh_prim));
+  ASSERT_TRUE(bool(mesh_prim_same));
+  ASSERT_TRUE(bool(mesh_prim_other));
+
+  /* One of the objects with the same material references the data of the other one. */
+  EXPECT_NE(mesh_prim.HasAuthoredReferences(), mesh_prim_same.HasAuthoredReferences());
+  EXPECT_FALSE(mesh_prim_other.HasAuthoredReferences());
+
+  for (const pxr::UsdPrim &prim : {mesh_prim, mesh_prim_same, mesh_prim_other}) {
+    compare_blender_mesh_to_usd_prim(mesh, pxr::UsdGeomMesh(prim));
+  }
+
+  const pxr::SdfPath material_path("/_materials/" +
+                                   pxr::TfMakeValidIdentifier(material->id.name + 2));
+  const pxr::SdfPath other_material_path("/_materials/" +
+                                         pxr::TfMakeValidIdentifier(other_material->id.name + 2));
+  EXPECT_EQ(pxr::UsdShadeMaterialBindingAPI(mesh_prim).ComputeBoundMaterial().GetPath(),
+            material_path);
+  EXPECT_EQ(pxr::UsdShadeMaterialBindingAPI(mesh_prim_same).ComputeBoundMaterial().GetPath(),
+            material_path);
+  EXPECT_EQ(pxr::UsdShadeMaterialBindingAPI(mesh_prim_other).ComputeBoundMaterial().GetPath(),
+            other_material_path);
+}
+
 static const bNode *find_node_for_type_in_graph(const bNodeTree *nodetree,
                                                 const blender::StringRefNull type_idname)
 {
@@ -168,7 +168,7 @@ void OBJWriter::write_header() const
   FormatHandler fh;
   fh.write_string("# Blender "s + BKE_blender_version_string());
   fh.write_string("# www.blender.org");
-  fh.write_to_file(outfile_);
+  fh.write_to_file(*outfile_);
 }
 
 void OBJWriter::write_mtllib_name(const StringRefNull mtl_filepath) const
@@ -183,7 +183,7 @@ void OBJWriter::write_mtllib_name(const StringRefNull mtl_filepath) const
                           sizeof(mtl_file_name));
   FormatHandler fh;
   fh.write_obj_mtllib(mtl_file_name);
-  fh.write_to_file(outfile_);
+  fh.write_to_file(*outfile_);
 }
 
 static void spaces_to_underscores(std::string &r_name)
@@ -531,13 +531,17 @@ MTLWriter::MTLWriter(const char *obj_filepath) noexcept(false)
   char mtl_path[FILE_MAX];
   STRNCPY(mtl_path, obj_filepath);
 
+  /* Write `file.mtl` next to a compressed `file.obj.gz`, not `file.obj.mtl`. */
+  if (file_compression_from_path(mtl_path) != FileCompression::None) {
+    BLI_path_extension_strip(mtl_path);
+  }
   const bool ok = BLI_path_extension_replace(mtl_path, sizeof(mtl_path), ".mtl");
   if (!ok) {
     throw std::system_error(ENAMETOOLONG, std::system_category(), "");
   }
 
   mtl_filepath_ = mtl_path;
-  outfile_ = BLI_fopen(mtl_filepath_.c_str(), "wb");
+  outfile_ = FileWriter::open(mtl_filepath_.c_str());
   if (!outfile_) {
     throw std::system_error(errno, std::system_category(), "Cannot open file " + mtl_filepath_);
   }
@@ -545,8 +549,8 @@ MTLWriter::MTLWriter(const char *obj_filepath) noexcept(false)
 MTLWriter::~MTLWriter()
 {
   if (outfile_) {
-    fmt_handler_.write_to_file(outfile_);
-    if (std::fclose(outfile_)) {
+    fmt_handler_.write_to_file(*outfile_);
+    if (!outfile_->close()) {
       std::cerr << "Error: could not close the file '" << mtl_filepath_
                 << "' properly, it may be corrupted." << std::endl;
     }
@@ -17,6 +17,7 @@
 #include "obj_export_mtl.hh"
 
 #include <iostream>
+#include <memory>
 
 namespace blender::io::obj {
 
@@ -39,28 +40,29 @@ class OBJWriter : NonMovable, NonCopyable {
  private:
   const OBJExportParams &export_params_;
   std::string outfile_path_;
-  FILE *outfile_;
+  /** Compressed with Gzip or Zstd when the file path has a `.gz` or `.zst` extension. */
+  std::unique_ptr<FileWriter> outfile_;
 
  public:
   OBJWriter(const char *filepath, const OBJExportParams &export_params) noexcept(false)
-      : export_params_(export_params), outfile_path_(filepath), outfile_(nullptr)
+      : export_params_(export_params), outfile_path_(filepath)
   {
-    outfile_ = BLI_fopen(filepath, "wb");
+    outfile_ = FileWriter::open(filepath);
     if (!outfile_) {
       throw std::system_error(errno, std::system_category(), "Cannot open file " + outfile_path_);
     }
   }
   ~OBJWriter()
   {
-    if (outfile_ && std::fclose(outfile_)) {
+    if (outfile_ && !outfile_->close()) {
       std::cerr << "Error: could not close the file '" << outfile_path_
                 << "' properly, it may be corrupted." << std::endl;
     }
   }
 
-  FILE *get_outfile() const
+  FileWriter &get_outfile() const
   {
-    return outfile_;
+    return *outfile_;
   }
 
   void write_header() const;
@@ -167,7 +169,7 @@ class OBJWriter : NonMovable, NonCopyable {
 class MTLWriter : NonMovable, NonCopyable {
  private:
   FormatHandler fmt_handler_;
-  FILE *outfile_;
+  std::unique_ptr<FileWriter> outfile_;
   std::string mtl_filepath_;
   Vector<MTLMaterial> mtlmaterials_;
   /* Map from a Material* to an index into mtlmaterials_. */
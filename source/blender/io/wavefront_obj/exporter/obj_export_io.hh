@@ -17,6 +17,8 @@
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
 
+#include "IO_compressed_file.hh"
+
 /* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
 #undef SEP
 #include <fmt/format.h>
@@ -40,10 +42,10 @@ class FormatHandler : NonCopyable, NonMovable {
   FormatHandler(size_t buffer_chunk_size = 64 * 1024) : buffer_chunk_size_(buffer_chunk_size) {}
 
   /* Write contents to the buffer(s) into a file, and clear the buffers. */
-  void write_to_file(FILE *f)
+  void write_to_file(FileWriter &f)
   {
     for (const auto &b : blocks_) {
-      fwrite(b.data(), 1, b.size(), f);
+      f.write(b.data(), b.size());
     }
     blocks_.clear();
   }
@@ -8,6 +8,7 @@
 
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <system_error>
 
 #include "BKE_context.hh"
@@ -27,6 +28,8 @@
 
 #include "ED_object.hh"
 
+#include "IO_compressed_file.hh"
+
 #include "obj_export_mesh.hh"
 #include "obj_export_nurbs.hh"
 #include "obj_exporter.hh"
@@ -159,10 +162,25 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
 {
   /* Parallelization is over meshes/objects, which means
    * we have to have the output text buffer for each object,
-   * and write them all into the file at the end. */
+   * and write them into the file in order. */
   size_t count = exportable_as_mesh.size();
   Array<FormatHandler> buffers(count);
 
+  /* Object buffers are written as soon as all the previous objects are finished, so that writing
+   * overlaps with formatting the remaining objects and the memory is freed early. */
+  FileWriter &f = obj_writer.get_outfile();
+  std::mutex write_mutex;
+  Array<bool> finished(count, false);
+  int next_to_write = 0;
+  auto finish_object = [&](const int i) {
+    std::lock_guard lock{write_mutex};
+    finished[i] = true;
+    while (next_to_write < count && finished[next_to_write]) {
+      buffers[next_to_write].write_to_file(f);
+      next_to_write++;
+    }
+  };
+
   /* Serial: gather material indices, ensure normals & edges. */
   Vector<Vector<int>> mtlindices;
   if (mtl_writer) {
@@ -240,14 +258,11 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
       /* Nothing will need this object's data after this point, release
        * various arrays here. */
       obj.clear();
+
+      finish_object(i);
     }
   });
-
-  /* Write all the object text buffers into the output file. */
-  FILE *f = obj_writer.get_outfile();
-  for (auto &b : buffers) {
-    b.write_to_file(f);
-  }
+  BLI_assert(next_to_write == count);
 }
 
 /**
@@ -323,10 +338,26 @@ bool append_frame_to_filename(const char *filepath,
                               const int frame,
                               char r_filepath_with_frames[1024])
 {
+  /* Keep the compression suffix, so that `file.obj.gz` becomes `file0001.obj.gz`. */
+  const char *extension = ".obj";
+  switch (file_compression_from_path(filepath)) {
+    case FileCompression::None:
+      break;
+    case FileCompression::Gzip:
+      extension = ".obj.gz";
+      break;
+    case FileCompression::Zstd:
+      extension = ".obj.zst";
+      break;
+  }
+
   BLI_strncpy(r_filepath_with_frames, filepath, FILE_MAX);
   BLI_path_extension_strip(r_filepath_with_frames);
+  if (!STREQ(extension, ".obj") && BLI_path_extension_check(r_filepath_with_frames, ".obj")) {
+    BLI_path_extension_strip(r_filepath_with_frames);
+  }
   BLI_path_frame(r_filepath_with_frames, FILE_MAX, frame, 4);
-  return BLI_path_extension_replace(r_filepath_with_frames, FILE_MAX, ".obj");
+  return BLI_path_extension_replace(r_filepath_with_frames, FILE_MAX, extension);
 }
 
 void exporter_main(bContext *C, const OBJExportParams &export_params)
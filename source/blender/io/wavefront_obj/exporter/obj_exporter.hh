@@ -83,7 +83,8 @@ filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_par
  * Append the current frame number in the `.OBJ` file name.
  *
  * \param r_filepath_with_frames: The result of the `filepath` with its "#" characters
- * replaced by the number representing `frame`, and with an `.obj` extension.
+ * replaced by the number representing `frame`, and with an `.obj` extension. A `.gz` or `.zst`
+ * compression suffix is kept after the `.obj` extension.
  *
  * \return Whether the `filepath` is in #FILE_MAX limits.
  */
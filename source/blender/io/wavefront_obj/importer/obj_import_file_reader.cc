@@ -9,13 +9,17 @@
 #include "BKE_report.hh"
 
 #include "BLI_fileops.hh"
+#include "BLI_filereader.h"
 #include "BLI_map.hh"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
+#include "IO_compressed_file.hh"
+
 #include "obj_export_mtl.hh"
 #include "obj_import_file_reader.hh"
 #include "obj_import_string_utils.hh"
@@ -71,37 +75,75 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
-static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+/**
+ * Vertex positions, normals and UVs parsed ahead of the main parsing loop, in file order.
+ */
+struct ParsedVertexData {
+  Vector<float3> positions;
+  /** Linear `xyzrgb` color of every vertex, negative if the vertex has no color. */
+  Vector<float3> colors;
+  Vector<float3> normals;
+  Vector<float2> uvs;
+};
+
+static void parse_vertex(const char *p, const char *end, ParsedVertexData &r_data)
 {
   float3 vert;
   p = parse_floats(p, end, 0.0f, vert, 3);
-  r_global_vertices.vertices.append(vert);
+  r_data.positions.append(vert);
   /* OBJ extension: `xyzrgb` vertex colors, when the vertex position
    * is followed by 3 more RGB color components. See
    * http://paulbourke.net/dataformats/obj/colour.html */
+  float3 linear(-1.0f);
   if (p < end) {
     float3 srgb;
     p = parse_floats(p, end, -1.0f, srgb, 3);
     if (srgb.x >= 0 && srgb.y >= 0 && srgb.z >= 0) {
-      float3 linear;
       srgb_to_linearrgb_v3_v3(linear, srgb);
-
-      auto &blocks = r_global_vertices.vertex_colors;
-      /* If we don't have vertex colors yet, or the previous vertex
-       * was without color, we need to start a new vertex colors block. */
-      if (blocks.is_empty() || (blocks.last().start_vertex_index + blocks.last().colors.size() !=
-                                r_global_vertices.vertices.size() - 1))
-      {
-        GlobalVertices::VertexColorsBlock block;
-        block.start_vertex_index = r_global_vertices.vertices.size() - 1;
-        blocks.append(block);
-      }
-      blocks.last().colors.append(linear);
     }
   }
+  r_data.colors.append(linear);
   UNUSED_VARS(p);
 }
 
+static void parse_vertex_normal(const char *p, const char *end, ParsedVertexData &r_data)
+{
+  float3 normal;
+  parse_floats(p, end, 0.0f, normal, 3);
+  /* Normals can be printed with only several digits in the file,
+   * making them ever-so-slightly non unit length. Make sure they are
+   * normalized. */
+  normalize_v3(normal);
+  r_data.normals.append(normal);
+}
+
+static void parse_uv_vertex(const char *p, const char *end, ParsedVertexData &r_data)
+{
+  float2 uv;
+  parse_floats(p, end, 0.0f, uv, 2);
+  r_data.uvs.append(uv);
+}
+
+static void geom_add_vertex(const float3 &vert,
+                            const float3 &color,
+                            GlobalVertices &r_global_vertices)
+{
+  r_global_vertices.vertices.append(vert);
+  if (color.x >= 0 && color.y >= 0 && color.z >= 0) {
+    auto &blocks = r_global_vertices.vertex_colors;
+    /* If we don't have vertex colors yet, or the previous vertex
+     * was without color, we need to start a new vertex colors block. */
+    if (blocks.is_empty() || (blocks.last().start_vertex_index + blocks.last().colors.size() !=
+                              r_global_vertices.vertices.size() - 1))
+    {
+      GlobalVertices::VertexColorsBlock block;
+      block.start_vertex_index = r_global_vertices.vertices.size() - 1;
+      blocks.append(block);
+    }
+    blocks.last().colors.append(color);
+  }
+}
+
 static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices &r_global_vertices)
 {
   /* MRGB color extension, in the form of
@@ -142,26 +184,6 @@ static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices
   }
 }
 
-static void geom_add_vertex_normal(const char *p,
-                                   const char *end,
-                                   GlobalVertices &r_global_vertices)
-{
-  float3 normal;
-  parse_floats(p, end, 0.0f, normal, 3);
-  /* Normals can be printed with only several digits in the file,
-   * making them ever-so-slightly non unit length. Make sure they are
-   * normalized. */
-  normalize_v3(normal);
-  r_global_vertices.vert_normals.append(normal);
-}
-
-static void geom_add_uv_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
-{
-  float2 uv;
-  parse_floats(p, end, 0.0f, uv, 2);
-  r_global_vertices.uv_vertices.append(uv);
-}
-
 /**
  * Parse vertex index and transform to non-negative, zero-based.
  * Sets r_index to the index or INT32_MAX on error.
@@ -447,7 +469,7 @@ static void geom_new_object(const char *p,
 OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_size)
     : import_params_(import_params), read_buffer_size_(read_buffer_size)
 {
-  obj_file_ = BLI_fopen(import_params_.filepath, "rb");
+  obj_file_ = file_reader_open(import_params_.filepath);
   if (!obj_file_) {
     fprintf(stderr, "Cannot read from OBJ file:'%s'.\n", import_params_.filepath);
     BKE_reportf(import_params_.reports,
@@ -461,7 +483,7 @@ OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_si
 OBJParser::~OBJParser()
 {
   if (obj_file_) {
-    fclose(obj_file_);
+    obj_file_->close(obj_file_);
   }
 }
 
@@ -484,6 +506,61 @@ static bool parse_keyword(const char *&p, const char *end, StringRef keyword)
   return true;
 }
 
+static void parse_vertex_data_lines(StringRef buffer, ParsedVertexData &r_data)
+{
+  while (!buffer.is_empty()) {
+    StringRef line = read_next_line(buffer);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    if (p == end || *p != 'v') {
+      continue;
+    }
+    if (parse_keyword(p, end, "v")) {
+      parse_vertex(p, end, r_data);
+    }
+    else if (parse_keyword(p, end, "vn")) {
+      parse_vertex_normal(p, end, r_data);
+    }
+    else if (parse_keyword(p, end, "vt")) {
+      parse_uv_vertex(p, end, r_data);
+    }
+  }
+}
+
+/**
+ * Parse all vertex position, normal and UV lines of the buffer. Parsing their floats is usually
+ * most of the work of reading an OBJ file, and unlike the other elements it doesn't depend on any
+ * parser state, so it is done in parallel on line-aligned parts of the buffer.
+ */
+static void parse_vertex_data(StringRef buffer, ParsedVertexData &r_data)
+{
+  const int64_t part_size = 64 * 1024;
+  if (buffer.size() <= part_size) {
+    parse_vertex_data_lines(buffer, r_data);
+    return;
+  }
+
+  Vector<StringRef> parts;
+  while (!buffer.is_empty()) {
+    const int64_t line_end = buffer.find('\n', std::min(part_size, buffer.size()) - 1);
+    const int64_t size = line_end < 0 ? buffer.size() : line_end + 1;
+    parts.append(buffer.substr(0, size));
+    buffer = buffer.drop_prefix(size);
+  }
+  Array<ParsedVertexData> part_data(parts.size());
+  threading::parallel_for(parts.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      parse_vertex_data_lines(parts[i], part_data[i]);
+    }
+  });
+  for (const ParsedVertexData &data : part_data) {
+    r_data.positions.extend(data.positions);
+    r_data.colors.extend(data.colors);
+    r_data.normals.extend(data.normals);
+    r_data.uvs.extend(data.uvs);
+  }
+}
+
 /* Special case: if there were no faces/edges in any geometries,
  * treat all the vertices as a point cloud. */
 static void use_all_vertices_if_no_faces(Geometry *geom,
@@ -530,7 +607,8 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
   size_t line_number = 0;
   while (true) {
     /* Read a chunk of input from the file. */
-    size_t bytes_read = fread(buffer.data() + buffer_offset, 1, read_buffer_size_, obj_file_);
+    size_t bytes_read = file_reader_read(
+        obj_file_, buffer.data() + buffer_offset, read_buffer_size_);
     if (bytes_read == 0 && buffer_offset == 0) {
       break; /* No more data to read. */
     }
@@ -574,6 +652,11 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
     /* Parse the buffer (until last newline) that we have so far,
      * line by line. */
     StringRef buffer_str{buffer.data(), int64_t(last_nl)};
+    ParsedVertexData vertex_data;
+    parse_vertex_data(buffer_str, vertex_data);
+    int vertex_data_position = 0;
+    int vertex_data_normal = 0;
+    int vertex_data_uv = 0;
     while (!buffer_str.is_empty()) {
       StringRef line = read_next_line(buffer_str);
       const char *p = line.begin(), *end = line.end();
@@ -585,13 +668,16 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
       /* Most common things that start with 'v': vertices, normals, UVs. */
       if (*p == 'v') {
         if (parse_keyword(p, end, "v")) {
-          geom_add_vertex(p, end, r_global_vertices);
+          geom_add_vertex(vertex_data.positions[vertex_data_position],
+                          vertex_data.colors[vertex_data_position],
+                          r_global_vertices);
+          vertex_data_position++;
         }
         else if (parse_keyword(p, end, "vn")) {
-          geom_add_vertex_normal(p, end, r_global_vertices);
+          r_global_vertices.vert_normals.append(vertex_data.normals[vertex_data_normal++]);
         }
         else if (parse_keyword(p, end, "vt")) {
-          geom_add_uv_vertex(p, end, r_global_vertices);
+          r_global_vertices.uv_vertices.append(vertex_data.uvs[vertex_data_uv++]);
         }
       }
       /* Faces. */
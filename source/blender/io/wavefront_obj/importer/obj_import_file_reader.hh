@@ -15,6 +15,8 @@
 
 #include "obj_import_objects.hh"
 
+struct FileReader;
+
 namespace blender::io::obj {
 
 struct MTLMaterial;
@@ -24,7 +26,8 @@ struct MTLMaterial;
 class OBJParser {
  private:
   const OBJImportParams &import_params_;
-  FILE *obj_file_;
+  /** Reads the file contents, decompressing Gzip or Zstd compressed files. */
+  FileReader *obj_file_;
   Vector<std::string> mtl_libraries_;
   size_t read_buffer_size_;
 
@@ -127,6 +127,19 @@ TEST(obj_exporter_utils, append_large_positive_frame_to_filename)
   EXPECT_STREQ(path_with_frame, path_truth);
 }
 
+TEST(obj_exporter_utils, append_frame_to_compressed_filename)
+{
+  const char path_original_gz[FILE_MAX] = SEP_STR "my_file.obj.gz";
+  const char path_original_zst[FILE_MAX] = SEP_STR "my_file.OBJ.zst";
+  char path_with_frame[FILE_MAX] = {0};
+
+  EXPECT_TRUE(append_frame_to_filename(path_original_gz, 1, path_with_frame));
+  EXPECT_STREQ(path_with_frame, SEP_STR "my_file0001.obj.gz");
+
+  EXPECT_TRUE(append_frame_to_filename(path_original_zst, 25, path_with_frame));
+  EXPECT_STREQ(path_with_frame, SEP_STR "my_file0025.obj.zst");
+}
+
 static std::string read_temp_file_in_string(const std::string &file_path)
 {
   std::string res;
@@ -29,6 +29,8 @@
     .handle_readers = NULL, \
     .use_prefetch = 1, \
     .prefetch_cache_size = 4096, \
+    .sample_cache_size = 0, \
+    .prefetch_frames = 4, \
   }
 
 /** \} */
@@ -82,7 +82,8 @@ typedef struct CacheFile {
   /** The frame offset to subtract. */
   float frame_offset;
 
-  char _pad[4];
+  /** Size in megabytes of the cache of samples read for playback, zero disables the cache. */
+  int sample_cache_size;
 
   /** Animation flag. */
   short flag;
@@ -97,7 +98,9 @@ typedef struct CacheFile {
    */
   char use_render_procedural;
 
-  char _pad1[3];
+  /** Number of frames to read ahead into the sample cache during playback. */
+  short prefetch_frames;
+  char _pad1[1];
 
   /** Enable data prefetching when using the Cycles Procedural. */
   char use_prefetch;
@@ -18,6 +18,7 @@
 
 #  include <optional>
 
+#  include "BLI_index_mask_fwd.hh"
 #  include "BLI_math_vector_types.hh"
 
 namespace blender {
@@ -397,6 +398,12 @@ typedef struct Mesh {
 
   /** Call after changing vertex positions to tag lazily calculated caches for recomputation. */
   void tag_positions_changed();
+  /**
+   * Call after changing the positions of only some vertices. Normals that are already cached are
+   * updated around the changed vertices right away, instead of being recalculated for the whole
+   * mesh later on. Other caches are tagged like #tag_positions_changed.
+   */
+  void tag_positions_changed_partial(const blender::IndexMask &changed_verts);
   /** Call after moving every mesh vertex by the same translation. */
   void tag_positions_changed_uniformly();
   /** Like #tag_positions_changed but doesn't tag normals; they must be updated separately. */
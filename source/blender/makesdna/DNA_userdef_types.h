@@ -1081,7 +1081,8 @@ typedef struct UserDef {
 
   float collection_instance_empty_size;
   char text_flag;
-  char _pad10[1];
+  /** Number of frames the sequencer prefetches at the same time. */
+  char sequencer_prefetch_frames;
 
   char file_preview_type; /* eUserpref_File_Preview_Type */
   char statusbar_flag;    /* eUserpref_StatusBar_Flag */
@@ -307,6 +307,23 @@ static void rna_def_cachefile(BlenderRNA *brna)
       "fit within the limit, rendering is aborted");
   RNA_def_property_update(prop, 0, "rna_CacheFile_update");
 
+  prop = RNA_def_property(srna, "sample_cache_size", PROP_INT, PROP_UNSIGNED);
+  RNA_def_property_range(prop, 0, INT_MAX);
+  RNA_def_property_ui_range(prop, 0, 16384, 64, -1);
+  RNA_def_property_ui_text(prop,
+                           "Sample Cache Size",
+                           "Memory usage limit in megabytes for the cache of samples read during "
+                           "playback, zero disables the cache");
+  RNA_def_property_update(prop, 0, "rna_CacheFile_update");
+
+  prop = RNA_def_property(srna, "prefetch_frames", PROP_INT, PROP_NONE);
+  RNA_def_property_range(prop, 0, 128);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Frames",
+                           "Number of frames to read ahead into the sample cache in the "
+                           "background during playback");
+  RNA_def_property_update(prop, 0, "rna_CacheFile_update");
+
   /* ----------------- Axis Conversion ----------------- */
 
   prop = RNA_def_property(srna, "forward_axis", PROP_ENUM, PROP_NONE);
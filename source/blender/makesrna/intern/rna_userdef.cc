@@ -5969,6 +5969,15 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_enum_sdna(prop, nullptr, "sequencer_proxy_setup");
   RNA_def_property_ui_text(prop, "Proxy Setup", "When and how proxies are created");
 
+  prop = RNA_def_property(srna, "sequencer_prefetch_frames", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "sequencer_prefetch_frames");
+  RNA_def_property_range(prop, 1, 16);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Frames",
+                           "Number of frames that are rendered at the same time when prefetching. "
+                           "Each additional frame uses its own copy of the scene, which uses more "
+                           "memory");
+
   prop = RNA_def_property(srna, "scrollback", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_int_sdna(prop, nullptr, "scrollback");
   RNA_def_property_range(prop, 32, 32768);
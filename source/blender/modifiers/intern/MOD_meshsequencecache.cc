@@ -221,6 +221,8 @@ static void modify_geometry_set(ModifierData *md,
       params.read_flags = mcmd->read_flag;
       params.velocity_name = mcmd->cache_file->velocity_name;
       params.velocity_scale = velocity_scale;
+      params.sample_cache_size = cache_file->sample_cache_size;
+      params.prefetch_frames = cache_file->prefetch_frames;
       ABC_read_geometry(mcmd->reader, ctx->object, *geometry_set, &params, &err_str);
 #  endif
       break;
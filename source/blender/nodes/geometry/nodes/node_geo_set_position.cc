@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_array_utils.hh"
+
 #include "BKE_curves.hh"
 #include "BKE_grease_pencil.hh"
 #include "BKE_instances.hh"
@@ -52,6 +54,25 @@ static void set_points_position(bke::MutableAttributeAccessor attributes,
                                      position_field);
 }
 
+static void set_mesh_position(Mesh &mesh,
+                              const Field<bool> &selection_field,
+                              const Field<float3> &position_field)
+{
+  /* Evaluate the selection explicitly instead of capturing the field on the attribute, so that
+   * only the normals around the moved vertices have to be updated. */
+  const bke::MeshFieldContext field_context(mesh, bke::AttrDomain::Point);
+  fn::FieldEvaluator evaluator(field_context, mesh.verts_num);
+  evaluator.set_selection(selection_field);
+  evaluator.add(position_field);
+  evaluator.evaluate();
+  const IndexMask selection = evaluator.get_evaluated_selection_as_mask();
+  if (selection.is_empty()) {
+    return;
+  }
+  array_utils::copy(evaluator.get_evaluated(0), selection, mesh.vert_positions_for_write());
+  mesh.tag_positions_changed_partial(selection);
+}
+
 static void set_curves_position(bke::CurvesGeometry &curves,
                                 const fn::FieldContext &field_context,
                                 const Field<bool> &selection_field,
@@ -127,10 +148,7 @@ static void node_geo_exec(GeoNodeExecParams params)
                                   params.extract_input<Field<float3>>("Offset")}));
 
   if (Mesh *mesh = geometry.get_mesh_for_write()) {
-    set_points_position(mesh->attributes_for_write(),
-                        bke::MeshFieldContext(*mesh, bke::AttrDomain::Point),
-                        selection_field,
-                        position_field);
+    set_mesh_position(*mesh, selection_field, position_field);
   }
   if (PointCloud *point_cloud = geometry.get_pointcloud_for_write()) {
     set_points_position(point_cloud->attributes_for_write(),
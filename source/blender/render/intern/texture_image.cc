@@ -27,6 +27,7 @@
 #include "BLI_math_color.h"
 #include "BLI_math_interp.hh"
 #include "BLI_math_vector.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -920,18 +921,23 @@ static void alpha_clip_aniso(const ImBuf *ibuf,
 static void image_mipmap_test(Tex *tex, ImBuf *ibuf)
 {
   if (tex->imaflag & TEX_MIPMAP) {
-    if (ibuf->mipmap[0] && (ibuf->userflags & IB_MIPMAP_INVALID)) {
+    const int invalid_flags = IB_MIPMAP_INVALID | IB_MIPMAP_INVALID_REGION;
+    if (ibuf->mipmap[0] && (ibuf->userflags & invalid_flags)) {
       BLI_thread_lock(LOCK_IMAGE);
-      if (ibuf->userflags & IB_MIPMAP_INVALID) {
-        IMB_remakemipmap(ibuf, tex->imaflag & TEX_GAUSS_MIP);
-        ibuf->userflags &= ~IB_MIPMAP_INVALID;
+      if (ibuf->userflags & invalid_flags) {
+        /* Mipmap creation is multi-threaded, isolate it so that this thread does not pick up
+         * other tasks that need the image lock while it is held. */
+        blender::threading::isolate_task(
+            [&]() { IMB_remakemipmap(ibuf, tex->imaflag & TEX_GAUSS_MIP); });
+        ibuf->userflags &= ~invalid_flags;
       }
       BLI_thread_unlock(LOCK_IMAGE);
     }
     if (ibuf->mipmap[0] == nullptr) {
       BLI_thread_lock(LOCK_IMAGE);
       if (ibuf->mipmap[0] == nullptr) {
-        IMB_makemipmap(ibuf, tex->imaflag & TEX_GAUSS_MIP);
+        blender::threading::isolate_task(
+            [&]() { IMB_makemipmap(ibuf, tex->imaflag & TEX_GAUSS_MIP); });
       }
       BLI_thread_unlock(LOCK_IMAGE);
     }
@@ -29,6 +29,11 @@ bool SEQ_proxy_rebuild_context(Main *bmain,
                                ListBase *queue,
                                bool build_only_on_bad_performance);
 void SEQ_proxy_rebuild(SeqIndexBuildContext *context, wmJobWorkerStatus *worker_status);
+/**
+ * Whether the proxies of the context are built without rendering through the sequencer, which
+ * allows building them concurrently with other strips.
+ */
+bool SEQ_proxy_rebuild_is_independent(const SeqIndexBuildContext *context);
 void SEQ_proxy_rebuild_finish(SeqIndexBuildContext *context, bool stop);
 void SEQ_proxy_set(Sequence *seq, bool value);
 bool SEQ_can_use_proxy(const SeqRenderData *context, Sequence *seq, int psize);
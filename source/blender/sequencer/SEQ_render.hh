@@ -44,6 +44,8 @@ struct SeqRenderData {
   int view_id;
   /* ID of task for assigning temp cache entries to particular task(thread, etc.) */
   eSeqTaskId task_id;
+  /* Prefetch worker that renders the frame, as workers render different frames at once. */
+  int worker_index;
 
   /* special case for OpenGL render */
   GPUOffScreen *gpu_offscreen;
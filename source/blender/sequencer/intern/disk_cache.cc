@@ -10,6 +10,8 @@
 #include <ctime>
 #include <memory.h>
 
+#include <zstd.h>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_scene_types.h"
@@ -19,13 +21,16 @@
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
 #include "BLI_fileops.h"
 #include "BLI_fileops_types.h"
 #include "BLI_listbase.h"
+#include "BLI_mmap.h"
 #include "BLI_path_util.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 
 #include "BKE_main.hh"
@@ -44,7 +49,11 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * ZLIB compression with user definable level can be used to compress image data(per image)
+ * Zstd compression with user definable level can be used to compress image data(per image).
+ * Float images are split into byte planes before compression, this groups the similar sign and
+ * exponent bytes of neighboring pixels and compresses much better than interleaved floats.
+ * Images are compressed before the file is locked, so that frames rendered by multiple threads
+ * are compressed in parallel. Reading maps the file to memory and decompresses in one go.
  * Images are written in order in which they are rendered.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
@@ -57,11 +66,15 @@
  * `<cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf`. */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_CURRENT_VERSION 3
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in IMB intern. */
 
+/* #DiskCacheHeaderEntry.flag */
+#define DCACHE_ENTRY_BYTE_PLANES (1 << 0)
+
 struct DiskCacheHeaderEntry {
   uchar encoding;
+  uchar flag;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -416,41 +429,146 @@ void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+static size_t seq_disk_cache_image_size_raw(const ImBuf *ibuf)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
+  if (ibuf->byte_buffer.data) {
+    return size_t(ibuf->x) * ibuf->y * ibuf->channels;
+  }
+  return size_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
+}
+
+/* Store byte N of every float in plane N. */
+static void byte_planes_split(const uchar *src, uchar *dst, const size_t floats_num)
+{
+  using namespace blender;
+  threading::parallel_for(IndexRange(floats_num), 64 * 1024, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      for (int plane = 0; plane < 4; plane++) {
+        dst[plane * floats_num + i] = src[i * 4 + plane];
+      }
+    }
+  });
+}
+
+static void byte_planes_merge(const uchar *src, uchar *dst, const size_t floats_num)
+{
+  using namespace blender;
+  threading::parallel_for(IndexRange(floats_num), 64 * 1024, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      for (int plane = 0; plane < 4; plane++) {
+        dst[i * 4 + plane] = src[plane * floats_num + i];
+      }
+    }
+  });
+}
+
+/** Image data as it is written to the cache file. */
+struct DiskCacheEncodedImage {
+  /** Points to the pixels of the image buffer, or to #compressed. */
+  const void *data = nullptr;
+  size_t size = 0;
+  uchar flag = 0;
+  blender::Array<uchar> compressed;
+};
+
+static bool encode_imbuf(const ImBuf *ibuf, const int level, DiskCacheEncodedImage &r_image)
+{
+  using namespace blender;
+  const void *pixels = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
+                                                             (void *)ibuf->float_buffer.data;
+  const size_t size_raw = seq_disk_cache_image_size_raw(ibuf);
+
+  /* Without compression the pixels are written directly to the file. */
+  if (level <= 0) {
+    r_image.data = pixels;
+    r_image.size = size_raw;
+    return true;
+  }
 
-  /* Apply compression if wanted, otherwise just write directly to the file. */
-  if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
+  Array<uchar> planes;
+  if (ibuf->byte_buffer.data == nullptr) {
+    planes = Array<uchar>(size_raw, NoInitialization());
+    byte_planes_split(static_cast<const uchar *>(pixels), planes.data(), size_raw / 4);
+    pixels = planes.data();
+    r_image.flag |= DCACHE_ENTRY_BYTE_PLANES;
   }
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fwrite(data, 1, header_entry->size_raw, file);
+  ZSTD_CCtx *ctx = ZSTD_createCCtx();
+  ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, level);
+  /* Large images are split into blocks which are compressed in parallel. */
+  ZSTD_CCtx_setParameter(ctx, ZSTD_c_nbWorkers, BLI_system_thread_count());
+
+  r_image.compressed = Array<uchar>(ZSTD_compressBound(size_raw), NoInitialization());
+  const size_t size = ZSTD_compress2(
+      ctx, r_image.compressed.data(), r_image.compressed.size(), pixels, size_raw);
+  ZSTD_freeCCtx(ctx);
+
+  if (ZSTD_isError(size)) {
+    return false;
+  }
+  r_image.data = r_image.compressed.data();
+  r_image.size = size;
+  return true;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+static size_t write_encoded_image_to_file(const DiskCacheEncodedImage &image,
+                                          FILE *file,
+                                          const DiskCacheHeaderEntry *header_entry)
 {
+  BLI_fseek(file, header_entry->offset, SEEK_SET);
+  if (fwrite(image.data, 1, image.size, file) != image.size) {
+    return 0;
+  }
+  return image.size;
+}
+
+static size_t read_file_to_imbuf(ImBuf *ibuf, FILE *file, const DiskCacheHeaderEntry *header_entry)
+{
+  using namespace blender;
   void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
                                                      (void *)ibuf->float_buffer.data;
-  char header[4];
-  fseek(file, header_entry->offset, SEEK_SET);
-  if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+  const size_t size_raw = header_entry->size_raw;
+  const size_t size_compressed = header_entry->size_compressed;
+
+  BLI_mmap_file *mmap_file = BLI_mmap_open(fileno(file));
+  if (mmap_file == nullptr) {
     return 0;
   }
+  if (header_entry->offset + size_compressed > BLI_mmap_get_length(mmap_file) ||
+      size_compressed < 4)
+  {
+    BLI_mmap_free(mmap_file);
+    return 0;
+  }
+
+  const char *mem = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file)) +
+                    header_entry->offset;
+  size_t bytes_read = 0;
 
   /* Check if the data is compressed or raw. */
-  if (BLI_file_magic_is_zstd(header)) {
-    return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+  if (BLI_file_magic_is_zstd(mem)) {
+    Array<uchar> planes;
+    void *dst = data;
+    if (header_entry->flag & DCACHE_ENTRY_BYTE_PLANES) {
+      planes = Array<uchar>(size_raw, NoInitialization());
+      dst = planes.data();
+    }
+    bytes_read = ZSTD_decompress(dst, size_raw, mem, size_compressed);
+    if (ZSTD_isError(bytes_read)) {
+      bytes_read = 0;
+    }
+    else if (!planes.is_empty()) {
+      byte_planes_merge(planes.data(), static_cast<uchar *>(data), size_raw / 4);
+    }
+  }
+  else if (size_compressed == size_raw &&
+           BLI_mmap_read(mmap_file, data, header_entry->offset, size_raw))
+  {
+    bytes_read = size_raw;
   }
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fread(data, 1, header_entry->size_raw, file);
+  BLI_mmap_free(mmap_file);
+  return bytes_read;
 }
 
 static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -516,14 +634,14 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
   header->entry[i].offset = offset;
   header->entry[i].frameno = key->frame_index;
 
+  header->entry[i].size_raw = seq_disk_cache_image_size_raw(ibuf);
+
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
   if (ibuf->byte_buffer.data) {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
   else {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
   }
   STRNCPY(header->entry[i].colorspace_name, colorspace_name);
@@ -544,6 +662,12 @@ static int seq_disk_cache_get_header_entry(SeqCacheKey *key, const DiskCacheHead
 
 bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
 {
+  /* Compress without holding the lock, so multiple frames can be compressed at once. */
+  DiskCacheEncodedImage image;
+  if (!encode_imbuf(ibuf, seq_disk_cache_compression_level(), image)) {
+    return false;
+  }
+
   BLI_mutex_lock(&disk_cache->read_write_mutex);
 
   char filepath[FILE_MAX];
@@ -574,9 +698,9 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
     return false;
   }
   int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  header.entry[entry_index].flag = image.flag;
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  size_t bytes_written = write_encoded_image_to_file(image, file, &header.entry[entry_index]);
 
   if (bytes_written != 0) {
     /* Last step is writing header, as image data can be overwritten,
@@ -648,7 +772,7 @@ ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
     return nullptr;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  size_t bytes_read = read_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
 
   /* Sanity check. */
   if (bytes_read != expected_size) {
@@ -11,6 +11,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 
 #include "MEM_guardedalloc.h"
 
@@ -20,6 +21,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
@@ -118,10 +120,68 @@ static void slice_get_float_buffers(const SeqRenderData *context,
   }
 }
 
+/* The SIMD code paths process one RGBA pixel per vector (or four byte pixels), and give the same
+ * results as the scalar code. */
+
+#if BLI_HAVE_SSE2
+
+static __m128 blend_sse(const __m128 mask, const __m128 a, const __m128 b)
+{
+#  if BLI_HAVE_SSE4
+  return _mm_blendv_ps(b, a, mask);
+#  else
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#  endif
+}
+
+static __m128 alpha_lane_mask_sse()
+{
+  return _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+}
+
+static __m128 broadcast_alpha_sse(const __m128 pixel)
+{
+  return _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Same as #straight_uchar_to_premul_float. */
+static __m128 load_premul_pixel_sse(const uchar *ptr)
+{
+  int value;
+  memcpy(&value, ptr, sizeof(value));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bytes = _mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero);
+  const __m128 pixel = _mm_cvtepi32_ps(_mm_unpacklo_epi16(bytes, zero));
+  const __m128 alpha = _mm_mul_ps(broadcast_alpha_sse(pixel), _mm_set1_ps(1.0f / 255.0f));
+  const __m128 premul = _mm_mul_ps(pixel, _mm_mul_ps(alpha, _mm_set1_ps(1.0f / 255.0f)));
+  return blend_sse(alpha_lane_mask_sse(), alpha, premul);
+}
+
+/* Same as #premul_float_to_straight_uchar. */
+static void store_premul_pixel_sse(const __m128 pixel, uchar *dst)
+{
+  const __m128 alpha = broadcast_alpha_sse(pixel);
+  const __m128 straight = _mm_mul_ps(pixel, _mm_div_ps(_mm_set1_ps(1.0f), alpha));
+  const __m128 keep = _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), alpha_lane_mask_sse());
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(blend_sse(keep, pixel, straight), _mm_setzero_ps()),
+                                    _mm_set1_ps(1.0f));
+  const __m128i values = _mm_cvttps_epi32(
+      _mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+  const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(values, values), values);
+  const int value = _mm_cvtsi128_si32(packed);
+  memcpy(dst, &value, sizeof(value));
+}
+
+#endif /* BLI_HAVE_SSE2 */
+
 static float4 load_premul_pixel(const uchar *ptr)
 {
   float4 res;
+#if BLI_HAVE_SSE2
+  _mm_storeu_ps(res, load_premul_pixel_sse(ptr));
+#else
   straight_uchar_to_premul_float(res, ptr);
+#endif
   return res;
 }
 
@@ -132,7 +192,11 @@ static float4 load_premul_pixel(const float *ptr)
 
 static void store_premul_pixel(const float4 &pix, uchar *dst)
 {
+#if BLI_HAVE_SSE2
+  store_premul_pixel_sse(_mm_loadu_ps(pix), dst);
+#else
   premul_float_to_straight_uchar(dst, pix);
+#endif
 }
 
 static void store_premul_pixel(const float4 &pix, float *dst)
@@ -392,6 +456,33 @@ static void do_cross_effect_byte(float fac, int x, int y, uchar *rect1, uchar *r
   int temp_fac = int(256.0f * fac);
   int temp_mfac = 256 - temp_fac;
 
+#if BLI_HAVE_SSE2
+  /* The weighted sum fits in 16 bits as long as both factors are positive. */
+  if (temp_fac >= 0 && temp_mfac >= 0) {
+    const int64_t pixels_num = int64_t(x) * y;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fac_v = _mm_set1_epi16(short(temp_fac));
+    const __m128i mfac_v = _mm_set1_epi16(short(temp_mfac));
+    int64_t i = 0;
+    for (; i + 4 <= pixels_num; i += 4, rt1 += 16, rt2 += 16, rt += 16) {
+      const __m128i col1 = _mm_loadu_si128((const __m128i *)rt1);
+      const __m128i col2 = _mm_loadu_si128((const __m128i *)rt2);
+      const __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(col1, zero), mfac_v),
+                                       _mm_mullo_epi16(_mm_unpacklo_epi8(col2, zero), fac_v));
+      const __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(col1, zero), mfac_v),
+                                       _mm_mullo_epi16(_mm_unpackhi_epi8(col2, zero), fac_v));
+      _mm_storeu_si128((__m128i *)rt,
+                       _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+    for (; i < pixels_num; i++, rt1 += 4, rt2 += 4, rt += 4) {
+      for (int c = 0; c < 4; c++) {
+        rt[c] = (temp_mfac * rt1[c] + temp_fac * rt2[c]) >> 8;
+      }
+    }
+    return;
+  }
+#endif
+
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       rt[0] = (temp_mfac * rt1[0] + temp_fac * rt2[0]) >> 8;
@@ -414,6 +505,15 @@ static void do_cross_effect_float(float fac, int x, int y, float *rect1, float *
 
   float mfac = 1.0f - fac;
 
+#if BLI_HAVE_SSE2
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 mfac_v = _mm_set1_ps(mfac);
+  for (int64_t i = 0; i < int64_t(x) * y; i++, rt1 += 4, rt2 += 4, rt += 4) {
+    _mm_storeu_ps(rt,
+                  _mm_add_ps(_mm_mul_ps(mfac_v, _mm_loadu_ps(rt1)),
+                             _mm_mul_ps(fac_v, _mm_loadu_ps(rt2))));
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       rt[0] = mfac * rt1[0] + fac * rt2[0];
@@ -426,6 +526,7 @@ static void do_cross_effect_float(float fac, int x, int y, float *rect1, float *
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_cross_effect(const SeqRenderData *context,
@@ -547,6 +648,59 @@ static void do_gammacross_effect(const SeqRenderData *context,
 /** \name Color Add Effect
  * \{ */
 
+#if BLI_HAVE_SSE2
+/**
+ * `(temp_fac * src2_alpha * src2) >> 16` for the color channels of two pixels stored as 16 bit
+ * integers, and zero for alpha. Requires `0 <= temp_fac <= 256`.
+ */
+static __m128i add_sub_effect_term_sse(const __m128i col2, const __m128i temp_fac)
+{
+  const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(col2, _MM_SHUFFLE(3, 3, 3, 3)),
+                                            _MM_SHUFFLE(3, 3, 3, 3));
+  const __m128i color_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+  const __m128i temp_fac2 = _mm_and_si128(_mm_mullo_epi16(alpha, temp_fac), color_mask);
+  return _mm_mulhi_epu16(temp_fac2, col2);
+}
+
+/**
+ * Applies the add or subtract effect to four byte pixels at a time, returns the number of pixels
+ * that were processed.
+ */
+template<bool is_sub>
+static int64_t do_add_sub_effect_byte_sse(const int temp_fac,
+                                          const int64_t pixels_num,
+                                          const uchar *rect1,
+                                          const uchar *rect2,
+                                          uchar *out)
+{
+  if (temp_fac < 0 || temp_fac > 256) {
+    return 0;
+  }
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i temp_fac_v = _mm_set1_epi16(short(temp_fac));
+  int64_t i = 0;
+  for (; i + 4 <= pixels_num; i += 4, rect1 += 16, rect2 += 16, out += 16) {
+    const __m128i col1 = _mm_loadu_si128((const __m128i *)rect1);
+    const __m128i col2 = _mm_loadu_si128((const __m128i *)rect2);
+    const __m128i term_lo = add_sub_effect_term_sse(_mm_unpacklo_epi8(col2, zero), temp_fac_v);
+    const __m128i term_hi = add_sub_effect_term_sse(_mm_unpackhi_epi8(col2, zero), temp_fac_v);
+    __m128i lo = _mm_unpacklo_epi8(col1, zero);
+    __m128i hi = _mm_unpackhi_epi8(col1, zero);
+    if constexpr (is_sub) {
+      lo = _mm_subs_epu16(lo, term_lo);
+      hi = _mm_subs_epu16(hi, term_hi);
+    }
+    else {
+      /* Values above 255 are clamped by the packing. */
+      lo = _mm_add_epi16(lo, term_lo);
+      hi = _mm_add_epi16(hi, term_hi);
+    }
+    _mm_storeu_si128((__m128i *)out, _mm_packus_epi16(lo, hi));
+  }
+  return i;
+}
+#endif
+
 static void do_add_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rect2, uchar *out)
 {
   uchar *cp1 = rect1;
@@ -554,19 +708,26 @@ static void do_add_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rec
   uchar *rt = out;
 
   int temp_fac = int(256.0f * fac);
+  const int64_t pixels_num = int64_t(x) * y;
+  int64_t i = 0;
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      const int temp_fac2 = temp_fac * int(cp2[3]);
-      rt[0] = min_ii(cp1[0] + ((temp_fac2 * cp2[0]) >> 16), 255);
-      rt[1] = min_ii(cp1[1] + ((temp_fac2 * cp2[1]) >> 16), 255);
-      rt[2] = min_ii(cp1[2] + ((temp_fac2 * cp2[2]) >> 16), 255);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+#if BLI_HAVE_SSE2
+  i = do_add_sub_effect_byte_sse<false>(temp_fac, pixels_num, cp1, cp2, rt);
+  cp1 += i * 4;
+  cp2 += i * 4;
+  rt += i * 4;
+#endif
+
+  for (; i < pixels_num; i++) {
+    const int temp_fac2 = temp_fac * int(cp2[3]);
+    rt[0] = min_ii(cp1[0] + ((temp_fac2 * cp2[0]) >> 16), 255);
+    rt[1] = min_ii(cp1[1] + ((temp_fac2 * cp2[1]) >> 16), 255);
+    rt[2] = min_ii(cp1[2] + ((temp_fac2 * cp2[2]) >> 16), 255);
+    rt[3] = cp1[3];
+
+    cp1 += 4;
+    cp2 += 4;
+    rt += 4;
   }
 }
 
@@ -576,6 +737,19 @@ static void do_add_effect_float(float fac, int x, int y, float *rect1, float *re
   float *rt2 = rect2;
   float *rt = out;
 
+#if BLI_HAVE_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 mfac = _mm_set1_ps(1.0f - fac);
+  const __m128 alpha_mask = alpha_lane_mask_sse();
+  for (int64_t i = 0; i < int64_t(x) * y; i++, rt1 += 4, rt2 += 4, rt += 4) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    const __m128 temp_fac = _mm_mul_ps(
+        _mm_sub_ps(one, _mm_mul_ps(broadcast_alpha_sse(col1), mfac)), broadcast_alpha_sse(col2));
+    const __m128 col = _mm_add_ps(col1, _mm_mul_ps(temp_fac, col2));
+    _mm_storeu_ps(rt, blend_sse(alpha_mask, col1, col));
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       const float temp_fac = (1.0f - (rt1[3] * (1.0f - fac))) * rt2[3];
@@ -589,6 +763,7 @@ static void do_add_effect_float(float fac, int x, int y, float *rect1, float *re
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_add_effect(const SeqRenderData *context,
@@ -633,19 +808,26 @@ static void do_sub_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rec
   uchar *rt = out;
 
   int temp_fac = int(256.0f * fac);
+  const int64_t pixels_num = int64_t(x) * y;
+  int64_t i = 0;
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      const int temp_fac2 = temp_fac * int(cp2[3]);
-      rt[0] = max_ii(cp1[0] - ((temp_fac2 * cp2[0]) >> 16), 0);
-      rt[1] = max_ii(cp1[1] - ((temp_fac2 * cp2[1]) >> 16), 0);
-      rt[2] = max_ii(cp1[2] - ((temp_fac2 * cp2[2]) >> 16), 0);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+#if BLI_HAVE_SSE2
+  i = do_add_sub_effect_byte_sse<true>(temp_fac, pixels_num, cp1, cp2, rt);
+  cp1 += i * 4;
+  cp2 += i * 4;
+  rt += i * 4;
+#endif
+
+  for (; i < pixels_num; i++) {
+    const int temp_fac2 = temp_fac * int(cp2[3]);
+    rt[0] = max_ii(cp1[0] - ((temp_fac2 * cp2[0]) >> 16), 0);
+    rt[1] = max_ii(cp1[1] - ((temp_fac2 * cp2[1]) >> 16), 0);
+    rt[2] = max_ii(cp1[2] - ((temp_fac2 * cp2[2]) >> 16), 0);
+    rt[3] = cp1[3];
+
+    cp1 += 4;
+    cp2 += 4;
+    rt += 4;
   }
 }
 
@@ -657,6 +839,19 @@ static void do_sub_effect_float(float fac, int x, int y, float *rect1, float *re
 
   float mfac = 1.0f - fac;
 
+#if BLI_HAVE_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 mfac_v = _mm_set1_ps(mfac);
+  const __m128 alpha_mask = alpha_lane_mask_sse();
+  for (int64_t i = 0; i < int64_t(x) * y; i++, rt1 += 4, rt2 += 4, rt += 4) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    const __m128 temp_fac = _mm_mul_ps(
+        _mm_sub_ps(one, _mm_mul_ps(broadcast_alpha_sse(col1), mfac_v)), broadcast_alpha_sse(col2));
+    const __m128 col = _mm_max_ps(_mm_sub_ps(col1, _mm_mul_ps(temp_fac, col2)), _mm_setzero_ps());
+    _mm_storeu_ps(rt, blend_sse(alpha_mask, col1, col));
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       const float temp_fac = (1.0f - (rt1[3] * mfac)) * rt2[3];
@@ -670,6 +865,7 @@ static void do_sub_effect_float(float fac, int x, int y, float *rect1, float *re
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_sub_effect(const SeqRenderData *context,
@@ -796,18 +992,46 @@ static void do_mul_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rec
    * `fac * (a * b) + (1 - fac) * a => fac * a * (b - 1) + axaux = c * px + py * s;` // + centx
    * `yaux = -s * px + c * py;` // + centy */
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      rt[0] = rt1[0] + ((temp_fac * rt1[0] * (rt2[0] - 255)) >> 16);
-      rt[1] = rt1[1] + ((temp_fac * rt1[1] * (rt2[1] - 255)) >> 16);
-      rt[2] = rt1[2] + ((temp_fac * rt1[2] * (rt2[2] - 255)) >> 16);
-      rt[3] = rt1[3] + ((temp_fac * rt1[3] * (rt2[3] - 255)) >> 16);
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
+  const int64_t pixels_num = int64_t(x) * y;
+  int64_t i = 0;
+
+#if BLI_HAVE_SSE2
+  if (temp_fac >= 0 && temp_fac <= 256) {
+    /* The product is negative, shifting it rounds down. So subtract the rounded up product of
+     * `temp_fac * a` and `255 - b`, using the high and low 16 bits of the unsigned product. */
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i all_ones = _mm_set1_epi16(-1);
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i temp_fac_v = _mm_set1_epi16(short(temp_fac));
+    for (; i + 4 <= pixels_num; i += 4, rt1 += 16, rt2 += 16, rt += 16) {
+      const __m128i col1 = _mm_loadu_si128((const __m128i *)rt1);
+      const __m128i col2 = _mm_loadu_si128((const __m128i *)rt2);
+      __m128i result[2];
+      for (int part = 0; part < 2; part++) {
+        const __m128i a = part ? _mm_unpackhi_epi8(col1, zero) : _mm_unpacklo_epi8(col1, zero);
+        const __m128i b = part ? _mm_unpackhi_epi8(col2, zero) : _mm_unpacklo_epi8(col2, zero);
+        const __m128i fac_a = _mm_mullo_epi16(temp_fac_v, a);
+        const __m128i inv_b = _mm_sub_epi16(full, b);
+        const __m128i product_hi = _mm_mulhi_epu16(fac_a, inv_b);
+        const __m128i product_lo = _mm_mullo_epi16(fac_a, inv_b);
+        const __m128i has_remainder = _mm_xor_si128(_mm_cmpeq_epi16(product_lo, zero), all_ones);
+        result[part] = _mm_sub_epi16(a, _mm_sub_epi16(product_hi, has_remainder));
+      }
+      _mm_storeu_si128((__m128i *)rt, _mm_packus_epi16(result[0], result[1]));
     }
   }
+#endif
+
+  for (; i < pixels_num; i++) {
+    rt[0] = rt1[0] + ((temp_fac * rt1[0] * (rt2[0] - 255)) >> 16);
+    rt[1] = rt1[1] + ((temp_fac * rt1[1] * (rt2[1] - 255)) >> 16);
+    rt[2] = rt1[2] + ((temp_fac * rt1[2] * (rt2[2] - 255)) >> 16);
+    rt[3] = rt1[3] + ((temp_fac * rt1[3] * (rt2[3] - 255)) >> 16);
+
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
+  }
 }
 
 static void do_mul_effect_float(float fac, int x, int y, float *rect1, float *rect2, float *out)
@@ -819,6 +1043,16 @@ static void do_mul_effect_float(float fac, int x, int y, float *rect1, float *re
   /* Formula:
    * `fac * (a * b) + (1 - fac) * a => fac * a * (b - 1) + a`. */
 
+#if BLI_HAVE_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 fac_v = _mm_set1_ps(fac);
+  for (int64_t i = 0; i < int64_t(x) * y; i++, rt1 += 4, rt2 += 4, rt += 4) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    _mm_storeu_ps(
+        rt, _mm_add_ps(col1, _mm_mul_ps(_mm_mul_ps(fac_v, col1), _mm_sub_ps(col2, one))));
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       rt[0] = rt1[0] + fac * rt1[0] * (rt2[0] - 1.0f);
@@ -831,6 +1065,7 @@ static void do_mul_effect_float(float fac, int x, int y, float *rect1, float *re
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_mul_effect(const SeqRenderData *context,
@@ -871,14 +1106,13 @@ static void do_mul_effect(const SeqRenderData *context,
 /* blend_function has to be: void (T* dst, const T *src1, const T *src2) */
 template<typename T, typename Func>
 static void apply_blend_function(
-    float fac, int width, int height, const T *src1, T *src2, T *dst, Func blend_function)
+    float fac, int width, int height, const T *src1, const T *src2, T *dst, Func blend_function)
 {
   for (int y = 0; y < height; y++) {
     for (int x = 0; x < width; x++) {
-      T achannel = src2[3];
-      src2[3] = T(achannel * fac);
-      blend_function(dst, src1, src2);
-      src2[3] = achannel;
+      /* Blend with a copy of the pixel, the input buffer may be used by other threads. */
+      const T src2_fac[4] = {src2[0], src2[1], src2[2], T(src2[3] * fac)};
+      blend_function(dst, src1, src2_fac);
       dst[3] = src1[3];
       src1 += 4;
       src2 += 4;
@@ -887,9 +1121,124 @@ static void apply_blend_function(
   }
 }
 
+#if BLI_HAVE_SSE2
+
+/**
+ * Same as #apply_blend_function, with a blend function that has to be:
+ * `__m128 (__m128 src1, __m128 src2, __m128 fac)`, where `fac` is the alpha of `src2` multiplied
+ * by the effect factor. Only the color channels of the result are used.
+ */
+template<typename Func>
+static void apply_blend_function_sse(float fac,
+                                     int width,
+                                     int height,
+                                     const float *src1,
+                                     const float *src2,
+                                     float *dst,
+                                     Func blend_function)
+{
+  const __m128 alpha_mask = alpha_lane_mask_sse();
+  for (int64_t i = 0; i < int64_t(width) * height; i++, src1 += 4, src2 += 4, dst += 4) {
+    const __m128 col1 = _mm_loadu_ps(src1);
+    const float t = src2[3] * fac;
+    if (t == 0.0f) {
+      /* No-op, like the blend functions do when the alpha of `src2` is zero. */
+      _mm_storeu_ps(dst, col1);
+      continue;
+    }
+    const __m128 col = blend_function(col1, _mm_loadu_ps(src2), _mm_set1_ps(t));
+    _mm_storeu_ps(dst, blend_sse(alpha_mask, col1, col));
+  }
+}
+
+/**
+ * Vectorized versions of the `blend_color_*_float` functions for the simpler blend modes,
+ * returns false when the blend mode is not supported.
+ */
+static bool do_blend_effect_float_sse(
+    float fac, int x, int y, const float *rect1, const float *rect2, int btype, float *out)
+{
+  const __m128 one = _mm_set1_ps(1.0f);
+  switch (btype) {
+    case SEQ_TYPE_ADD:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 /*t*/) {
+            return _mm_add_ps(a, _mm_mul_ps(b, broadcast_alpha_sse(a)));
+          });
+      return true;
+    case SEQ_TYPE_SUB:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 /*t*/) {
+            return _mm_max_ps(_mm_sub_ps(a, _mm_mul_ps(b, broadcast_alpha_sse(a))),
+                              _mm_setzero_ps());
+          });
+      return true;
+    case SEQ_TYPE_MUL:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 t) {
+            return _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, t), a),
+                              _mm_mul_ps(_mm_mul_ps(a, b), broadcast_alpha_sse(a)));
+          });
+      return true;
+    case SEQ_TYPE_DARKEN:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 t) {
+            const __m128 map_alpha = _mm_div_ps(broadcast_alpha_sse(a), t);
+            return _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, t), a),
+                              _mm_mul_ps(t, _mm_min_ps(a, _mm_mul_ps(b, map_alpha))));
+          });
+      return true;
+    case SEQ_TYPE_LIGHTEN:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 t) {
+            const __m128 map_alpha = _mm_div_ps(broadcast_alpha_sse(a), t);
+            return _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, t), a),
+                              _mm_mul_ps(t, _mm_max_ps(a, _mm_mul_ps(b, map_alpha))));
+          });
+      return true;
+    case SEQ_TYPE_SCREEN:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 t) {
+            const __m128 screen = _mm_max_ps(
+                _mm_sub_ps(one, _mm_mul_ps(_mm_sub_ps(one, a), _mm_sub_ps(one, b))),
+                _mm_setzero_ps());
+            return _mm_add_ps(_mm_mul_ps(screen, t), _mm_mul_ps(a, _mm_sub_ps(one, t)));
+          });
+      return true;
+    case SEQ_TYPE_DIFFERENCE:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 t) {
+            const __m128 sign_mask = _mm_set1_ps(-0.0f);
+            const __m128 difference = _mm_andnot_ps(sign_mask, _mm_sub_ps(a, b));
+            return _mm_add_ps(_mm_mul_ps(difference, t), _mm_mul_ps(a, _mm_sub_ps(one, t)));
+          });
+      return true;
+    case SEQ_TYPE_EXCLUSION:
+      apply_blend_function_sse(
+          fac, x, y, rect1, rect2, out, [&](const __m128 a, const __m128 b, const __m128 t) {
+            const __m128 mid = _mm_set1_ps(0.5f);
+            const __m128 exclusion = _mm_sub_ps(
+                mid,
+                _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.0f), _mm_sub_ps(a, mid)), _mm_sub_ps(b, mid)));
+            return _mm_add_ps(_mm_mul_ps(exclusion, t), _mm_mul_ps(a, _mm_sub_ps(one, t)));
+          });
+      return true;
+    default:
+      return false;
+  }
+}
+
+#endif /* BLI_HAVE_SSE2 */
+
 static void do_blend_effect_float(
-    float fac, int x, int y, const float *rect1, float *rect2, int btype, float *out)
+    float fac, int x, int y, const float *rect1, const float *rect2, int btype, float *out)
 {
+#if BLI_HAVE_SSE2
+  if (do_blend_effect_float_sse(fac, x, y, rect1, rect2, btype, out)) {
+    return;
+  }
+#endif
+
   switch (btype) {
     case SEQ_TYPE_ADD:
       apply_blend_function(fac, x, y, rect1, rect2, out, blend_color_add_float);
@@ -960,7 +1309,7 @@ static void do_blend_effect_float(
 }
 
 static void do_blend_effect_byte(
-    float fac, int x, int y, uchar *rect1, uchar *rect2, int btype, uchar *out)
+    float fac, int x, int y, const uchar *rect1, const uchar *rect2, int btype, uchar *out)
 {
   switch (btype) {
     case SEQ_TYPE_ADD:
@@ -3045,6 +3394,10 @@ static void draw_text_outline(const SeqRenderData *context,
   BLF_buffer(font, nullptr, out->byte_buffer.data, size.x, size.y, display);
 }
 
+/* Fonts and their buffer state are shared by all text strips, while prefetching can render
+ * multiple frames at the same time. */
+static std::mutex text_render_mutex;
+
 static ImBuf *do_text_effect(const SeqRenderData *context,
                              Sequence *seq,
                              float /*timeline_frame*/,
@@ -3053,6 +3406,8 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
                              ImBuf * /* ibuf2*/,
                              ImBuf * /* ibuf3*/)
 {
+  std::lock_guard lock{text_render_mutex};
+
   /* NOTE: text rasterization only fills in part of output image,
    * need to clear it. */
   ImBuf *out = prepare_effect_imbufs(context, nullptr, nullptr, nullptr, false);
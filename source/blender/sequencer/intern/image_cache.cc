@@ -6,6 +6,7 @@
  * \ingroup bke
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <ctime>
 #include <memory.h>
@@ -59,17 +60,30 @@
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * Locking: Lookups only need shared access, so that prefetch threads and the UI can read from
+ * the cache at the same time. Everything that modifies entries or linking needs exclusive access.
+ * Prefetch workers render different frames at the same time, so the last key of the frame being
+ * rendered and temp cache entries are kept separately for each worker.
+ *
+ * Recycling: When choosing between the leftmost and rightmost frame, the distance to the current
+ * frame is weighted by the memory used by the frame and by its cost, which is the time it took
+ * to render relative to the playback frame duration. Frames that are expensive to render again
+ * are kept longer.
  */
 
 #define THUMB_CACHE_LIMIT 5000
 
+/* One chain of linked keys for the main render and for each prefetch worker. */
+#define SEQ_CACHE_LINK_CHAINS_NUM (1 + SEQ_PREFETCH_WORKERS_MAX)
+
 struct SeqCache {
   Main *bmain;
   GHash *hash;
-  ThreadMutex iterator_mutex;
+  ThreadRWMutex iterator_mutex;
   BLI_mempool *keys_pool;
   BLI_mempool *items_pool;
-  SeqCacheKey *last_key;
+  SeqCacheKey *last_key[SEQ_CACHE_LINK_CHAINS_NUM];
   SeqDiskCache *disk_cache;
   int thumbnail_count;
 };
@@ -160,7 +174,17 @@ static void seq_cache_lock(Scene *scene)
   SeqCache *cache = seq_cache_get_from_scene(scene);
 
   if (cache) {
-    BLI_mutex_lock(&cache->iterator_mutex);
+    BLI_rw_mutex_lock(&cache->iterator_mutex, THREAD_LOCK_WRITE);
+  }
+}
+
+/* Lock for lookups only, other threads can read from the cache at the same time. */
+static void seq_cache_lock_shared(Scene *scene)
+{
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+
+  if (cache) {
+    BLI_rw_mutex_lock(&cache->iterator_mutex, THREAD_LOCK_READ);
   }
 }
 
@@ -169,10 +193,25 @@ static void seq_cache_unlock(Scene *scene)
   SeqCache *cache = seq_cache_get_from_scene(scene);
 
   if (cache) {
-    BLI_mutex_unlock(&cache->iterator_mutex);
+    BLI_rw_mutex_unlock(&cache->iterator_mutex);
   }
 }
 
+/* Last key put in the cache by the task and prefetch worker that rendered \a key. */
+static SeqCacheKey *&seq_cache_last_key(SeqCache *cache, const SeqCacheKey *key)
+{
+  if (key->task_id == SEQ_TASK_MAIN_RENDER) {
+    return cache->last_key[0];
+  }
+  BLI_assert(key->worker_index >= 0 && key->worker_index < SEQ_PREFETCH_WORKERS_MAX);
+  return cache->last_key[1 + key->worker_index];
+}
+
+static void seq_cache_last_keys_clear(SeqCache *cache)
+{
+  std::fill_n(cache->last_key, SEQ_CACHE_LINK_CHAINS_NUM, nullptr);
+}
+
 static size_t seq_cache_get_mem_total()
 {
   return size_t(U.memcachelimit) * 1024 * 1024;
@@ -221,10 +260,12 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
 
   const int stored_types_flag = get_stored_types_flag(scene, key);
 
+  SeqCacheKey *&last_key = seq_cache_last_key(cache, key);
+
   /* Item stored for later use. */
   if (stored_types_flag & key->type) {
     key->is_temp_cache = false;
-    key->link_prev = cache->last_key;
+    key->link_prev = last_key;
   }
 
   BLI_assert(!BLI_ghash_haskey(cache->hash, key));
@@ -232,22 +273,22 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   IMB_refImBuf(ibuf);
 
   /* Store pointer to last cached key. */
-  SeqCacheKey *temp_last_key = cache->last_key;
+  SeqCacheKey *temp_last_key = last_key;
 
   if (!key->is_temp_cache || key->type != SEQ_CACHE_STORE_THUMBNAIL) {
-    cache->last_key = key;
+    last_key = key;
   }
 
   /* Set last_key's reference to this key so we can look up chain backwards.
-   * Item is already put in cache, so cache->last_key points to current key.
+   * Item is already put in cache, so last_key points to current key.
    */
   if (!key->is_temp_cache && temp_last_key) {
-    temp_last_key->link_next = cache->last_key;
+    temp_last_key->link_next = last_key;
   }
 
   /* Reset linking. */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
-    cache->last_key = nullptr;
+    last_key = nullptr;
   }
 }
 
@@ -276,6 +317,34 @@ static void seq_cache_key_unlink(SeqCacheKey *key)
   }
 }
 
+/* Memory used by images of the frame, which are freed together when the frame is recycled. */
+static size_t seq_cache_linked_size_in_memory(SeqCache *cache, SeqCacheKey *base)
+{
+  size_t size = 0;
+  for (SeqCacheKey *key = base; key != nullptr; key = key->link_prev) {
+    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(cache->hash, key));
+    if (item == nullptr) {
+      break; /* Key has already been removed from cache. */
+    }
+    if (item->ibuf) {
+      size += IMB_get_size_in_memory(item->ibuf);
+    }
+    if (key->link_prev != nullptr && key->link_prev->link_next != key) {
+      break; /* Key doesn't belong to this chain anymore. */
+    }
+  }
+  return size;
+}
+
+/* Higher score means the frame is a better candidate for recycling. */
+static double seq_cache_recycle_score(SeqCache *cache, SeqCacheKey *key, const int frame_distance)
+{
+  /* Frames that render in real-time are all equally cheap. */
+  const double cost = std::max(key->cost, 1.0f);
+  const double size = double(seq_cache_linked_size_in_memory(cache, key));
+  return frame_distance * size / cost;
+}
+
 /* Choose a key out of 2 candidates(leftmost and rightmost items)
  * to recycle based on currently used strategy */
 static SeqCacheKey *seq_cache_choose_key(Scene *scene, SeqCacheKey *lkey, SeqCacheKey *rkey)
@@ -321,7 +390,11 @@ static SeqCacheKey *seq_cache_choose_key(Scene *scene, SeqCacheKey *lkey, SeqCac
     int l_diff = scene->r.cfra - lkey->timeline_frame;
     int r_diff = rkey->timeline_frame - scene->r.cfra;
 
-    if (l_diff > r_diff) {
+    SeqCache *cache = seq_cache_get_from_scene(scene);
+    const double l_score = seq_cache_recycle_score(cache, lkey, l_diff);
+    const double r_score = seq_cache_recycle_score(cache, rkey, r_diff);
+
+    if (l_score > r_score) {
       finalkey = lkey;
     }
     else {
@@ -362,7 +435,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 
     seq_cache_key_unlink(base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
-    BLI_assert(base != cache->last_key);
+    BLI_assert(base != seq_cache_last_key(cache, base));
     base = prev;
   }
 
@@ -381,7 +454,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 
     seq_cache_key_unlink(base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
-    BLI_assert(base != cache->last_key);
+    BLI_assert(base != seq_cache_last_key(cache, base));
     base = next;
   }
 }
@@ -500,10 +573,10 @@ static void seq_cache_create(Main *bmain, Scene *scene)
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = nullptr;
+    seq_cache_last_keys_clear(cache);
     cache->bmain = bmain;
     cache->thumbnail_count = 0;
-    BLI_mutex_init(&cache->iterator_mutex);
+    BLI_rw_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
 
     if (scene->ed->disk_cache_timestamp == 0) {
@@ -530,6 +603,8 @@ static void seq_cache_populate_key(SeqCacheKey *key,
   key->link_next = nullptr;
   key->is_temp_cache = true;
   key->task_id = context->task_id;
+  key->worker_index = context->worker_index;
+  key->cost = 0.0f;
 }
 
 static SeqCacheKey *seq_cache_allocate_key(SeqCache *cache,
@@ -543,10 +618,28 @@ static SeqCacheKey *seq_cache_allocate_key(SeqCache *cache,
   return key;
 }
 
+static SeqDiskCache *seq_cache_disk_cache_ensure(Scene *scene, const SeqRenderData *context)
+{
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  seq_cache_lock(scene);
+  if (cache->disk_cache == nullptr) {
+    cache->disk_cache = seq_disk_cache_create(context->bmain, scene);
+  }
+  SeqDiskCache *disk_cache = cache->disk_cache;
+  seq_cache_unlock(scene);
+  return disk_cache;
+}
+
 /* ***************************** API ****************************** */
 
-void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
+void seq_cache_free_temp_cache(const SeqRenderData *context, int timeline_frame)
 {
+  Scene *scene = context->scene;
+  if (context->is_prefetch_render) {
+    context = seq_prefetch_get_original_context(context);
+    scene = context->scene;
+  }
+
   SeqCache *cache = seq_cache_get_from_scene(scene);
   if (!cache) {
     return;
@@ -561,7 +654,9 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
     BLI_ghashIterator_step(&gh_iter);
     BLI_assert(key->cache_owner == cache);
 
-    if (key->is_temp_cache && key->task_id == id && key->type != SEQ_CACHE_STORE_THUMBNAIL) {
+    if (key->is_temp_cache && key->task_id == context->task_id &&
+        key->worker_index == context->worker_index && key->type != SEQ_CACHE_STORE_THUMBNAIL)
+    {
       /* Use frame_index here to avoid freeing raw images if they are used for multiple frames. */
       float frame_index = seq_cache_timeline_frame_to_frame_index(
           scene, key->seq, timeline_frame, key->type);
@@ -569,11 +664,12 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
           timeline_frame > SEQ_time_right_handle_frame_get(scene, key->seq) ||
           timeline_frame < SEQ_time_left_handle_frame_get(scene, key->seq))
       {
+        SeqCacheKey *&last_key = seq_cache_last_key(cache, key);
+        if (key == last_key) {
+          last_key = nullptr;
+        }
         seq_cache_key_unlink(key);
         BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
-        if (key == cache->last_key) {
-          cache->last_key = nullptr;
-        }
       }
     }
   }
@@ -590,7 +686,7 @@ void seq_cache_destruct(Scene *scene)
   BLI_ghash_free(cache->hash, seq_cache_keyfree, seq_cache_valfree);
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
-  BLI_mutex_end(&cache->iterator_mutex);
+  BLI_rw_mutex_end(&cache->iterator_mutex);
 
   if (cache->disk_cache != nullptr) {
     seq_disk_cache_free(cache->disk_cache);
@@ -630,7 +726,7 @@ void SEQ_cache_cleanup(Scene *scene)
     /* NOTE: no need to call #seq_cache_key_unlink as all keys are removed. */
     BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
   }
-  cache->last_key = nullptr;
+  seq_cache_last_keys_clear(cache);
   cache->thumbnail_count = 0;
   seq_cache_unlock(scene);
 }
@@ -686,7 +782,7 @@ void seq_cache_cleanup_sequence(Scene *scene,
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
-  cache->last_key = nullptr;
+  seq_cache_last_keys_clear(cache);
   seq_cache_unlock(scene);
 }
 
@@ -725,12 +821,16 @@ void seq_cache_thumbnail_cleanup(Scene *scene, rctf *view_area_safe)
          key->timeline_frame < view_area_safe->xmin || key->seq->machine > view_area_safe->ymax ||
          key->seq->machine < view_area_safe->ymin))
     {
+      /* Only reset the chain the key belongs to, other tasks may be rendering a frame. */
+      SeqCacheKey *&last_key = seq_cache_last_key(cache, key);
+      if (key == last_key) {
+        last_key = nullptr;
+      }
       seq_cache_key_unlink(key);
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
       cache->thumbnail_count--;
     }
   }
-  cache->last_key = nullptr;
 }
 
 ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline_frame, int type)
@@ -756,7 +856,7 @@ ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline
     seq_cache_create(context->bmain, scene);
   }
 
-  seq_cache_lock(scene);
+  seq_cache_lock_shared(scene);
   SeqCache *cache = seq_cache_get_from_scene(scene);
   ImBuf *ibuf = nullptr;
   SeqCacheKey key;
@@ -774,11 +874,8 @@ ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline
 
   /* Try disk cache: */
   if (seq_disk_cache_is_enabled(context->bmain)) {
-    if (cache->disk_cache == nullptr) {
-      cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
-    }
-
-    ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
+    SeqDiskCache *disk_cache = seq_cache_disk_cache_ensure(scene, context);
+    ibuf = seq_disk_cache_read_file(disk_cache, &key);
 
     if (ibuf == nullptr) {
       return nullptr;
@@ -786,16 +883,25 @@ ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline
 
     /* Store read image in RAM. Only recycle item for final type. */
     if (key.type != SEQ_CACHE_STORE_FINAL_OUT || seq_cache_recycle_item(scene)) {
-      SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
-      seq_cache_put_ex(scene, new_key, ibuf);
+      seq_cache_lock(scene);
+      /* Another thread may have read the same image in the meantime. */
+      if (!BLI_ghash_haskey(cache->hash, &key)) {
+        SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
+        seq_cache_put_ex(scene, new_key, ibuf);
+      }
+      seq_cache_unlock(scene);
     }
   }
 
   return ibuf;
 }
 
-bool seq_cache_put_if_possible(
-    const SeqRenderData *context, Sequence *seq, float timeline_frame, int type, ImBuf *ibuf)
+bool seq_cache_put_if_possible(const SeqRenderData *context,
+                               Sequence *seq,
+                               float timeline_frame,
+                               int type,
+                               ImBuf *ibuf,
+                               float render_time)
 {
   Scene *scene = context->scene;
 
@@ -810,12 +916,17 @@ bool seq_cache_put_if_possible(
   }
 
   if (seq_cache_recycle_item(scene)) {
-    seq_cache_put(context, seq, timeline_frame, type, ibuf);
+    seq_cache_put(context, seq, timeline_frame, type, ibuf, render_time);
     return true;
   }
 
-  seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-  scene->ed->cache->last_key = nullptr;
+  seq_cache_lock(scene);
+  SeqCacheKey key;
+  seq_cache_populate_key(&key, context, seq, timeline_frame, type);
+  SeqCacheKey *&last_key = seq_cache_last_key(scene->ed->cache, &key);
+  seq_cache_set_temp_cache_linked(scene, last_key);
+  last_key = nullptr;
+  seq_cache_unlock(scene);
   return false;
 }
 
@@ -853,8 +964,12 @@ void seq_cache_thumbnail_put(const SeqRenderData *context,
   seq_cache_unlock(scene);
 }
 
-void seq_cache_put(
-    const SeqRenderData *context, Sequence *seq, float timeline_frame, int type, ImBuf *i)
+void seq_cache_put(const SeqRenderData *context,
+                   Sequence *seq,
+                   float timeline_frame,
+                   int type,
+                   ImBuf *i,
+                   float render_time)
 {
   if (i == nullptr || context->skip_cache || context->is_proxy_render || !seq) {
     return;
@@ -883,17 +998,15 @@ void seq_cache_put(
   seq_cache_lock(scene);
   SeqCache *cache = seq_cache_get_from_scene(scene);
   SeqCacheKey *key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
+  key->cost = render_time * FPS;
   seq_cache_put_ex(scene, key, i);
   seq_cache_unlock(scene);
 
   if (!key->is_temp_cache) {
     if (seq_disk_cache_is_enabled(context->bmain)) {
-      if (cache->disk_cache == nullptr) {
-        seq_disk_cache_create(context->bmain, context->scene);
-      }
-
-      seq_disk_cache_write_file(cache->disk_cache, key, i);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
+      SeqDiskCache *disk_cache = seq_cache_disk_cache_ensure(scene, context);
+      seq_disk_cache_write_file(disk_cache, key, i);
+      seq_disk_cache_enforce_limits(disk_cache);
     }
   }
 }
@@ -939,11 +1052,12 @@ void SEQ_cache_iterate(
     interrupt = callback_iter(userdata, key->seq, timeline_frame, key->type);
   }
 
-  cache->last_key = nullptr;
   seq_cache_unlock(scene);
 }
 
 bool seq_cache_is_full()
 {
-  return seq_cache_get_mem_total() < MEM_get_memory_in_use();
+  /* Decoded movie frames are not allocated by the guarded allocator, but use the same budget. */
+  return seq_cache_get_mem_total() <
+         MEM_get_memory_in_use() + IMB_anim_decoded_frames_memory_in_use();
 }
@@ -30,25 +30,43 @@ struct SeqCacheKey {
   bool is_temp_cache;   /* this cache entry will be freed before rendering next frame */
   /* ID of task for assigning temp cache entries to particular task(thread, etc.) */
   eSeqTaskId task_id;
+  /* Prefetch worker within the task, see #SeqRenderData::worker_index. */
+  int worker_index;
   int type;
 };
 
 ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline_frame, int type);
-void seq_cache_put(
-    const SeqRenderData *context, Sequence *seq, float timeline_frame, int type, ImBuf *i);
+/**
+ * \param render_time: Time in seconds it took to render the image, images that are expensive to
+ * render again are kept in the cache longer.
+ */
+void seq_cache_put(const SeqRenderData *context,
+                   Sequence *seq,
+                   float timeline_frame,
+                   int type,
+                   ImBuf *i,
+                   float render_time = 0.0f);
 void seq_cache_thumbnail_put(const SeqRenderData *context,
                              Sequence *seq,
                              float timeline_frame,
                              ImBuf *i,
                              const rctf *view_area);
-bool seq_cache_put_if_possible(
-    const SeqRenderData *context, Sequence *seq, float timeline_frame, int type, ImBuf *nval);
+bool seq_cache_put_if_possible(const SeqRenderData *context,
+                               Sequence *seq,
+                               float timeline_frame,
+                               int type,
+                               ImBuf *nval,
+                               float render_time = 0.0f);
 /**
  * Find only "base" keys.
  * Sources(other types) for a frame must be freed all at once.
  */
 bool seq_cache_recycle_item(Scene *scene);
-void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame);
+/**
+ * Free temp cache entries of the task (and prefetch worker) of \a context, that are not used to
+ * render \a timeline_frame.
+ */
+void seq_cache_free_temp_cache(const SeqRenderData *context, int timeline_frame);
 void seq_cache_destruct(Scene *scene);
 void seq_cache_cleanup_all(Main *bmain);
 void seq_cache_cleanup_sequence(Scene *scene,
@@ -12,6 +12,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
 #include "BLI_utildefines.h"
@@ -761,6 +762,16 @@ static void curves_copy_data(SequenceModifierData *target, SequenceModifierData
   BKE_curvemapping_copy_data(&cmd_target->curve_mapping, &cmd->curve_mapping);
 }
 
+struct CurvesThreadData {
+  CurveMapping *curve_mapping;
+  /**
+   * Curve values for fully opaque byte pixels, indexed by the byte value of each channel. With
+   * the standard tone the channels are independent, so only 256 values have to be evaluated.
+   */
+  bool use_opaque_table;
+  float opaque_table[256][3];
+};
+
 static void curves_apply_threaded(int width,
                                   int height,
                                   uchar *rect,
@@ -769,7 +780,8 @@ static void curves_apply_threaded(int width,
                                   const float *mask_rect_float,
                                   void *data_v)
 {
-  CurveMapping *curve_mapping = (CurveMapping *)data_v;
+  const CurvesThreadData *data = (const CurvesThreadData *)data_v;
+  CurveMapping *curve_mapping = data->curve_mapping;
   int x, y;
 
   for (y = 0; y < height; y++) {
@@ -801,7 +813,14 @@ static void curves_apply_threaded(int width,
 
         straight_uchar_to_premul_float(tempc, pixel);
 
-        BKE_curvemapping_evaluate_premulRGBF(curve_mapping, result, tempc);
+        if (data->use_opaque_table && pixel[3] == 255) {
+          result[0] = data->opaque_table[pixel[0]][0];
+          result[1] = data->opaque_table[pixel[1]][1];
+          result[2] = data->opaque_table[pixel[2]][2];
+        }
+        else {
+          BKE_curvemapping_evaluate_premulRGBF(curve_mapping, result, tempc);
+        }
 
         if (mask_rect) {
           float t[3];
@@ -836,7 +855,20 @@ static void curves_apply(SequenceModifierData *smd, ImBuf *ibuf, ImBuf *mask)
   BKE_curvemapping_premultiply(&cmd->curve_mapping, false);
   BKE_curvemapping_set_black_white(&cmd->curve_mapping, black, white);
 
-  modifier_apply_threaded(ibuf, mask, curves_apply_threaded, &cmd->curve_mapping);
+  CurvesThreadData data;
+  data.curve_mapping = &cmd->curve_mapping;
+  data.use_opaque_table = ibuf->byte_buffer.data &&
+                          cmd->curve_mapping.tone == CURVE_TONE_STANDARD;
+  if (data.use_opaque_table) {
+    for (int i = 0; i < 256; i++) {
+      const uchar opaque[4] = {uchar(i), uchar(i), uchar(i), 255};
+      float tempc[4];
+      straight_uchar_to_premul_float(tempc, opaque);
+      BKE_curvemapping_evaluate_premulRGBF(&cmd->curve_mapping, data.opaque_table[i], tempc);
+    }
+  }
+
+  modifier_apply_threaded(ibuf, mask, curves_apply_threaded, &data);
 
   BKE_curvemapping_premultiply(&cmd->curve_mapping, true);
 }
@@ -982,8 +1014,12 @@ static SequenceModifierTypeInfo seqModifier_HueCorrect = {
  * \{ */
 
 struct BrightContrastThreadData {
-  float bright;
-  float contrast;
+  /** The color channels are mapped to `mul * value + add`. */
+  float mul;
+  float add;
+  /** Mapped values for byte images, before and after clamping to bytes. */
+  float byte_values[256];
+  uchar byte_table[256];
 };
 
 static void brightcontrast_apply_threaded(int width,
@@ -994,70 +1030,66 @@ static void brightcontrast_apply_threaded(int width,
                                           const float *mask_rect_float,
                                           void *data_v)
 {
-  BrightContrastThreadData *data = (BrightContrastThreadData *)data_v;
-  int x, y;
-
-  float i;
+  const BrightContrastThreadData *data = (const BrightContrastThreadData *)data_v;
+  const float a = data->mul;
+  const float b = data->add;
+  const int64_t pixels_num = int64_t(width) * height;
   int c;
-  float a, b, v;
-  float brightness = data->bright / 100.0f;
-  float contrast = data->contrast;
-  float delta = contrast / 200.0f;
-  /*
-   * The algorithm is by Werner D. Streidt
-   * (http://visca.com/ffactory/archives/5-99/msg00021.html)
-   * Extracted of OpenCV `demhist.c`.
-   */
-  if (contrast > 0) {
-    a = 1.0f - delta * 2.0f;
-    a = 1.0f / max_ff(a, FLT_EPSILON);
-    b = a * (brightness - delta);
-  }
-  else {
-    delta *= -1;
-    a = max_ff(1.0f - delta * 2.0f, 0.0f);
-    b = a * brightness + delta;
-  }
 
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < width; x++) {
-      int pixel_index = (y * width + x) * 4;
-
-      if (rect) {
-        uchar *pixel = rect + pixel_index;
+  if (rect) {
+    for (int64_t i = 0; i < pixels_num; i++) {
+      uchar *pixel = rect + i * 4;
 
+      if (mask_rect) {
+        const uchar *m = mask_rect + i * 4;
         for (c = 0; c < 3; c++) {
-          i = float(pixel[c]) / 255.0f;
-          v = a * i + b;
-
-          if (mask_rect) {
-            uchar *m = mask_rect + pixel_index;
-            float t = float(m[c]) / 255.0f;
-
-            v = float(pixel[c]) / 255.0f * (1.0f - t) + v * t;
-          }
-
+          const float t = float(m[c]) / 255.0f;
+          const float v = float(pixel[c]) / 255.0f * (1.0f - t) + data->byte_values[pixel[c]] * t;
           pixel[c] = unit_float_to_uchar_clamp(v);
         }
       }
-      else if (rect_float) {
-        float *pixel = rect_float + pixel_index;
-
+      else {
         for (c = 0; c < 3; c++) {
-          i = pixel[c];
-          v = a * i + b;
+          pixel[c] = data->byte_table[pixel[c]];
+        }
+      }
+    }
+  }
+  else if (rect_float) {
+#if BLI_HAVE_SSE2
+    const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    const __m128 a_v = _mm_set1_ps(a);
+    const __m128 b_v = _mm_set1_ps(b);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int64_t i = 0; i < pixels_num; i++) {
+      float *pixel = rect_float + i * 4;
+      const __m128 p = _mm_loadu_ps(pixel);
+      __m128 v = _mm_add_ps(_mm_mul_ps(a_v, p), b_v);
+      if (mask_rect_float) {
+        const __m128 m = _mm_loadu_ps(mask_rect_float + i * 4);
+        v = _mm_add_ps(_mm_mul_ps(p, _mm_sub_ps(one, m)), _mm_mul_ps(v, m));
+      }
+      /* Keep alpha unchanged. */
+      _mm_storeu_ps(pixel, _mm_or_ps(_mm_and_ps(alpha_mask, p), _mm_andnot_ps(alpha_mask, v)));
+    }
+#else
+    for (int64_t i = 0; i < pixels_num; i++) {
+      float *pixel = rect_float + i * 4;
+
+      for (c = 0; c < 3; c++) {
+        const float v = a * pixel[c] + b;
 
-          if (mask_rect_float) {
-            const float *m = mask_rect_float + pixel_index;
+        if (mask_rect_float) {
+          const float *m = mask_rect_float + i * 4;
 
-            pixel[c] = pixel[c] * (1.0f - m[c]) + v * m[c];
-          }
-          else {
-            pixel[c] = v;
-          }
+          pixel[c] = pixel[c] * (1.0f - m[c]) + v * m[c];
+        }
+        else {
+          pixel[c] = v;
         }
       }
     }
+#endif
   }
 }
 
@@ -1066,8 +1098,30 @@ static void brightcontrast_apply(SequenceModifierData *smd, ImBuf *ibuf, ImBuf *
   BrightContrastModifierData *bcmd = (BrightContrastModifierData *)smd;
   BrightContrastThreadData data;
 
-  data.bright = bcmd->bright;
-  data.contrast = bcmd->contrast;
+  float brightness = bcmd->bright / 100.0f;
+  float contrast = bcmd->contrast;
+  float delta = contrast / 200.0f;
+  /*
+   * The algorithm is by Werner D. Streidt
+   * (http://visca.com/ffactory/archives/5-99/msg00021.html)
+   * Extracted of OpenCV `demhist.c`.
+   */
+  if (contrast > 0) {
+    data.mul = 1.0f - delta * 2.0f;
+    data.mul = 1.0f / max_ff(data.mul, FLT_EPSILON);
+    data.add = data.mul * (brightness - delta);
+  }
+  else {
+    delta *= -1;
+    data.mul = max_ff(1.0f - delta * 2.0f, 0.0f);
+    data.add = data.mul * brightness + delta;
+  }
+
+  /* Byte images only have 256 possible values per channel, map them once. */
+  for (int i = 0; i < 256; i++) {
+    data.byte_values[i] = data.mul * (float(i) / 255.0f) + data.add;
+    data.byte_table[i] = unit_float_to_uchar_clamp(data.byte_values[i]);
+  }
 
   modifier_apply_threaded(ibuf, mask, brightcontrast_apply_threaded, &data);
 }
@@ -6,9 +6,11 @@
  * \ingroup bke
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 
 #include "MEM_guardedalloc.h"
 
@@ -16,9 +18,13 @@
 #include "DNA_screen_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_listbase.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
@@ -46,29 +52,39 @@
 #include "prefetch.hh"
 #include "render.hh"
 
+/**
+ * Renders one frame at a time, using its own evaluated copy of the scene. Workers render
+ * consecutive frames concurrently.
+ */
+struct PrefetchWorker {
+  Main *bmain_eval = nullptr;
+  Scene *scene_eval = nullptr;
+  Depsgraph *depsgraph = nullptr;
+  /* Context of the original scene, used for cache entries created by this worker. */
+  SeqRenderData context = {};
+  SeqRenderData context_cpy = {};
+  /* Frame that is being rendered. */
+  float cfra = 0.0f;
+};
+
 struct PrefetchJob {
   PrefetchJob *next, *prev;
 
   Main *bmain;
-  Main *bmain_eval;
   Scene *scene;
-  Scene *scene_eval;
-  Depsgraph *depsgraph;
 
   ThreadMutex prefetch_suspend_mutex;
   ThreadCondition prefetch_suspend_cond;
 
   ListBase threads;
 
-  /* context */
-  SeqRenderData context;
-  SeqRenderData context_cpy;
-  ListBase *seqbasep;
-  ListBase *seqbasep_cpy;
+  blender::Vector<std::unique_ptr<PrefetchWorker>> workers;
 
   /* prefetch area */
   float cfra;
   int num_frames_prefetched;
+  /* Number of frames starting at #seq_prefetch_cfra that are being rendered. */
+  int num_frames_in_flight;
 
   /* control */
   bool running;
@@ -159,7 +175,13 @@ SeqRenderData *seq_prefetch_get_original_context(const SeqRenderData *context)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  return &pfjob->context;
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    if (worker->scene_eval == context->scene) {
+      return &worker->context;
+    }
+  }
+  BLI_assert_unreachable();
+  return &pfjob->workers.first()->context;
 }
 
 static bool seq_prefetch_is_cache_full(Scene *scene)
@@ -177,9 +199,9 @@ static float seq_prefetch_cfra(PrefetchJob *pfjob)
 {
   return pfjob->cfra + pfjob->num_frames_prefetched;
 }
-static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchJob *pfjob)
+static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchWorker &worker)
 {
-  return BKE_animsys_eval_context_construct(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  return BKE_animsys_eval_context_construct(worker.depsgraph, worker.cfra);
 }
 
 void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
@@ -187,40 +209,59 @@ void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
   *r_start = pfjob->cfra;
-  *r_end = seq_prefetch_cfra(pfjob);
+  *r_end = seq_prefetch_cfra(pfjob) + std::max(pfjob->num_frames_in_flight - 1, 0);
+}
+
+/**
+ * Number of frames that are rendered at the same time. Each worker evaluates its own copy of the
+ * scene, which costs memory and time to build, so rendering multiple frames is opt-in.
+ */
+static int seq_prefetch_workers_num()
+{
+  return std::clamp(int(U.sequencer_prefetch_frames), 1, SEQ_PREFETCH_WORKERS_MAX);
 }
 
-static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_free_depsgraph(PrefetchWorker &worker)
 {
-  if (pfjob->depsgraph != nullptr) {
-    DEG_graph_free(pfjob->depsgraph);
+  if (worker.depsgraph != nullptr) {
+    DEG_graph_free(worker.depsgraph);
   }
-  pfjob->depsgraph = nullptr;
-  pfjob->scene_eval = nullptr;
+  worker.depsgraph = nullptr;
+  worker.scene_eval = nullptr;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker &worker)
 {
-  DEG_evaluate_on_framechange(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  DEG_evaluate_on_framechange(worker.depsgraph, worker.cfra);
 }
 
-static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob, PrefetchWorker &worker)
 {
-  Main *bmain = pfjob->bmain_eval;
+  Main *bmain = worker.bmain_eval;
   Scene *scene = pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  worker.depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker.depsgraph, "SEQUENCER PREFETCH");
 
   /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph);
+  DEG_graph_build_for_render_pipeline(worker.depsgraph);
 
   /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+  worker.cfra = seq_prefetch_cfra(pfjob);
+  seq_prefetch_update_depsgraph(worker);
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+  worker.scene_eval = DEG_get_evaluated_scene(worker.depsgraph);
+  worker.scene_eval->ed->cache_flag = 0;
+}
+
+static void seq_prefetch_free_worker(PrefetchWorker &worker)
+{
+  seq_prefetch_free_depsgraph(worker);
+  if (worker.bmain_eval != nullptr) {
+    BKE_main_free(worker.bmain_eval);
+    worker.bmain_eval = nullptr;
+  }
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
@@ -276,32 +317,37 @@ static void seq_prefetch_update_context(const SeqRenderData *context)
   PrefetchJob *pfjob;
   pfjob = seq_prefetch_job_get(context->scene);
 
-  SEQ_render_new_render_data(pfjob->bmain_eval,
-                             pfjob->depsgraph,
-                             pfjob->scene_eval,
-                             context->rectx,
-                             context->recty,
-                             context->preview_render_size,
-                             false,
-                             &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
-
-  SEQ_render_new_render_data(pfjob->bmain,
-                             pfjob->depsgraph,
-                             pfjob->scene,
-                             context->rectx,
-                             context->recty,
-                             context->preview_render_size,
-                             false,
-                             &pfjob->context);
-  pfjob->context.is_prefetch_render = false;
-
-  /* Same ID as prefetch context, because context will be swapped, but we still
-   * want to assign this ID to cache entries created in this thread.
-   * This is to allow "temp cache" work correctly for both threads.
-   */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  for (const int i : pfjob->workers.index_range()) {
+    PrefetchWorker &worker = *pfjob->workers[i];
+    SEQ_render_new_render_data(worker.bmain_eval,
+                               worker.depsgraph,
+                               worker.scene_eval,
+                               context->rectx,
+                               context->recty,
+                               context->preview_render_size,
+                               false,
+                               &worker.context_cpy);
+    worker.context_cpy.is_prefetch_render = true;
+    worker.context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+    worker.context_cpy.worker_index = i;
+
+    SEQ_render_new_render_data(pfjob->bmain,
+                               worker.depsgraph,
+                               pfjob->scene,
+                               context->rectx,
+                               context->recty,
+                               context->preview_render_size,
+                               false,
+                               &worker.context);
+    worker.context.is_prefetch_render = false;
+
+    /* Same ID as prefetch contexts, because context will be swapped, but we still
+     * want to assign this ID to cache entries created in prefetch threads.
+     * This is to allow "temp cache" work correctly for both threads.
+     */
+    worker.context.task_id = SEQ_TASK_PREFETCH_RENDER;
+    worker.context.worker_index = i;
+  }
 }
 
 static void seq_prefetch_update_scene(Scene *scene)
@@ -313,21 +359,38 @@ static void seq_prefetch_update_scene(Scene *scene)
   }
 
   pfjob->scene = scene;
-  seq_prefetch_free_depsgraph(pfjob);
-  seq_prefetch_init_depsgraph(pfjob);
+
+  const int workers_num = seq_prefetch_workers_num();
+  while (pfjob->workers.size() > workers_num) {
+    seq_prefetch_free_worker(*pfjob->workers.last());
+    pfjob->workers.remove_last();
+  }
+  while (pfjob->workers.size() < workers_num) {
+    pfjob->workers.append(std::make_unique<PrefetchWorker>());
+    pfjob->workers.last()->bmain_eval = BKE_main_new();
+  }
+
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    seq_prefetch_free_depsgraph(*worker);
+    seq_prefetch_init_depsgraph(pfjob, *worker);
+  }
 }
 
 static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob)
 {
   MetaStack *ms_orig = SEQ_meta_stack_active_get(SEQ_editing_get(pfjob->scene));
-  Editing *ed_eval = SEQ_editing_get(pfjob->scene_eval);
 
-  if (ms_orig != nullptr) {
-    Sequence *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, pfjob->scene_eval);
-    SEQ_seqbase_active_set(ed_eval, &meta_eval->seqbase);
-  }
-  else {
-    SEQ_seqbase_active_set(ed_eval, &ed_eval->seqbase);
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    Editing *ed_eval = SEQ_editing_get(worker->scene_eval);
+
+    if (ms_orig != nullptr) {
+      Sequence *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq,
+                                                               worker->scene_eval);
+      SEQ_seqbase_active_set(ed_eval, &meta_eval->seqbase);
+    }
+    else {
+      SEQ_seqbase_active_set(ed_eval, &ed_eval->seqbase);
+    }
   }
 }
 
@@ -353,18 +416,19 @@ void seq_prefetch_free(Scene *scene)
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  seq_prefetch_free_depsgraph(pfjob);
-  BKE_main_free(pfjob->bmain_eval);
-  MEM_freeN(pfjob);
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    seq_prefetch_free_worker(*worker);
+  }
+  MEM_delete(pfjob);
   scene->ed->prefetch_job = nullptr;
 }
 
-static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
+static bool seq_prefetch_seq_has_disk_cache(PrefetchWorker &worker,
                                             Sequence *seq,
                                             bool can_have_final_image)
 {
-  SeqRenderData *ctx = &pfjob->context_cpy;
-  float cfra = seq_prefetch_cfra(pfjob);
+  SeqRenderData *ctx = &worker.context_cpy;
+  float cfra = worker.cfra;
 
   ImBuf *ibuf = seq_cache_get(ctx, seq, cfra, SEQ_CACHE_STORE_PREPROCESSED);
   if (ibuf != nullptr) {
@@ -391,27 +455,27 @@ static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
   return false;
 }
 
-static bool seq_prefetch_scene_strip_is_rendered(PrefetchJob *pfjob,
+static bool seq_prefetch_scene_strip_is_rendered(PrefetchWorker &worker,
                                                  ListBase *channels,
                                                  ListBase *seqbase,
                                                  blender::Span<Sequence *> scene_strips,
                                                  bool is_recursive_check)
 {
-  float cfra = seq_prefetch_cfra(pfjob);
+  float cfra = worker.cfra;
   blender::Vector<Sequence *> strips = seq_get_shown_sequences(
-      pfjob->scene_eval, channels, seqbase, cfra, 0);
+      worker.scene_eval, channels, seqbase, cfra, 0);
 
   /* Iterate over rendered strips. */
   for (Sequence *seq : strips) {
     if (seq->type == SEQ_TYPE_META &&
-        seq_prefetch_scene_strip_is_rendered(pfjob, channels, &seq->seqbase, scene_strips, true))
+        seq_prefetch_scene_strip_is_rendered(worker, channels, &seq->seqbase, scene_strips, true))
     {
       return true;
     }
 
     /* Disable prefetching 3D scene strips, but check for disk cache. */
     if (seq->type == SEQ_TYPE_SCENE && (seq->flag & SEQ_SCENE_STRIPS) == 0 &&
-        !seq_prefetch_seq_has_disk_cache(pfjob, seq, !is_recursive_check))
+        !seq_prefetch_seq_has_disk_cache(worker, seq, !is_recursive_check))
     {
       return true;
     }
@@ -439,10 +503,12 @@ static blender::VectorSet<Sequence *> query_scene_strips(ListBase *seqbase)
 
 /* Prefetch must avoid rendering scene strips, because rendering in background locks UI and can
  * make it unresponsive for long time periods. */
-static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob, ListBase *channels, ListBase *seqbase)
+static bool seq_prefetch_must_skip_frame(PrefetchWorker &worker,
+                                         ListBase *channels,
+                                         ListBase *seqbase)
 {
   blender::VectorSet<Sequence *> scene_strips = query_scene_strips(seqbase);
-  if (seq_prefetch_scene_strip_is_rendered(pfjob, channels, seqbase, scene_strips, false)) {
+  if (seq_prefetch_scene_strip_is_rendered(worker, channels, seqbase, scene_strips, false)) {
     return true;
   }
   return false;
@@ -468,30 +534,76 @@ static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 }
 
+/**
+ * Render a single frame into the cache with the worker's copy of the scene.
+ * \return False if the frame has to be skipped.
+ */
+static bool seq_prefetch_render_frame(PrefetchJob *pfjob, PrefetchWorker &worker, float cfra)
+{
+  worker.cfra = cfra;
+  worker.scene_eval->ed->prefetch_job = nullptr;
+
+  seq_prefetch_update_depsgraph(worker);
+  AnimData *adt = BKE_animdata_from_id(&worker.context_cpy.scene->id);
+  AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(worker);
+  BKE_animsys_evaluate_animdata(
+      &worker.context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+
+  /* This is quite hacky solution:
+   * We need cross-reference original scene with copy for cache.
+   * However depsgraph must not have this data, because it will try to kill this job.
+   * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
+   * Set to nullptr before return!
+   */
+  worker.scene_eval->ed->prefetch_job = pfjob;
+
+  ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(worker.scene_eval));
+  ListBase *channels = SEQ_channels_displayed_get(SEQ_editing_get(worker.scene_eval));
+  if (seq_prefetch_must_skip_frame(worker, channels, seqbase)) {
+    return false;
+  }
+
+  ImBuf *ibuf = SEQ_render_give_ibuf(&worker.context_cpy, cfra, 0);
+  IMB_freeImBuf(ibuf);
+  return true;
+}
+
+/**
+ * Render the next frames concurrently, one frame per worker.
+ * \return False if all frames were skipped.
+ */
+static bool seq_prefetch_render_frames(PrefetchJob *pfjob, int frames_num)
+{
+  using namespace blender;
+  const float cfra = seq_prefetch_cfra(pfjob);
+  pfjob->num_frames_in_flight = frames_num;
+
+  Array<bool> rendered(frames_num, false);
+  threading::parallel_for(IndexRange(frames_num), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      rendered[i] = seq_prefetch_render_frame(pfjob, *pfjob->workers[i], cfra + i);
+    }
+  });
+
+  /* Continue from the last frame of the batch. */
+  pfjob->num_frames_prefetched += frames_num - 1;
+  pfjob->num_frames_in_flight = 1;
+  for (const int i : IndexRange(frames_num)) {
+    PrefetchWorker &worker = *pfjob->workers[i];
+    seq_cache_free_temp_cache(&worker.context, worker.cfra);
+  }
+
+  return rendered.as_span().contains(true);
+}
+
 static void *seq_prefetch_frames(void *job)
 {
   PrefetchJob *pfjob = (PrefetchJob *)job;
 
   while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = nullptr;
-
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(pfjob);
-    BKE_animsys_evaluate_animdata(
-        &pfjob->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
-
-    /* This is quite hacky solution:
-     * We need cross-reference original scene with copy for cache.
-     * However depsgraph must not have this data, because it will try to kill this job.
-     * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
-     * Set to nullptr before return!
-     */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
-
-    ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(pfjob->scene_eval));
-    ListBase *channels = SEQ_channels_displayed_get(SEQ_editing_get(pfjob->scene_eval));
-    if (seq_prefetch_must_skip_frame(pfjob, channels, seqbase)) {
+    const int frames_num = std::min(int(pfjob->workers.size()),
+                                    int(pfjob->scene->r.efra - seq_prefetch_cfra(pfjob)) + 1);
+    if (!seq_prefetch_render_frames(pfjob, frames_num)) {
       pfjob->num_frames_prefetched++;
       /* Break instead of keep looping if the job should be terminated. */
       if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
@@ -500,10 +612,6 @@ static void *seq_prefetch_frames(void *job)
       continue;
     }
 
-    ImBuf *ibuf = SEQ_render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-    IMB_freeImBuf(ibuf);
-
     /* Suspend thread if there is nothing to be prefetched. */
     seq_prefetch_do_suspend(pfjob);
 
@@ -521,9 +629,13 @@ static void *seq_prefetch_frames(void *job)
     pfjob->num_frames_prefetched++;
   }
 
-  seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    seq_cache_free_temp_cache(&worker->context, seq_prefetch_cfra(pfjob));
+  }
   pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = nullptr;
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    worker->scene_eval->ed->prefetch_job = nullptr;
+  }
 
   return nullptr;
 }
@@ -534,22 +646,21 @@ static PrefetchJob *seq_prefetch_start_ex(const SeqRenderData *context, float cf
 
   if (!pfjob) {
     if (context->scene->ed) {
-      pfjob = (PrefetchJob *)MEM_callocN(sizeof(PrefetchJob), "PrefetchJob");
+      pfjob = MEM_new<PrefetchJob>("PrefetchJob");
       context->scene->ed->prefetch_job = pfjob;
 
       BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
       BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
       BLI_condition_init(&pfjob->prefetch_suspend_cond);
 
-      pfjob->bmain_eval = BKE_main_new();
       pfjob->scene = context->scene;
-      seq_prefetch_init_depsgraph(pfjob);
     }
   }
   pfjob->bmain = context->bmain;
 
   pfjob->cfra = cfra;
   pfjob->num_frames_prefetched = 1;
+  pfjob->num_frames_in_flight = 1;
 
   pfjob->waiting = false;
   pfjob->stop = false;
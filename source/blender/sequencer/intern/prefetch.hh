@@ -12,6 +12,9 @@ struct Scene;
 struct SeqRenderData;
 struct Sequence;
 
+/** Maximum number of frames that are prefetched at the same time. */
+#define SEQ_PREFETCH_WORKERS_MAX 16
+
 /**
  * Start or resume prefetching.
  */
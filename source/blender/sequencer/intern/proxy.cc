@@ -18,6 +18,8 @@
 #include "BLI_listbase.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #ifdef WIN32
 #  include "BLI_winstuff.h"
@@ -251,53 +253,27 @@ ImBuf *seq_proxy_fetch(const SeqRenderData *context, Sequence *seq, int timeline
   return nullptr;
 }
 
-static void seq_proxy_build_frame(const SeqRenderData *context,
-                                  SeqRenderState *state,
-                                  Sequence *seq,
-                                  int timeline_frame,
+static void seq_proxy_write_frame(Sequence *seq,
+                                  const ImBuf *ibuf_render,
                                   int proxy_render_size,
-                                  const bool overwrite)
+                                  const char *filepath)
 {
-  char filepath[PROXY_MAXFILE];
-  int quality;
-  int rectx, recty;
-  ImBuf *ibuf_tmp, *ibuf;
-  Scene *scene = context->scene;
-
-  if (!seq_proxy_get_filepath(scene,
-                              seq,
-                              timeline_frame,
-                              eSpaceSeq_Proxy_RenderSize(proxy_render_size),
-                              filepath,
-                              context->view_id))
-  {
-    return;
-  }
-
-  if (!overwrite && BLI_exists(filepath)) {
-    return;
-  }
-
-  ibuf_tmp = seq_render_strip(context, state, seq, timeline_frame);
-
-  rectx = (proxy_render_size * ibuf_tmp->x) / 100;
-  recty = (proxy_render_size * ibuf_tmp->y) / 100;
+  ImBuf *ibuf;
+  const int rectx = (proxy_render_size * ibuf_render->x) / 100;
+  const int recty = (proxy_render_size * ibuf_render->y) / 100;
 
-  if (ibuf_tmp->x != rectx || ibuf_tmp->y != recty) {
-    ibuf = IMB_dupImBuf(ibuf_tmp);
-    IMB_metadata_copy(ibuf, ibuf_tmp);
-    IMB_freeImBuf(ibuf_tmp);
-    IMB_scalefastImBuf(ibuf, short(rectx), short(recty));
+  if (ibuf_render->x != rectx || ibuf_render->y != recty) {
+    ibuf = IMB_scale_filtered_into_new(ibuf_render, rectx, recty, IMB_SCALE_FILTER_BOX);
   }
   else {
-    ibuf = ibuf_tmp;
+    ibuf = IMB_dupImBuf(ibuf_render);
   }
+  IMB_metadata_copy(ibuf, ibuf_render);
 
   /* depth = 32 is intentionally left in, otherwise ALPHA channels
    * won't work... */
-  quality = seq->strip->proxy->quality;
   ibuf->ftype = IMB_FTYPE_JPG;
-  ibuf->foptions.quality = quality;
+  ibuf->foptions.quality = seq->strip->proxy->quality;
 
   /* unsupported feature only confuses other s/w */
   if (ibuf->planes == 32) {
@@ -314,6 +290,66 @@ static void seq_proxy_build_frame(const SeqRenderData *context,
   IMB_freeImBuf(ibuf);
 }
 
+static void seq_proxy_build_frame(const SeqRenderData *context,
+                                  SeqRenderState *state,
+                                  Sequence *seq,
+                                  int timeline_frame,
+                                  int size_flags,
+                                  const bool overwrite)
+{
+  using namespace blender;
+  struct ProxyOutput {
+    int render_size;
+    char filepath[PROXY_MAXFILE];
+  };
+  Vector<ProxyOutput, 4> outputs;
+  Scene *scene = context->scene;
+
+  for (const int render_size : {SEQ_RENDER_SIZE_PROXY_25,
+                                 SEQ_RENDER_SIZE_PROXY_50,
+                                 SEQ_RENDER_SIZE_PROXY_75,
+                                 SEQ_RENDER_SIZE_PROXY_100})
+  {
+    if ((size_flags & SEQ_rendersize_to_proxysize(render_size)) == 0) {
+      continue;
+    }
+    ProxyOutput output;
+    output.render_size = render_size;
+    if (!seq_proxy_get_filepath(scene,
+                                seq,
+                                timeline_frame,
+                                eSpaceSeq_Proxy_RenderSize(render_size),
+                                output.filepath,
+                                context->view_id))
+    {
+      continue;
+    }
+    if (!overwrite && BLI_exists(output.filepath)) {
+      continue;
+    }
+    outputs.append(output);
+  }
+
+  if (outputs.is_empty()) {
+    return;
+  }
+
+  /* Render the strip once, all proxy sizes are scaled from the same image and written in
+   * parallel. */
+  ImBuf *ibuf_render = seq_render_strip(context, state, seq, timeline_frame);
+  if (ibuf_render == nullptr) {
+    return;
+  }
+
+  threading::parallel_for(outputs.index_range(), 1, [&](const IndexRange range) {
+    for (const ProxyOutput &output : outputs.as_span().slice(range)) {
+      seq_proxy_write_frame(seq, ibuf_render, output.render_size, output.filepath);
+    }
+  });
+
+  IMB_freeImBuf(ibuf_render);
+}
+
 /**
  * Cache the result of #BKE_scene_multiview_view_prefix_get.
  */
@@ -549,18 +585,8 @@ void SEQ_proxy_rebuild(SeqIndexBuildContext *context, wmJobWorkerStatus *worker_
        timeline_frame < SEQ_time_right_handle_frame_get(scene, seq);
        timeline_frame++)
   {
-    if (context->size_flags & IMB_PROXY_25) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 25, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_50) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 50, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_75) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 75, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_100) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 100, overwrite);
-    }
+    seq_proxy_build_frame(
+        &render_context, &state, seq, timeline_frame, context->size_flags, overwrite);
 
     worker_status->progress = float(timeline_frame - SEQ_time_left_handle_frame_get(scene, seq)) /
                               (SEQ_time_right_handle_frame_get(scene, seq) -
@@ -573,6 +599,11 @@ void SEQ_proxy_rebuild(SeqIndexBuildContext *context, wmJobWorkerStatus *worker_
   }
 }
 
+bool SEQ_proxy_rebuild_is_independent(const SeqIndexBuildContext *context)
+{
+  return context->seq->type == SEQ_TYPE_MOVIE;
+}
+
 void SEQ_proxy_rebuild_finish(SeqIndexBuildContext *context, bool stop)
 {
   if (context->index_context) {
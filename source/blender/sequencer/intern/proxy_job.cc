@@ -8,11 +8,18 @@
  * \ingroup bke
  */
 
+#include <atomic>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_task.h"
+#include "BLI_time.h"
+
 #include "BKE_context.hh"
 
 #include "SEQ_proxy.hh"
@@ -31,21 +38,86 @@ static void proxy_freejob(void *pjv)
   MEM_freeN(pj);
 }
 
+/** Build state of a single strip, as strips are built concurrently. */
+struct ProxyJobTask {
+  SeqIndexBuildContext *context;
+  wmJobWorkerStatus worker_status;
+  std::atomic<bool> finished;
+};
+
+static void proxy_task_run(TaskPool *__restrict pool, void *taskdata)
+{
+  const wmJobWorkerStatus *job_status = static_cast<const wmJobWorkerStatus *>(
+      BLI_task_pool_user_data(pool));
+  ProxyJobTask *task = static_cast<ProxyJobTask *>(taskdata);
+  /* Tasks can start before the job thread forwards cancellation to them. */
+  if (!job_status->stop && !task->worker_status.stop) {
+    SEQ_proxy_rebuild(task->context, &task->worker_status);
+  }
+  task->finished = true;
+}
+
 /* Only this runs inside thread. */
 static void proxy_startjob(void *pjv, wmJobWorkerStatus *worker_status)
 {
+  using namespace blender;
   ProxyJob *pj = static_cast<ProxyJob *>(pjv);
 
+  Array<ProxyJobTask> tasks(BLI_listbase_count(&pj->queue));
+  if (tasks.is_empty()) {
+    return;
+  }
+
+  /* Movie strips only read and write their own files, so they are built concurrently by the
+   * task scheduler. Other strips are rendered by the sequencer to build their proxies, those are
+   * built one at a time on a separate thread, in the order of the queue. */
+  TaskPool *movie_pool = BLI_task_pool_create(worker_status, TASK_PRIORITY_LOW);
+  TaskPool *render_pool = BLI_task_pool_create_background_serial(worker_status,
+                                                                 TASK_PRIORITY_LOW);
+
+  int task_index = 0;
   LISTBASE_FOREACH (LinkData *, link, &pj->queue) {
-    SeqIndexBuildContext *context = static_cast<SeqIndexBuildContext *>(link->data);
+    ProxyJobTask &task = tasks[task_index++];
+    task.context = static_cast<SeqIndexBuildContext *>(link->data);
+    task.worker_status = {};
+    task.finished = false;
+
+    TaskPool *pool = SEQ_proxy_rebuild_is_independent(task.context) ? movie_pool : render_pool;
+    BLI_task_pool_push(pool, proxy_task_run, &task, false, nullptr);
+  }
 
-    SEQ_proxy_rebuild(context, worker_status);
+  /* Forward cancellation to the strips and combine their progress, while the pools are working.
+   * Waiting on the pools would block the progress updates until all strips are built. */
+  while (true) {
+    bool all_finished = true;
+    float progress = 0.0f;
+    for (ProxyJobTask &task : tasks) {
+      task.worker_status.stop = worker_status->stop;
+      if (task.finished) {
+        progress += 1.0f;
+      }
+      else {
+        progress += task.worker_status.progress;
+        all_finished = false;
+      }
+    }
+    worker_status->progress = progress / tasks.size();
+    worker_status->do_update = true;
 
-    if (worker_status->stop) {
-      pj->stop = true;
-      fprintf(stderr, "Canceling proxy rebuild on users request...\n");
+    if (all_finished) {
       break;
     }
+    BLI_time_sleep_ms(50);
+  }
+
+  BLI_task_pool_work_and_wait(movie_pool);
+  BLI_task_pool_work_and_wait(render_pool);
+  BLI_task_pool_free(movie_pool);
+  BLI_task_pool_free(render_pool);
+
+  if (worker_status->stop) {
+    pj->stop = true;
+    fprintf(stderr, "Canceling proxy rebuild on users request...\n");
   }
 }
 
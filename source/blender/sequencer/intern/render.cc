@@ -25,6 +25,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_time.h"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.h"
@@ -83,7 +84,9 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      float timeline_frame,
                                      int chanshown);
 
-static ThreadMutex seq_render_mutex = BLI_MUTEX_INITIALIZER;
+/* Prefetch renders of different frames can run at the same time, but a render from the main
+ * thread is exclusive. */
+static ThreadRWMutex seq_render_mutex = BLI_RWLOCK_INITIALIZER;
 SequencerDrawView sequencer_view3d_fn = nullptr; /* nullptr in background mode */
 
 /* -------------------------------------------------------------------- */
@@ -242,6 +245,7 @@ void SEQ_render_new_render_data(Main *bmain,
   r_context->gpu_offscreen = nullptr;
   r_context->gpu_viewport = nullptr;
   r_context->task_id = SEQ_TASK_MAIN_RENDER;
+  r_context->worker_index = 0;
   r_context->is_prefetch_render = false;
 }
 
@@ -508,30 +512,6 @@ static void sequencer_image_crop_init(const Sequence *seq,
   BLI_rctf_init(r_crop, left, in->x - right, bottom, in->y - top);
 }
 
-static void sequencer_thumbnail_transform(ImBuf *in, ImBuf *out)
-{
-  float image_scale_factor = float(out->x) / in->x;
-  float transform_matrix[4][4];
-
-  /* Set to keep same loc,scale,rot but change scale to thumb size limit. */
-  const float scale_x = 1 * image_scale_factor;
-  const float scale_y = 1 * image_scale_factor;
-  const float image_center_offs_x = (out->x - in->x) / 2;
-  const float image_center_offs_y = (out->y - in->y) / 2;
-  const float pivot[3] = {in->x / 2.0f, in->y / 2.0f, 0.0f};
-
-  float rotation_matrix[3][3];
-  unit_m3(rotation_matrix);
-  loc_rot_size_to_mat4(transform_matrix,
-                       float3{image_center_offs_x, image_center_offs_y, 0.0f},
-                       rotation_matrix,
-                       float3{scale_x, scale_y, 1.0f});
-  transform_pivot_set_m4(transform_matrix, pivot);
-  invert_m4(transform_matrix);
-  IMB_transform(
-      in, out, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_NEAREST, transform_matrix, nullptr);
-}
-
 /* Check whether transform introduces transparent ares in the result (happens when the transformed
  * image does not fully cover the render frame).
  *
@@ -2119,22 +2099,26 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
     out = seq_cache_get(context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT);
   }
 
-  seq_cache_free_temp_cache(context->scene, context->task_id, timeline_frame);
+  seq_cache_free_temp_cache(context, timeline_frame);
   /* Make sure we only keep the `anim` data for strips that are in view. */
   SEQ_relations_free_all_anim_ibufs(context->scene, timeline_frame);
 
   if (!strips.is_empty() && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    BLI_rw_mutex_lock(&seq_render_mutex,
+                      context->is_prefetch_render ? THREAD_LOCK_READ : THREAD_LOCK_WRITE);
+    const double render_start = BLI_time_now_seconds();
     out = seq_render_strip_stack(context, &state, channels, seqbasep, timeline_frame, chanshown);
+    const float render_time = float(BLI_time_now_seconds() - render_start);
 
     if (context->is_prefetch_render) {
-      seq_cache_put(context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
+      seq_cache_put(
+          context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out, render_time);
     }
     else {
       seq_cache_put_if_possible(
-          context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
+          context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out, render_time);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    BLI_rw_mutex_unlock(&seq_render_mutex);
   }
 
   seq_prefetch_start(context, timeline_frame);
@@ -2221,9 +2205,7 @@ static ImBuf *seq_get_uncached_thumbnail(const SeqRenderData *context,
   }
 
   /* Scale ibuf to thumbnail size. */
-  ImBuf *scaled_ibuf = IMB_allocImBuf(
-      rectx, recty, 32, ibuf->float_buffer.data ? IB_rectfloat : IB_rect);
-  sequencer_thumbnail_transform(ibuf, scaled_ibuf);
+  ImBuf *scaled_ibuf = IMB_scale_filtered_into_new(ibuf, rectx, recty, IMB_SCALE_FILTER_BOX);
   seq_imbuf_assign_spaces(context->scene, scaled_ibuf);
   IMB_freeImBuf(ibuf);
 
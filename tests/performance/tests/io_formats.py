@@ -0,0 +1,295 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Import and export throughput of the file formats in `source/blender/io`.
+#
+# Geometry is generated synthetically, so no benchmark files are needed. The number of points of
+# the generated geometry can be changed with the `BLENDER_BENCHMARK_IO_SIZES` environment
+# variable, as a comma separated list of point counts.
+#
+# The reported time is the average of several runs. The reported peak memory is the increase of
+# the peak resident memory during the measured runs, over the memory used before them.
+
+import os
+import api
+
+# File extension and supported geometry types for each format.
+FORMATS = {
+    'obj': ('.obj', {'mesh', 'points', 'curves'}),
+    'ply': ('.ply', {'mesh', 'points'}),
+    'stl': ('.stl', {'mesh'}),
+    'abc': ('.abc', {'mesh', 'points', 'curves'}),
+    'usd': ('.usdc', {'mesh', 'points', 'curves'}),
+}
+
+DEFAULT_SIZES = [100_000, 1_000_000]
+
+
+def _peak_memory():
+    # Peak resident memory of the Blender process in bytes, not available on Windows.
+    try:
+        import resource
+    except ImportError:
+        return None
+    import sys
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return peak if sys.platform == 'darwin' else peak * 1024
+
+
+def _generate_mesh(size, with_faces):
+    import bpy
+    import numpy as np
+
+    mesh = bpy.data.meshes.new("benchmark")
+
+    if not with_faces:
+        # Point cloud, as a mesh with only vertices.
+        rng = np.random.default_rng(0)
+        positions = rng.random((size, 3), dtype=np.float32)
+        mesh.vertices.add(size)
+        mesh.vertices.foreach_set("co", positions.ravel())
+        mesh.update()
+        return mesh
+
+    # Grid with a displacement, so that positions and normals are not all the same.
+    side = max(2, int(size ** 0.5))
+    x, y = np.meshgrid(np.arange(side, dtype=np.float32), np.arange(side, dtype=np.float32))
+    z = np.sin(x * 0.05) * np.cos(y * 0.05)
+    positions = np.stack((x.ravel(), y.ravel(), z.ravel()), axis=-1)
+
+    quad_x, quad_y = np.meshgrid(np.arange(side - 1), np.arange(side - 1))
+    first = (quad_y * side + quad_x).ravel()
+    corner_verts = np.stack((first, first + 1, first + side + 1, first + side), axis=-1)
+    faces_num = len(first)
+
+    mesh.vertices.add(side * side)
+    mesh.vertices.foreach_set("co", positions.ravel())
+    mesh.loops.add(faces_num * 4)
+    mesh.loops.foreach_set("vertex_index", corner_verts.astype(np.int32).ravel())
+    mesh.polygons.add(faces_num)
+    mesh.polygons.foreach_set("loop_start", np.arange(0, faces_num * 4, 4, dtype=np.int32))
+
+    uv_layer = mesh.uv_layers.new(name="UVMap")
+    uvs = positions[corner_verts.ravel(), :2] / side
+    uv_layer.data.foreach_set("uv", uvs.ravel())
+
+    mesh.update()
+    return mesh
+
+
+def _generate_curves(size):
+    import bpy
+    import numpy as np
+
+    curve = bpy.data.curves.new("benchmark", 'CURVE')
+    curve.dimensions = '3D'
+
+    points_per_curve = 64
+    t = np.linspace(0.0, 1.0, points_per_curve, dtype=np.float32)
+    for i in range(max(1, size // points_per_curve)):
+        spline = curve.splines.new('POLY')
+        spline.points.add(points_per_curve - 1)
+        co = np.stack((np.full_like(t, i % 1000), np.full_like(t, i // 1000), t, np.ones_like(t)),
+                      axis=-1)
+        spline.points.foreach_set("co", co.ravel())
+
+    return curve
+
+
+def _generate_scene(geometry, size):
+    import bpy
+
+    bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+    if geometry == 'curves':
+        data = _generate_curves(size)
+    else:
+        data = _generate_mesh(size, geometry == 'mesh')
+
+    ob = bpy.data.objects.new("benchmark", data)
+    bpy.context.scene.collection.objects.link(ob)
+    bpy.context.view_layer.update()
+
+
+def _export(file_format, filepath):
+    import bpy
+
+    if file_format == 'obj':
+        bpy.ops.wm.obj_export(filepath=filepath, export_materials=False)
+    elif file_format == 'ply':
+        bpy.ops.wm.ply_export(filepath=filepath)
+    elif file_format == 'stl':
+        bpy.ops.wm.stl_export(filepath=filepath)
+    elif file_format == 'abc':
+        bpy.ops.wm.alembic_export(filepath=filepath, start=1, end=1)
+    elif file_format == 'usd':
+        bpy.ops.wm.usd_export(filepath=filepath, export_materials=False)
+
+
+def _import(file_format, filepath):
+    import bpy
+
+    if file_format == 'obj':
+        bpy.ops.wm.obj_import(filepath=filepath)
+    elif file_format == 'ply':
+        bpy.ops.wm.ply_import(filepath=filepath)
+    elif file_format == 'stl':
+        bpy.ops.wm.stl_import(filepath=filepath)
+    elif file_format == 'abc':
+        bpy.ops.wm.alembic_import(filepath=filepath)
+    elif file_format == 'usd':
+        bpy.ops.wm.usd_import(filepath=filepath)
+
+
+def _measure(function):
+    # Average time of several runs of the function, which returns the time of a single run.
+    import time
+
+    test_time_start = time.time()
+    measured_times = []
+
+    min_measurements = 3
+    max_measurements = 20
+    timeout = 10
+
+    while True:
+        measured_times.append(function())
+
+        if len(measured_times) >= min_measurements and test_time_start + timeout < time.time():
+            break
+        if len(measured_times) >= max_measurements:
+            break
+
+    return sum(measured_times) / len(measured_times)
+
+
+def _memory_increase(baseline):
+    # Increase of the peak memory over the baseline, so that only the measured operation counts.
+    peak = _peak_memory()
+    if peak is None or baseline is None:
+        return None
+    return peak - baseline
+
+
+def _run_generate(args):
+    import bpy
+
+    _generate_scene(args['geometry'], args['size'])
+    bpy.ops.wm.save_as_mainfile(filepath=args['blendfile'])
+    if args['direction'] == 'import':
+        _export(args['format'], args['filepath'])
+
+    return {'generated': True}
+
+
+def _run_export(args):
+    import time
+
+    # The generated scene is loaded from the blend file given on the command line.
+    filepath = args['filepath']
+    baseline = _peak_memory()
+
+    def export():
+        start_time = time.time()
+        _export(args['format'], filepath)
+        return time.time() - start_time
+
+    elapsed_time = _measure(export)
+
+    return {
+        'time': elapsed_time,
+        'file_size': os.path.getsize(filepath),
+        'peak_memory': _memory_increase(baseline),
+    }
+
+
+def _run_import(args):
+    import bpy
+    import time
+
+    bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+
+    # Read the file once to ensure it's cached by OS.
+    filepath = args['filepath']
+    with open(filepath, 'rb') as f:
+        while f.read(1024 * 1024):
+            pass
+
+    baseline = _peak_memory()
+
+    def import_():
+        bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+        start_time = time.time()
+        _import(args['format'], filepath)
+        return time.time() - start_time
+
+    elapsed_time = _measure(import_)
+
+    return {
+        'time': elapsed_time,
+        'file_size': os.path.getsize(filepath),
+        'peak_memory': _memory_increase(baseline),
+    }
+
+
+class IOTest(api.Test):
+    def __init__(self, file_format, direction, geometry, size):
+        self.file_format = file_format
+        self.direction = direction
+        self.geometry = geometry
+        self.size = size
+
+    def name(self):
+        return f"{self.file_format}_{self.direction}_{self.geometry}_{self.size}"
+
+    def category(self):
+        return "io"
+
+    def run(self, env, device_id):
+        import tempfile
+
+        extension = FORMATS[self.file_format][0]
+        with tempfile.TemporaryDirectory() as tempdir:
+            args = {
+                'format': self.file_format,
+                'direction': self.direction,
+                'geometry': self.geometry,
+                'size': self.size,
+                'filepath': os.path.join(tempdir, "benchmark" + extension),
+                'blendfile': os.path.join(tempdir, "benchmark.blend"),
+            }
+
+            # The geometry is generated in a separate Blender instance, so that neither the time
+            # nor the peak memory of the measured instance include generating it.
+            result, _ = env.run_in_blender(_run_generate, args)
+            if result:
+                if self.direction == 'export':
+                    result, _ = env.run_in_blender(_run_export, args, [args['blendfile']])
+                else:
+                    result, _ = env.run_in_blender(_run_import, args)
+
+        if not result:
+            return result
+
+        file_size = result.pop('file_size')
+        result['throughput'] = file_size / (1024 * 1024) / max(result['time'], 1e-6)
+        if result['peak_memory'] is None:
+            del result['peak_memory']
+        return result
+
+
+def _sizes():
+    sizes = os.environ.get('BLENDER_BENCHMARK_IO_SIZES')
+    if not sizes:
+        return DEFAULT_SIZES
+    return [int(size) for size in sizes.split(',')]
+
+
+def generate(env):
+    tests = []
+    for file_format, (_, geometry_types) in FORMATS.items():
+        for geometry in sorted(geometry_types):
+            for size in _sizes():
+                for direction in ('export', 'import'):
+                    tests.append(IOTest(file_format, direction, geometry, size))
+    return tests